@@ -0,0 +1,173 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <splat/models/data-table.h>
+#include <splat/spatial/kmeans.h>
+#include <splat/spatial/quantize1d.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @file quantize1d_benchmark.cpp
+ * @brief Compares kmeans() and quantize1d() as 256 entry scalar codebook builders
+ *
+ * Usage: quantize1d_benchmark [--rows n] [--iterations n] [--seed n]
+ *
+ * Generates log-normal scale columns and Laplacian SH columns, the two kinds of data writeSog() shares one
+ * codebook across. kmeans() clusters all values of a group as one column with k = 256; quantize1d() gets
+ * the group's columns directly. Both report wall time and the mean squared reconstruction error.
+ */
+
+using namespace splat;
+
+namespace {
+
+struct Group {
+  std::string name;
+  std::vector<std::vector<float>> columns;
+};
+
+struct Result {
+  std::string group;
+  const char* method;
+  double milliseconds;
+  double mse;
+};
+
+Group makeGroup(const std::string& name, size_t numColumns, size_t rows, std::mt19937_64& rng, bool laplacian) {
+  std::lognormal_distribution<float> logNormal(-4.0f, 1.0f);
+  std::exponential_distribution<float> magnitude(1.0f / 0.05f);
+  std::bernoulli_distribution sign(0.5);
+
+  Group group{name, std::vector<std::vector<float>>(numColumns, std::vector<float>(rows))};
+  for (auto& column : group.columns) {
+    for (auto& value : column) {
+      value = laplacian ? (sign(rng) ? magnitude(rng) : -magnitude(rng)) : logNormal(rng);
+    }
+  }
+  return group;
+}
+
+double seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Result runKMeans(const Group& group, size_t iterations, uint64_t seed) {
+  ColumnVector<float> values;
+  for (const auto& column : group.columns) {
+    values.insert(values.end(), column.begin(), column.end());
+  }
+  std::vector<Column> columns;
+  columns.push_back({"value", values});
+  DataTable table(std::move(columns));
+
+  KMeansOptions options;
+  options.device = KMeansDevice::CPU;
+  options.seed = seed;
+
+  const auto start = std::chrono::steady_clock::now();
+  auto [centroids, labels] = kmeans(&table, 256, iterations, options);
+  const double elapsed = seconds(start);
+
+  const auto& codebook = centroids->getColumn(0).asVector<float>();
+  double error = 0.0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    const double diff = values[i] - codebook[labels[i]];
+    error += diff * diff;
+  }
+  return {group.name, "kmeans", elapsed * 1e3, error / values.size()};
+}
+
+Result runQuantize1d(const Group& group, size_t iterations) {
+  std::vector<Column> columns;
+  for (size_t c = 0; c < group.columns.size(); ++c) {
+    columns.push_back({"c" + std::to_string(c), ColumnVector<float>(group.columns[c].begin(), group.columns[c].end())});
+  }
+  DataTable table(std::move(columns));
+
+  const auto start = std::chrono::steady_clock::now();
+  auto [codebook, labels] = quantize1d(&table, 256, iterations);
+  const double elapsed = seconds(start);
+
+  double error = 0.0;
+  size_t count = 0;
+  for (size_t c = 0; c < group.columns.size(); ++c) {
+    const auto& column = group.columns[c];
+    const auto& indices = labels->getColumn(c).asVector<uint8_t>();
+    for (size_t i = 0; i < column.size(); ++i) {
+      const double diff = column[i] - codebook[indices[i]];
+      error += diff * diff;
+    }
+    count += column.size();
+  }
+  return {group.name, "quantize1d", elapsed * 1e3, error / count};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t rows = 100000;
+  size_t iterations = 10;
+  uint64_t seed = 0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--rows" && i + 1 < argc) {
+      rows = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+    } else if (arg == "--iterations" && i + 1 < argc) {
+      iterations = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+    } else if (arg == "--seed" && i + 1 < argc) {
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    } else {
+      std::fprintf(stderr, "usage: %s [--rows n] [--iterations n] [--seed n]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  std::mt19937_64 rng(seed);
+  const std::vector<Group> groups = {makeGroup("scales", 3, rows, rng, false), makeGroup("sh", 45, rows, rng, true)};
+
+  // the library logs its own progress to stdout, so the table is printed once every run has finished
+  std::vector<Result> results;
+  for (const auto& group : groups) {
+    results.push_back(runKMeans(group, iterations, seed));
+    results.push_back(runQuantize1d(group, iterations));
+  }
+
+  std::printf("\n%zu rows, k = 256, %zu iterations\n\n", rows, iterations);
+  std::printf("%-8s %-12s %12s %14s\n", "group", "method", "ms", "MSE");
+  for (const auto& result : results) {
+    std::printf("%-8s %-12s %12.1f %14.6g\n", result.group.c_str(), result.method, result.milliseconds, result.mse);
+  }
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <absl/strings/match.h>
+#include <splat/utils/webp-codec.h>
+#include <splat/utils/zip-reader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @file webp_preset_benchmark.cpp
+ * @brief Re-encodes the textures of SOG files with every WebP preset and reports throughput and size
+ *
+ * Usage: webp_preset_benchmark [--repeat n] <file.sog | texture.webp>...
+ *
+ * Bundled SOG files contribute every .webp entry; unbundled SOG textures can be passed directly. Each
+ * texture is decoded once, then encoded on one thread with fast, balanced and max. MB/s counts RGBA input
+ * bytes per second of encode time.
+ */
+
+using namespace splat;
+
+namespace {
+
+struct Texture {
+  std::string name;
+  std::vector<uint8_t> rgba;
+  int width;
+  int height;
+};
+
+void addTexture(std::vector<Texture>& textures, std::string name, const std::vector<uint8_t>& webp) {
+  auto [rgba, width, height] = webpcodec::decodeRGBA(webp);
+  textures.push_back({std::move(name), std::move(rgba), width, height});
+}
+
+std::vector<Texture> loadTextures(const std::string& path) {
+  std::vector<Texture> textures;
+  if (absl::EndsWithIgnoreCase(path, ".webp")) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error("cannot open " + path);
+    }
+    addTexture(textures, path, std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {}));
+    return textures;
+  }
+
+  ZipReader zip(path);
+  for (auto& entry : zip.list()) {
+    if (absl::EndsWithIgnoreCase(entry.name, ".webp")) {
+      addTexture(textures, path + ":" + entry.name, entry.readData());
+    }
+  }
+  return textures;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int repeat = 1;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, std::atoi(argv[++i]));
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+  if (inputs.empty()) {
+    std::fprintf(stderr, "usage: %s [--repeat n] <file.sog | texture.webp>...\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<Texture> textures;
+  try {
+    for (const auto& input : inputs) {
+      auto loaded = loadTextures(input);
+      std::move(loaded.begin(), loaded.end(), std::back_inserter(textures));
+    }
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  if (textures.empty()) {
+    std::fprintf(stderr, "no WebP textures found\n");
+    return 1;
+  }
+
+  size_t inputBytes = 0;
+  for (const auto& texture : textures) {
+    inputBytes += texture.rgba.size();
+  }
+  std::printf("%zu textures, %.2f MB RGBA, %d repeat(s)\n\n", textures.size(), inputBytes / 1e6, repeat);
+  std::printf("%-10s %12s %14s %10s\n", "preset", "MB/s", "bytes", "ratio");
+
+  for (const auto preset : {webpcodec::Preset::Fast, webpcodec::Preset::Balanced, webpcodec::Preset::Max}) {
+    size_t outputBytes = 0;
+    double seconds = 0.0;
+    for (int r = 0; r < repeat; ++r) {
+      outputBytes = 0;
+      for (const auto& texture : textures) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto webp = webpcodec::encodeLosslessRGBA(texture.rgba, texture.width, texture.height, 0, preset);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        seconds += elapsed.count();
+        outputBytes += webp.size();
+      }
+    }
+
+    const double mbPerSecond = seconds > 0.0 ? inputBytes * static_cast<double>(repeat) / 1e6 / seconds : 0.0;
+    std::printf("%-10s %12.2f %14zu %9.2f%%\n", webpcodec::presetName(preset), mbPerSecond, outputBytes,
+                100.0 * outputBytes / inputBytes);
+  }
+
+  return 0;
+}
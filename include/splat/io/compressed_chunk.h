@@ -27,20 +27,30 @@
 
 #pragma once
 
+#include <splat/models/gaussian.h>
+
+#include <array>
 #include <cstdint>
-#include <map>
-#include <string>
 #include <vector>
 
 namespace splat {
 
 class CompressedChunk {
-  std::map<std::string, std::vector<float>> data;
+  // one staging column per packed attribute: x y z, scale_0..2, f_dc_0..2, opacity, rot_0..3
+  std::array<std::vector<float>, 14> data;
   size_t size;
 
  public:
   CompressedChunk(size_t size = 256);
-  void set(size_t index, const std::map<std::string, float>& dataMap);
+  void set(size_t index, const ConstGaussianRef& gaussian);
+
+  /**
+   * @brief Stage the splats view[rows[0]] .. view[rows[count - 1]] one attribute column at a time
+   *
+   * Slots past count repeat the last staged splat so a partial final chunk packs like a full one.
+   */
+  void gather(const ConstGaussianView& view, const uint32_t* rows, size_t count);
+
   void pack();
 
   // compressed data
@@ -31,6 +31,19 @@
 
 namespace splat {
 
+/**
+ * @brief Writes a Gaussian splat table as a compressed PLY file.
+ *
+ * Splats are sorted in Morton order and packed in chunks of 256 against per-chunk bounds: 11-10-11
+ * bit positions and log scales, 2-10-10-10 rotations, 8-8-8-8 colour and opacity, and 8 bit higher
+ * order SH coefficients for every complete band. Chunks are packed in parallel. The file reads back
+ * with readPly(), which detects the layout and calls decompressPly().
+ *
+ * @param[in] filename Path of the file to create or overwrite.
+ * @param[in] dataTable Splats with at least x, y and z columns.
+ *
+ * @throws std::runtime_error If the table lacks a position or the file cannot be written.
+ */
 void writeCompressedPly(const std::string& filename, DataTable* dataTable);
 
 }  // namespace splat
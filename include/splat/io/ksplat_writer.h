@@ -0,0 +1,64 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#pragma once
+
+#include <splat/models/data-table.h>
+
+#include <cstdint>
+#include <string>
+
+namespace splat {
+
+/**
+ * @brief Layout options for writeKsplat()
+ */
+struct KsplatWriteOptions {
+  uint16_t compressionMode = 1;  ///< 0 full precision, 1 half precision, 2 half precision with byte SH
+  float blockSize = 5.0f;        ///< Edge of the cubic cells that buckets are cut from, in world units
+  uint32_t bucketSize = 256;     ///< Maximum splats per bucket
+  uint32_t sectionSize = 65536;  ///< Target splats per section; sections end on cell boundaries
+};
+
+/**
+ * @brief Writes a Gaussian splat table as a KSPLAT file.
+ *
+ * Splats are sorted in Morton order and grouped by the blockSize grid cell they fall in. Each cell is
+ * cut into buckets of bucketSize splats sharing the cell centre, which compressed modes quantise
+ * positions against, and runs of cells form the file's sections. Sections are encoded and written
+ * concurrently. The file reads back with readKsplat().
+ *
+ * @param[in] filename Path of the file to create or overwrite.
+ * @param[in] dataTable Splats with position, rotation, scale, colour and opacity columns.
+ * @param[in] options Compression mode and partitioning.
+ *
+ * @throws std::invalid_argument If an option is out of range.
+ * @throws std::runtime_error If the table lacks a required column or the file cannot be written.
+ */
+void writeKsplat(const std::string& filename, const DataTable* dataTable, const KsplatWriteOptions& options = {});
+
+}  // namespace splat
@@ -28,10 +28,14 @@
 #pragma once
 
 #include <splat/models/data-table.h>
+#include <splat/spatial/kmeans.h>
+#include <splat/utils/webp-codec.h>
 
 namespace splat {
 
 void writeLod(const std::string& filename, const DataTable* dataTable, DataTable* envDataTable, bool bundle,
-              int iterations, size_t lodChunkCount, size_t lodChunkExtent);
+              int iterations, size_t lodChunkCount, size_t lodChunkExtent,
+              const KMeansOptions& kmeansOptions = {},
+              webpcodec::Preset webpPreset = webpcodec::Preset::Balanced);
 
 }  // namespace splat
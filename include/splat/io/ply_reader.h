@@ -27,21 +27,41 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace splat {
 
 class DataTable;
+struct PlyHeader;
+
+/**
+ * @brief Restricts what readPly() loads of the vertex element
+ *
+ * Unwanted properties and rows of plain PLY files are stepped over in the file, so neither their
+ * bytes nor their columns are touched. Compressed PLY files are decoded first and then restricted.
+ */
+struct PlyReadOptions {
+  std::vector<std::string> properties;                 ///< Vertex properties to load, in output order; empty loads all
+  size_t rowBegin = 0;                                 ///< First vertex row to load
+  size_t rowEnd = std::numeric_limits<size_t>::max();  ///< One past the last vertex row; clamped to the vertex count
+};
 
 /**
  * @brief Reads and parses a PLY (Polygon File Format) file from disk.
  *
  * This function loads a PLY file, parses its header and data sections, and returns
  * a DataTable containing the vertex data. The function supports both ASCII and binary
- * PLY formats and handles data in chunks for memory efficiency.
+ * PLY formats. Regular files are memory mapped and transposed from rows into columns
+ * directly out of the mapping (in parallel for large files); anything that cannot be
+ * mapped is streamed instead.
  *
  * @param[in] filename Path to the PLY file to be read.
+ * @param[in] options Properties and row range of the vertex element to load; all of it by default.
  *
  * @return std::unique_ptr<DataTable> A smart pointer to a DataTable containing
  *         the vertex data from the PLY file. If the file contains compressed data,
@@ -52,11 +72,11 @@ class DataTable;
  *         - The file header is invalid or missing the PLY magic bytes
  *         - The header exceeds the maximum size (128KB)
  *         - The 'end_header' marker is not found
- *         - Data chunks cannot be read properly
+ *         - Data chunks cannot be read properly (truncated file)
  *         - The file does not contain a vertex element
+ *         - A requested property does not exist
  *
- * @note The function reads data in chunks of 1024 rows at a time to optimize memory usage.
- *       Non-vertex elements are stored in the PlyData structure but only vertex data is returned.
+ * @note Non-vertex elements are stored in the PlyData structure but only vertex data is returned.
  *       If the PLY data is compressed, it will be decompressed before returning.
  *
  * @par File Format Support:
@@ -68,6 +88,51 @@ class DataTable;
  * @see isCompressedPly() For compression detection
  * @see decompressPly() For decompression logic
  */
-std::unique_ptr<DataTable> readPly(const std::string& filename);
+std::unique_ptr<DataTable> readPly(const std::string& filename, const PlyReadOptions& options = {});
+
+/**
+ * @brief Receives one batch of vertex rows from readPlyBatches()
+ *
+ * The batch table and its column buffers are reused for the next batch, so they are only valid during
+ * the call. Values may be modified in place, but columns must not be added, removed or resized.
+ *
+ * @param batch Up to batchRows consecutive vertex rows
+ * @param firstRow Index of the batch's first row in the file's vertex element
+ * @return true to continue reading, false to stop
+ */
+using PlyBatchCallback = std::function<bool(DataTable& batch, size_t firstRow)>;
+
+/**
+ * @brief Reads the vertex rows of a PLY file in fixed-size batches.
+ *
+ * Rows are read sequentially through a stream and transposed into one reusable batch table, so memory
+ * stays bounded by the batch size regardless of the file size. Property and row selection follow
+ * readPly(). Compressed PLY files cannot be decoded incrementally; they are read whole and sliced.
+ *
+ * @param[in] filename Path to the PLY file to be read.
+ * @param[in] batchRows Rows per batch; the last batch may be shorter.
+ * @param[in] callback Called once per batch in file order.
+ * @param[in] options Properties and row range of the vertex element to read.
+ *
+ * @throws std::invalid_argument If batchRows is 0.
+ * @throws std::runtime_error For the same reasons as readPly().
+ */
+void readPlyBatches(const std::string& filename, size_t batchRows, const PlyBatchCallback& callback,
+                    const PlyReadOptions& options = {});
+
+/**
+ * @brief Reads only the header of a PLY file.
+ *
+ * Returns the comments, the elements with their row counts and the property names and types in file
+ * order, without touching the data section. The header is read a few KB at a time, so probing costs
+ * one open and typically one read per file.
+ *
+ * @param[in] filename Path to the PLY file to probe.
+ * @return PlyHeader The parsed header; dataOffset is the byte offset of the first element's data.
+ *
+ * @throws std::runtime_error If the file cannot be opened or its header is invalid, for the same
+ *         reasons as readPly().
+ */
+PlyHeader probePly(const std::string& filename);
 
 }  // namespace splat
@@ -33,6 +33,25 @@
 
 namespace splat {
 
-void writePly(const std::string& filename, const PlyData& plyData);
+/**
+ * @brief Tuning knobs for writePly()
+ */
+struct PlyWriteOptions {
+  bool directIO = false;  ///< Bypass the page cache where the file system allows it (O_DIRECT)
+};
+
+/**
+ * @brief Writes PlyData as a binary little-endian PLY file.
+ *
+ * Rows are interleaved into large staging buffers, in parallel for big tables, while a dedicated I/O
+ * thread writes the previous buffer, so converting and writing overlap.
+ *
+ * @param[in] filename Path of the file to create or overwrite.
+ * @param[in] plyData Comments and elements to write; every element is written with all its columns.
+ * @param[in] options Write tuning.
+ *
+ * @throws std::runtime_error If the file cannot be created or written.
+ */
+void writePly(const std::string& filename, const PlyData& plyData, const PlyWriteOptions& options = {});
 
 }  // namespace splat
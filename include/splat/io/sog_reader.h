@@ -29,8 +29,32 @@
 
 #include <splat/models/data-table.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace splat {
 
+/**
+ * @brief Attribute groups of a SOG file; each group is stored in textures of its own
+ */
+enum class SogAttribute : uint8_t {
+  Means,   ///< x, y, z (means_l.webp, means_u.webp)
+  Quats,   ///< rot_0..rot_3 (quats.webp)
+  Scales,  ///< scale_0..scale_2 (scales.webp)
+  Color,   ///< f_dc_0..f_dc_2 and opacity (sh0.webp)
+  ShN,     ///< f_rest_* (shN_centroids.webp, shN_labels.webp), when the file has higher SH bands
+};
+
+/**
+ * @brief Restricts what readSog() decodes
+ *
+ * Textures of groups that are not requested are neither decoded nor read: bundles are listed through
+ * their central directory and mapped, so their bytes are never touched.
+ */
+struct SogReadOptions {
+  std::vector<SogAttribute> attributes;  ///< Attribute groups to decode; empty decodes all
+};
+
 /**
  * @brief Reads and parses a Gaussian Splatting (.sog) file into a DataTable
  *
@@ -47,7 +71,9 @@ namespace splat {
  * @param sourceName Source name/path used to locate component files. If sourceName
  *                   ends with ".sog", the function treats it as a ZIP archive.
  *                   Otherwise, it treats sourceName as a directory containing
- *                   individual component files.
+ *                   individual component files, or as the meta.json inside one.
+ * @param options Attribute groups to decode; all of them by default. The table only holds the
+ *                columns of the decoded groups, in the order listed below.
  *
  * @return std::unique_ptr<DataTable> containing the decoded Gaussian splatting data.
  *         The DataTable contains the following columns (at minimum):
@@ -64,8 +90,10 @@ namespace splat {
  *         - Required metadata (meta.json) is missing or invalid
  *         - Texture dimensions are insufficient for the declared splat count
  *         - File format inconsistencies are detected
+ *         - options.attributes only names groups the file does not have
  *
- * @note The function performs parallel processing using OpenMP for performance
+ * @note Bundles and component files are memory mapped and textures are decoded straight from the
+ *       mapping, all concurrently; each attribute group is converted as soon as its textures are ready
  * @note Position coordinates are transformed using invLogTransform to restore
  *       the original coordinate space
  * @note Scale factors are decoded from a codebook-based quantization
@@ -76,11 +104,11 @@ namespace splat {
  *       in the metadata
  *
  * @see Meta::parseFromJson
- * @see decodeMeans
  * @see unpackQuat
  * @see invLogTransform
  * @see sigmoidInv
  */
-std::unique_ptr<DataTable> readSog(const std::string& file, const std::string& sourceName);
+std::unique_ptr<DataTable> readSog(const std::string& file, const std::string& sourceName,
+                                   const SogReadOptions& options = {});
 
 }  // namespace splat
@@ -27,11 +27,30 @@
 
 #pragma once
 
+#include <splat/models/data-table-view.h>
 #include <splat/models/data-table.h>
+#include <splat/spatial/kmeans.h>
+#include <splat/utils/webp-codec.h>
+
+class ThreadPool;
 
 namespace splat {
 
+/**
+ * @brief Write a table as SOG, Morton-sorting the selected rows (all rows when indices is empty)
+ * @param[in] webpPreset Effort of the lossless texture encoder; Fast suits iteration builds
+ * @param[in] pool Workers for the attribute stages, clustering and encodes; a private pool is created when
+ * null. Must not be called from a task running on the same pool.
+ */
 void writeSog(const std::string& filename, DataTable* dataTable, bool bundle, int iterations,
-              const std::vector<uint32_t>& indices = {});
+              const std::vector<uint32_t>& indices = {}, const KMeansOptions& kmeansOptions = {},
+              webpcodec::Preset webpPreset = webpcodec::Preset::Balanced, ThreadPool* pool = nullptr);
+
+/**
+ * @brief Write the rows of a view, in view order (no Morton sort is applied)
+ */
+void writeSog(const std::string& filename, const DataTableView& view, bool bundle, int iterations,
+              const KMeansOptions& kmeansOptions = {}, webpcodec::Preset webpPreset = webpcodec::Preset::Balanced,
+              ThreadPool* pool = nullptr);
 
 }  // namespace splat
@@ -31,6 +31,17 @@
 
 namespace splat {
 
+/**
+ * @brief Reads a SPZ file (version 2 or 3), gzip compressed or not.
+ *
+ * Compressed files are inflated slab by slab into a small staging buffer while the previous slab is
+ * decoded into the columns, in parallel and with AVX2 where available.
+ *
+ * @param[in] filename Path of the file to read.
+ * @return Table with position, scale, colour, opacity, rotation and f_rest columns.
+ *
+ * @throws std::runtime_error If the file cannot be read, is truncated, or is not a supported SPZ file.
+ */
 std::unique_ptr<DataTable> readSpz(const std::string& filename);
 
 }  // namespace splat
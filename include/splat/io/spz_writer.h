@@ -0,0 +1,63 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#pragma once
+
+#include <splat/models/data-table.h>
+
+#include <cstdint>
+#include <string>
+
+namespace splat {
+
+/**
+ * @brief Encoding options for writeSpz()
+ */
+struct SpzWriteOptions {
+  uint32_t version = 3;         ///< 2 (xyz rotation bytes) or 3 (smallest-three rotation words)
+  uint8_t fractionalBits = 12;  ///< Fractional bits of the 24-bit fixed-point positions
+  int compressionLevel = 6;     ///< zlib level, 0 (store) to 9 (smallest)
+};
+
+/**
+ * @brief Writes a Gaussian splat table as a gzip compressed SPZ file.
+ *
+ * Positions are stored as 24-bit fixed point, opacity, colour and log scale as bytes, rotations as
+ * three xyz bytes (version 2) or a smallest-three 32-bit word (version 3), and higher order SH for
+ * every complete band as bytes. The field planes are encoded slab by slab in parallel and streamed
+ * through zlib on a separate thread, so the uncompressed file is never held in memory.
+ *
+ * @param[in] filename Path of the file to create or overwrite.
+ * @param[in] dataTable Splats with position, rotation, scale, colour and opacity columns.
+ * @param[in] options Format version and compression settings.
+ *
+ * @throws std::invalid_argument If the version or fractional bits are unsupported.
+ * @throws std::runtime_error If the table lacks a required column or the file cannot be written.
+ */
+void writeSpz(const std::string& filename, const DataTable* dataTable, const SpzWriteOptions& options = {});
+
+}  // namespace splat
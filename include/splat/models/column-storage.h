@@ -0,0 +1,176 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @file column-storage.h
+ * @brief Aligned, optionally arena-backed storage for DataTable columns
+ */
+
+namespace splat {
+
+/**
+ * @brief Alignment of every column buffer, in bytes (one cache line, one AVX-512 register)
+ */
+inline constexpr size_t kColumnAlignment = 64;
+
+/**
+ * @brief One aligned slab that many column buffers are carved out of
+ *
+ * Allocation is a lock-free pointer bump; individual buffers are never freed back to the arena. The
+ * slab is released when the last allocator referring to it goes away, i.e. when every column carved
+ * out of it has been destroyed. The slab is not zero-filled.
+ */
+class ColumnArena {
+ public:
+  /**
+   * @brief Reserve a slab of at least capacity bytes
+   */
+  explicit ColumnArena(size_t capacity);
+  ~ColumnArena();
+
+  ColumnArena(const ColumnArena&) = delete;
+  ColumnArena& operator=(const ColumnArena&) = delete;
+
+  /**
+   * @brief Carve an aligned block out of the slab; thread-safe
+   * @return Block pointer, or nullptr if the slab cannot fit it
+   */
+  void* allocate(size_t bytes) noexcept;
+
+  /**
+   * @brief Whether p points into this slab
+   */
+  bool owns(const void* p) const noexcept {
+    const auto* b = static_cast<const std::byte*>(p);
+    return b >= base_ && b < base_ + capacity_;
+  }
+
+  size_t capacity() const noexcept { return capacity_; }
+  size_t used() const noexcept { return used_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Slab bytes taken by a block of the given size
+   */
+  static constexpr size_t footprint(size_t bytes) noexcept {
+    return (bytes + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+  }
+
+ private:
+  std::byte* base_ = nullptr;
+  size_t capacity_ = 0;
+  std::atomic<size_t> used_{0};
+};
+
+/**
+ * @brief Allocator behind every column vector
+ *
+ * Buffers are aligned to kColumnAlignment. Elements constructed without a value are
+ * default-initialised, so ColumnVector<float>(n) and resize(n) leave the data uninitialised instead
+ * of zero-filling it; pass an explicit value (ColumnVector<float>(n, 0.0f)) when zeros are needed.
+ *
+ * A default-constructed allocator uses the heap. One bound to a ColumnArena carves its buffers out
+ * of the arena and falls back to the heap once the arena is full. Copies of a column always go back
+ * to the heap so they do not keep the source arena alive.
+ */
+template <typename T>
+class ColumnAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  ColumnAllocator() noexcept = default;
+  explicit ColumnAllocator(std::shared_ptr<ColumnArena> arena) noexcept : arena_(std::move(arena)) {}
+
+  template <typename U>
+  ColumnAllocator(const ColumnAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    const size_t bytes = n * sizeof(T);
+    if (arena_) {
+      if (void* p = arena_->allocate(bytes)) {
+        return static_cast<T*>(p);
+      }
+    }
+    return static_cast<T*>(::operator new(ColumnArena::footprint(bytes), std::align_val_t(kColumnAlignment)));
+  }
+
+  void deallocate(T* p, size_t) noexcept {
+    if (arena_ && arena_->owns(p)) {
+      return;
+    }
+    ::operator delete(p, std::align_val_t(kColumnAlignment));
+  }
+
+  template <typename U>
+  void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void*>(p)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* p, Args&&... args) {
+    ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+
+  ColumnAllocator select_on_container_copy_construction() const noexcept { return ColumnAllocator(); }
+
+  const std::shared_ptr<ColumnArena>& arena() const noexcept { return arena_; }
+
+  template <typename U>
+  bool operator==(const ColumnAllocator<U>& other) const noexcept {
+    return arena_ == other.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ColumnAllocator<U>& other) const noexcept {
+    return arena_ != other.arena();
+  }
+
+ private:
+  std::shared_ptr<ColumnArena> arena_;
+};
+
+/**
+ * @brief Storage type of a column holding elements of type T
+ */
+template <typename T>
+using ColumnVector = std::vector<T, ColumnAllocator<T>>;
+
+}  // namespace splat
@@ -0,0 +1,185 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#pragma once
+
+#include <absl/types/span.h>
+#include <splat/models/data-table.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @file data-table-view.h
+ * @brief Lazy row selection / permutation over a shared DataTable
+ */
+
+namespace splat {
+
+/**
+ * @brief A row subset or permutation of a DataTable that copies no column data
+ *
+ * The view keeps a shared reference to its base table plus the list of base rows it covers, in
+ * view order. Column data is only copied when asked for: through gather() for a single column or
+ * materialize() for a new table. Views are cheap to copy (the index list is shared as well), so
+ * handing the same base to many workers costs one index vector per worker instead of one table.
+ *
+ * When the selected rows form an ascending consecutive run (including the whole table) the view
+ * is contiguous and span() exposes base column data directly.
+ */
+class DataTableView {
+ public:
+  /**
+   * @brief View all rows of a shared table in base order
+   */
+  explicit DataTableView(std::shared_ptr<const DataTable> base);
+
+  /**
+   * @brief View the given rows of a shared table
+   * @param base Base table
+   * @param indices Base row of each view row
+   * @throws std::out_of_range if an index is not a row of base
+   */
+  DataTableView(std::shared_ptr<const DataTable> base, std::vector<uint32_t> indices);
+
+  /**
+   * @brief View all rows of a borrowed table; the caller keeps base alive for the view's lifetime
+   */
+  explicit DataTableView(const DataTable& base);
+
+  /**
+   * @brief View the given rows of a borrowed table; the caller keeps base alive for the view's lifetime
+   * @throws std::out_of_range if an index is not a row of base
+   */
+  DataTableView(const DataTable& base, std::vector<uint32_t> indices);
+
+  /**
+   * @brief The table this view selects from
+   */
+  const DataTable& base() const { return *base_; }
+
+  /**
+   * @brief Number of rows in the view
+   */
+  size_t getNumRows() const { return numRows_; }
+
+  size_t getNumColumns() const { return base_->getNumColumns(); }
+  bool hasColumn(const std::string& name) const { return base_->hasColumn(name); }
+
+  /**
+   * @brief Whether the view rows are a consecutive ascending run of base rows
+   */
+  bool isContiguous() const { return indices_ == nullptr; }
+
+  /**
+   * @brief Base table row backing a view row
+   */
+  uint32_t baseRow(size_t row) const {
+    return indices_ ? (*indices_)[row] : static_cast<uint32_t>(offset_ + row);
+  }
+
+  /**
+   * @brief Base row of every view row, or nullptr when the view is contiguous (rows then start at baseRow(0))
+   */
+  const uint32_t* rowIndices() const { return indices_ ? indices_->data() : nullptr; }
+
+  /**
+   * @brief Direct access to a column of a contiguous view
+   * @throws std::runtime_error if the view is not contiguous
+   * @throws std::out_of_range if the column is missing
+   */
+  template <typename T>
+  absl::Span<const T> span(const std::string& name) const {
+    if (!isContiguous()) {
+      throw std::runtime_error("Column '" + name + "' is not contiguous in this view; use gather()");
+    }
+    return base_->getColumnByName(name).asSpan<T>().subspan(offset_, numRows_);
+  }
+
+  /**
+   * @brief Copy a column's values for the view rows, in view order
+   * @param out Destination with getNumRows() elements
+   * @throws std::runtime_error if T is not the column type or out has the wrong size
+   */
+  template <typename T>
+  void gather(const std::string& name, absl::Span<T> out) const {
+    if (out.size() != numRows_) {
+      throw std::runtime_error("gather: output has " + std::to_string(out.size()) + " elements, expected " +
+                               std::to_string(numRows_));
+    }
+    const absl::Span<const T> src = base_->getColumnByName(name).asSpan<T>();
+    if (indices_) {
+      const uint32_t* rows = indices_->data();
+      for (size_t i = 0; i < numRows_; ++i) {
+        out[i] = src[rows[i]];
+      }
+    } else {
+      std::copy_n(src.data() + offset_, numRows_, out.data());
+    }
+  }
+
+  template <typename T>
+  std::vector<T> gather(const std::string& name) const {
+    std::vector<T> result(numRows_);
+    gather<T>(name, absl::MakeSpan(result));
+    return result;
+  }
+
+  /**
+   * @brief Copy one column of any type for the view rows
+   */
+  Column gatherColumn(const std::string& name) const;
+
+  /**
+   * @brief Copy the view into a standalone table
+   * @param columnNames Optional subset of columns; all columns in base order when empty
+   * @throws std::runtime_error if a requested column is missing
+   */
+  std::unique_ptr<DataTable> materialize(const std::vector<std::string>& columnNames = {}) const;
+
+  /**
+   * @brief Select rows of this view; the result shares this view's base
+   * @param rows View rows (not base rows) to keep, in the new order
+   * @throws std::out_of_range if a row is not in this view
+   */
+  DataTableView select(const std::vector<uint32_t>& rows) const;
+
+ private:
+  void bind(std::vector<uint32_t> indices);
+  Column gatherColumn(const Column& column) const;
+
+  std::shared_ptr<const DataTable> base_;
+  std::shared_ptr<const std::vector<uint32_t>> indices_;  ///< nullptr when contiguous
+  size_t offset_ = 0;                                     ///< first base row when contiguous
+  size_t numRows_ = 0;
+};
+
+}  // namespace splat
@@ -27,7 +27,9 @@
 
 #pragma once
 
+#include <absl/container/flat_hash_map.h>
 #include <absl/types/span.h>
+#include <splat/models/column-storage.h>
 
 #include <algorithm>
 #include <cmath>
@@ -36,6 +38,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <variant>
 #include <vector>
@@ -68,15 +71,17 @@ enum class ColumnType : uint8_t {
 
 /**
  * @brief Variant type representing different typed array storage options
+ *
+ * Buffers are 64-byte aligned and not zero-filled on sizing; see ColumnAllocator.
  */
-using TypedArray = std::variant<std::vector<int8_t>,    // Int8Array
-                                std::vector<uint8_t>,   // Uint8Array
-                                std::vector<int16_t>,   // Int16Array
-                                std::vector<uint16_t>,  // Uint16Array
-                                std::vector<int32_t>,   // Int32Array
-                                std::vector<uint32_t>,  // Uint32Array
-                                std::vector<float>,     // Float32Array
-                                std::vector<double>     // Float64Array
+using TypedArray = std::variant<ColumnVector<int8_t>,    // Int8Array
+                                ColumnVector<uint8_t>,   // Uint8Array
+                                ColumnVector<int16_t>,   // Int16Array
+                                ColumnVector<uint16_t>,  // Uint16Array
+                                ColumnVector<int32_t>,   // Int32Array
+                                ColumnVector<uint32_t>,  // Uint32Array
+                                ColumnVector<float>,     // Float32Array
+                                ColumnVector<double>     // Float64Array
                                 >;
 
 /**
@@ -106,23 +111,23 @@ struct Column {
   /**
    * @brief Get const reference to underlying vector of specified type
    * @tparam T Type of vector to retrieve
-   * @return Const reference to std::vector<T>
+   * @return Const reference to ColumnVector<T>
    * @throws std::bad_variant_access if variant doesn't hold requested type
    */
   template <typename T>
-  const std::vector<T>& asVector() const {
-    return std::get<std::vector<T>>(data);
+  const ColumnVector<T>& asVector() const {
+    return std::get<ColumnVector<T>>(data);
   }
 
   /**
    * @brief Get reference to underlying vector of specified type
    * @tparam T Type of vector to retrieve
-   * @return Reference to std::vector<T>
+   * @return Reference to ColumnVector<T>
    * @throws std::bad_variant_access if variant doesn't hold requested type
    */
   template <typename T>
-  std::vector<T>& asVector() {
-    return std::get<std::vector<T>>(data);
+  ColumnVector<T>& asVector() {
+    return std::get<ColumnVector<T>>(data);
   }
 
   /**
@@ -373,6 +378,67 @@ struct Column {
   }
 };
 
+/**
+ * @brief Size in bytes of one element of the given type
+ */
+size_t columnTypeSize(ColumnType type);
+
+/**
+ * @brief Name and element type of a column to allocate
+ */
+struct ColumnSpec {
+  std::string name;  ///< Column name identifier
+  ColumnType type;   ///< Element type
+};
+
+/**
+ * @brief Allocate columns of numRows uninitialised elements each, packed into one aligned arena
+ *
+ * Meant for readers that overwrite every element: one allocation and no zero-fill instead of one
+ * zero-filled allocation per column. The arena is released once all returned columns are destroyed,
+ * so dropping a single column does not return its memory.
+ */
+std::vector<Column> allocateColumns(const std::vector<ColumnSpec>& specs, size_t numRows);
+
+/**
+ * @brief Process-wide interned column name
+ *
+ * Interning maps every distinct name to a small integer once. Tables keep an id-to-position table,
+ * so a lookup through a cached ColumnId is an array access with no hashing or string comparison,
+ * and the same handle works on every table (clones, permutations, chunks) that has the column.
+ */
+class ColumnId {
+ public:
+  /**
+   * @brief Default-constructed ids refer to no column
+   */
+  ColumnId() = default;
+
+  /**
+   * @brief Intern a column name; thread-safe, and the same name always yields the same id
+   */
+  static ColumnId intern(std::string_view name);
+
+  /**
+   * @brief The interned name
+   * @throws std::out_of_range if the id is not valid
+   */
+  const std::string& name() const;
+
+  bool valid() const { return value_ != kInvalid; }
+  uint32_t value() const { return value_; }
+
+  bool operator==(ColumnId other) const { return value_ == other.value_; }
+  bool operator!=(ColumnId other) const { return value_ != other.value_; }
+
+ private:
+  static constexpr uint32_t kInvalid = ~0u;
+
+  explicit ColumnId(uint32_t value) : value_(value) {}
+
+  uint32_t value_ = kInvalid;
+};
+
 /**
  * @brief Tabular data structure with typed columns
  *
@@ -382,7 +448,9 @@ struct Column {
  */
 class DataTable {
  public:
-  std::vector<Column> columns;  ///< Collection of column data
+  /// Collection of column data. Add, remove and rename columns through the member functions so the
+  /// name index stays in sync; mutating the data of existing columns directly is fine.
+  std::vector<Column> columns;
 
   /**
    * @brief Default constructor
@@ -393,7 +461,7 @@ class DataTable {
    * @brief Construct from existing columns
    * @param columns Vector of columns to initialize with
    */
-  DataTable(const std::vector<Column>& columns);
+  DataTable(std::vector<Column> columns);
 
   // Disable copy semantics to prevent accidental deep copies
   DataTable(const DataTable& other) = delete;
@@ -415,6 +483,7 @@ class DataTable {
    * @param index Row index
    * @param columnIdx Optional indices of specific columns to include
    * @return Row as map<string, float>
+   * @note Builds a map per call; per-splat loops should use GaussianView (gaussian.h) instead
    */
   Row getRow(size_t index, const std::vector<int>& columnIdx = {}) const;
 
@@ -430,6 +499,7 @@ class DataTable {
    * @brief Set values for a specific row
    * @param index Row index
    * @param row Map of column names to values
+   * @note Looks every column up by name; per-splat loops should use GaussianView (gaussian.h) instead
    */
   void setRow(size_t index, const Row& row);
 
@@ -472,6 +542,36 @@ class DataTable {
    */
   int getColumnIndex(const std::string& name) const;
 
+  /**
+   * @brief Get column index by interned id
+   * @param id Interned column name
+   * @return Column index or -1 if not found
+   */
+  int getColumnIndex(ColumnId id) const;
+
+  /**
+   * @brief Get const column by interned id
+   * @param id Interned column name
+   * @return Const reference to Column
+   * @throws std::out_of_range if column not found
+   */
+  const Column& getColumn(ColumnId id) const;
+
+  /**
+   * @brief Get mutable column by interned id
+   * @param id Interned column name
+   * @return Reference to Column
+   * @throws std::out_of_range if column not found
+   */
+  Column& getColumn(ColumnId id);
+
+  /**
+   * @brief Check if column exists by interned id
+   * @param id Interned column name
+   * @return true if column exists, false otherwise
+   */
+  bool hasColumn(ColumnId id) const;
+
   /**
    * @brief Get const column by name
    * @param name Column name
@@ -500,7 +600,7 @@ class DataTable {
    * @param column Column to add
    * @throws std::runtime_error if column length doesn't match existing columns
    */
-  void addColumn(const Column& column);
+  void addColumn(Column column);
 
   /**
    * @brief Remove column by name
@@ -509,6 +609,14 @@ class DataTable {
    */
   bool removeColumn(const std::string& name);
 
+  /**
+   * @brief Rename a column in place
+   * @param from Current column name
+   * @param to New column name
+   * @return true if the column was renamed, false if not found
+   */
+  bool renameColumn(const std::string& from, const std::string& to);
+
   /**
    * @brief Create a deep copy of the table
    * @param columnNames Optional subset of columns to clone
@@ -520,8 +628,23 @@ class DataTable {
    * @brief Create new table with rows permuted according to indices
    * @param indices Permutation indices
    * @return Unique pointer to permuted DataTable
+   * @note Copies every column; use DataTableView (data-table-view.h) to select rows without copying
    */
   std::unique_ptr<DataTable> permuteRows(const std::vector<uint32_t>& indices) const;
+
+ private:
+  /**
+   * @brief Rebuild both name indices from columns
+   */
+  void reindex();
+
+  /**
+   * @brief Record column position in both name indices; the first column with a name wins
+   */
+  void indexColumn(size_t position);
+
+  absl::flat_hash_map<std::string, size_t> nameIndex_;  ///< Column name -> position
+  std::vector<int32_t> idIndex_;                        ///< ColumnId value -> position, -1 if absent
 };
 
 }  // namespace splat
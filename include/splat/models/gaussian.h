@@ -0,0 +1,229 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+
+#pragma once
+
+#include <splat/models/data-table.h>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @file gaussian.h
+ * @brief Typed per-splat access to the standard Gaussian splat columns of a DataTable
+ */
+
+namespace splat {
+
+/**
+ * @brief Standard Gaussian splat attributes, in schema order
+ *
+ * Higher order SH coefficients follow REST_0 contiguously: f_rest_i is REST_0 + i.
+ */
+enum class GaussianAttr : uint8_t {
+  X,        ///< x
+  Y,        ///< y
+  Z,        ///< z
+  ROT_0,    ///< rot_0 (quaternion w)
+  ROT_1,    ///< rot_1 (quaternion x)
+  ROT_2,    ///< rot_2 (quaternion y)
+  ROT_3,    ///< rot_3 (quaternion z)
+  SCALE_0,  ///< scale_0 (log scale)
+  SCALE_1,  ///< scale_1
+  SCALE_2,  ///< scale_2
+  F_DC_0,   ///< f_dc_0
+  F_DC_1,   ///< f_dc_1
+  F_DC_2,   ///< f_dc_2
+  OPACITY,  ///< opacity (logit)
+  REST_0,   ///< f_rest_0
+};
+
+/// Number of f_rest_* coefficients in the schema (three bands, three channels)
+inline constexpr size_t kGaussianRestCount = 45;
+
+/// Number of attributes in the schema
+inline constexpr size_t kGaussianAttrCount = static_cast<size_t>(GaussianAttr::REST_0) + kGaussianRestCount;
+
+// clang-format off
+
+/// Column names of the schema, indexed by GaussianAttr
+inline constexpr std::array<std::string_view, kGaussianAttrCount> kGaussianAttrNames = {
+    "x", "y", "z",
+    "rot_0", "rot_1", "rot_2", "rot_3",
+    "scale_0", "scale_1", "scale_2",
+    "f_dc_0", "f_dc_1", "f_dc_2",
+    "opacity",
+    "f_rest_0",  "f_rest_1",  "f_rest_2",  "f_rest_3",  "f_rest_4",  "f_rest_5",  "f_rest_6",  "f_rest_7",
+    "f_rest_8",  "f_rest_9",  "f_rest_10", "f_rest_11", "f_rest_12", "f_rest_13", "f_rest_14", "f_rest_15",
+    "f_rest_16", "f_rest_17", "f_rest_18", "f_rest_19", "f_rest_20", "f_rest_21", "f_rest_22", "f_rest_23",
+    "f_rest_24", "f_rest_25", "f_rest_26", "f_rest_27", "f_rest_28", "f_rest_29", "f_rest_30", "f_rest_31",
+    "f_rest_32", "f_rest_33", "f_rest_34", "f_rest_35", "f_rest_36", "f_rest_37", "f_rest_38", "f_rest_39",
+    "f_rest_40", "f_rest_41", "f_rest_42", "f_rest_43", "f_rest_44"};
+
+// clang-format on
+
+/**
+ * @brief Schema slot of an attribute
+ */
+constexpr size_t gaussianSlot(GaussianAttr attr) { return static_cast<size_t>(attr); }
+
+/**
+ * @brief One splat of a GaussianView; a pair of (bound column pointers, row index)
+ *
+ * Accessors return references straight into the table's columns. Accessing an attribute the
+ * view did not bind is undefined; check the view's has*() queries first.
+ *
+ * @tparam T float for mutable access, const float for read-only access
+ */
+template <typename T>
+class BasicGaussianRef {
+ public:
+  BasicGaussianRef(T* const* columns, size_t row) : columns_(columns), row_(row) {}
+
+  T& operator[](GaussianAttr attr) const { return columns_[gaussianSlot(attr)][row_]; }
+
+  /// Whether the owning view bound this attribute
+  bool has(GaussianAttr attr) const { return columns_[gaussianSlot(attr)] != nullptr; }
+
+  T& x() const { return (*this)[GaussianAttr::X]; }
+  T& y() const { return (*this)[GaussianAttr::Y]; }
+  T& z() const { return (*this)[GaussianAttr::Z]; }
+
+  /// rot_i, i in [0, 4); rot_0 is the quaternion's w component
+  T& rot(size_t i) const { return columns_[gaussianSlot(GaussianAttr::ROT_0) + i][row_]; }
+
+  /// scale_i, i in [0, 3)
+  T& scale(size_t i) const { return columns_[gaussianSlot(GaussianAttr::SCALE_0) + i][row_]; }
+
+  /// f_dc_i, i in [0, 3)
+  T& dc(size_t i) const { return columns_[gaussianSlot(GaussianAttr::F_DC_0) + i][row_]; }
+
+  T& opacity() const { return (*this)[GaussianAttr::OPACITY]; }
+
+  /// f_rest_i, i in [0, kGaussianRestCount)
+  T& rest(size_t i) const { return columns_[gaussianSlot(GaussianAttr::REST_0) + i][row_]; }
+
+  size_t index() const { return row_; }
+
+ private:
+  T* const* columns_;
+  size_t row_;
+};
+
+using GaussianRef = BasicGaussianRef<float>;
+using ConstGaussianRef = BasicGaussianRef<const float>;
+
+/**
+ * @brief Gaussian schema bound to a DataTable
+ *
+ * Column names are resolved once at construction; afterwards every access is a pointer lookup by
+ * schema slot. Attributes missing from the table are left unbound. The view stays valid while the
+ * table's bound columns are neither removed nor resized.
+ *
+ * @tparam T float for mutable access, const float for read-only access
+ */
+template <typename T>
+class BasicGaussianView {
+ public:
+  using Table = std::conditional_t<std::is_const_v<T>, const DataTable, DataTable>;
+  using Ref = BasicGaussianRef<T>;
+
+  /**
+   * @brief Bind every schema attribute present in the table
+   * @throws std::runtime_error if a schema column exists but is not FLOAT32
+   */
+  explicit BasicGaussianView(Table& table) : size_(table.getNumRows()) {
+    for (size_t slot = 0; slot < kGaussianAttrCount; ++slot) {
+      const int index = table.getColumnIndex(std::string(kGaussianAttrNames[slot]));
+      if (index < 0) continue;
+
+      auto& column = table.getColumn(index);
+      if (column.getType() != ColumnType::FLOAT32) {
+        throw std::runtime_error("Column '" + column.name + "' must be FLOAT32");
+      }
+      columns_[slot] = column.template asVector<float>().data();
+    }
+
+    // f_rest_* only counts as far as it is contiguous from f_rest_0
+    while (restCount_ < kGaussianRestCount && columns_[gaussianSlot(GaussianAttr::REST_0) + restCount_]) {
+      restCount_++;
+    }
+  }
+
+  size_t size() const { return size_; }
+
+  Ref operator[](size_t row) const { return Ref(columns_.data(), row); }
+
+  bool has(GaussianAttr attr) const { return columns_[gaussianSlot(attr)] != nullptr; }
+
+  /// Contiguous column of an attribute, or nullptr when unbound
+  T* column(GaussianAttr attr) const { return columns_[gaussianSlot(attr)]; }
+
+  bool hasPosition() const { return allOf(GaussianAttr::X, 3); }
+  bool hasRotation() const { return allOf(GaussianAttr::ROT_0, 4); }
+  bool hasScale() const { return allOf(GaussianAttr::SCALE_0, 3); }
+  bool hasColor() const { return allOf(GaussianAttr::F_DC_0, 3); }
+  bool hasOpacity() const { return has(GaussianAttr::OPACITY); }
+
+  /**
+   * @brief Number of complete higher order SH bands: 0, 1 (9 coefficients), 2 (24) or 3 (45)
+   */
+  int shBands() const {
+    if (restCount_ >= 45) return 3;
+    if (restCount_ >= 24) return 2;
+    if (restCount_ >= 9) return 1;
+    return 0;
+  }
+
+  /**
+   * @brief f_rest coefficients per colour channel covered by shBands(): 0, 3, 8 or 15
+   */
+  int shCoeffsPerChannel() const {
+    static constexpr int kCoeffs[4] = {0, 3, 8, 15};
+    return kCoeffs[shBands()];
+  }
+
+ private:
+  bool allOf(GaussianAttr first, size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+      if (!columns_[gaussianSlot(first) + i]) return false;
+    }
+    return true;
+  }
+
+  std::array<T*, kGaussianAttrCount> columns_{};
+  size_t size_ = 0;
+  size_t restCount_ = 0;
+};
+
+using GaussianView = BasicGaussianView<float>;
+using ConstGaussianView = BasicGaussianView<const float>;
+
+}  // namespace splat
@@ -67,6 +67,7 @@ struct PlyElement {
 struct PlyHeader {
   std::vector<std::string> comments;  ///< Comment lines from the PLY header
   std::vector<PlyElement> elements;   ///< Element definitions in the PLY file
+  size_t dataOffset = 0;              ///< Byte offset of the first element's data (header length)
 };
 
 /**
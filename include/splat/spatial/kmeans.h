@@ -29,8 +29,82 @@
 
 #include <splat/models/data-table.h>
 
+class ThreadPool;
+
 namespace splat {
 
-std::pair<std::unique_ptr<DataTable>, std::vector<uint32_t>> kmeans(DataTable* points, size_t k, size_t iterations);
+/**
+ * @brief Compute device used for the k-means label assignment step
+ */
+enum class KMeansDevice : uint8_t {
+  Auto,  ///< CUDA when the library was built with it and a device is present, otherwise CPU
+  CPU,   ///< Multithreaded SIMD assignment on the host
+  GPU,   ///< CUDA assignment (falls back to CPU when the library was built without CUDA)
+};
+
+/**
+ * @brief Label assignment strategy
+ */
+enum class KMeansAlgorithm : uint8_t {
+  Auto,     ///< Hamerly on the CPU for tables of at most two columns, brute-force Lloyd otherwise
+  Lloyd,    ///< Compare every point against every centroid each iteration
+  Hamerly,  ///< Triangle-inequality bounds skip points whose label cannot change (CPU only)
+};
+
+/**
+ * @brief How mini-batch rows are drawn from the table
+ */
+enum class KMeansSampling : uint8_t {
+  Random,      ///< Uniform draws with replacement
+  Stratified,  ///< One draw from each of batchSize equal slices of the table
+};
+
+/**
+ * @brief Work counters reported by kmeans()
+ */
+struct KMeansStats {
+  size_t iterations = 0;                     ///< Lloyd iterations or mini-batch steps executed
+  uint64_t distanceComputations = 0;         ///< Point-to-centroid distances evaluated
+  uint64_t skippedDistanceComputations = 0;  ///< Distances avoided relative to brute force
+};
+
+/**
+ * @brief Tuning knobs for kmeans()
+ */
+struct KMeansOptions {
+  KMeansDevice device = KMeansDevice::Auto;           ///< Backend used for label assignment
+  KMeansAlgorithm algorithm = KMeansAlgorithm::Auto;  ///< Assignment strategy
+  size_t batchSize = 0;                               ///< Rows per mini-batch step; 0 runs full Lloyd iterations
+  KMeansSampling sampling = KMeansSampling::Random;   ///< Mini-batch row selection
+  uint64_t seed = 0;                                  ///< Seed for initialisation, sampling and reseeding
+  KMeansStats* stats = nullptr;                       ///< Optional output for work counters
+  ThreadPool* pool = nullptr;                         ///< Workers to run on; a private pool is created when null
+};
+
+/**
+ * @brief Cluster the rows of a float table with Lloyd's algorithm
+ *
+ * Every column of points must be FLOAT32; each row is treated as one D-dimensional point.
+ *
+ * Centroids are seeded with k-means++ (on a sample of the rows for large tables, falling back to
+ * uniformly drawn rows when even a sample would be too costly); single-column tables start from evenly
+ * spaced values. All randomness comes from options.seed, so the same input and seed always produce the
+ * same centroids and labels on the CPU backend, whatever the host's SIMD features or core count. The CUDA
+ * backend is reproducible on its own but may resolve near-ties differently from the CPU.
+ *
+ * With options.batchSize set, each of the iterations fits the centroids on one sampled mini-batch
+ * and a single full assignment pass produces the labels, so the fitting cost no longer grows with
+ * the number of rows.
+ *
+ * Host work runs on options.pool when set; kmeans() may be called from a task already running on it.
+ *
+ * @param points Table of points to cluster
+ * @param k Number of clusters
+ * @param iterations Maximum number of Lloyd iterations, or number of mini-batch steps
+ * @param options Backend selection and tuning
+ * @return Pair of (centroid table with the same columns as points, per-row cluster labels)
+ */
+std::pair<std::unique_ptr<DataTable>, std::vector<uint32_t>> kmeans(DataTable* points, size_t k, size_t iterations,
+                                                                    const KMeansOptions& options = {});
 
 }  // namespace splat
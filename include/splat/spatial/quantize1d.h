@@ -0,0 +1,63 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+
+#pragma once
+
+#include <splat/models/data-table.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+namespace splat {
+
+/**
+ * @brief Build one scalar codebook shared by every column of a float table
+ *
+ * All values of all columns are treated as a single 1D data set. The values are binned into a
+ * fixed-resolution histogram, an optimal partition of the (possibly coarsened) histogram is found
+ * by dynamic programming, and the resulting codebook is refined with Lloyd-Max passes over the full
+ * histogram. Labels are then assigned exactly against the raw values and every codebook entry is
+ * set to the mean of the values it labels, as a final Lloyd iteration would.
+ *
+ * Runs in time linear in the number of values; the result does not depend on the thread count.
+ * Non-finite values are labelled with the nearest end of the codebook and do not contribute to it.
+ *
+ * @param dataTable Table whose columns are all FLOAT32
+ * @param k Codebook size, 1 to 256
+ * @param iterations Maximum number of Lloyd-Max refinement passes
+ * @param pool Workers to run on, which may be the pool of the calling task; a private pool is created when null
+ * @return Pair of (k codebook values in ascending order, UINT8 label table with the input's column names)
+ * @throws std::invalid_argument if k is out of range
+ */
+std::pair<std::vector<float>, std::unique_ptr<DataTable>> quantize1d(const DataTable* dataTable, size_t k,
+                                                                     size_t iterations, ThreadPool* pool = nullptr);
+
+}  // namespace splat
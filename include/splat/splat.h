@@ -32,6 +32,7 @@
 #include <splat/io/csv_writer.h>
 #include <splat/io/decompress_ply.h>
 #include <splat/io/ksplat_reader.h>
+#include <splat/io/ksplat_writer.h>
 #include <splat/io/lcc_reader.h>
 #include <splat/io/lod_writer.h>
 #include <splat/io/ply_reader.h>
@@ -41,9 +42,13 @@
 #include <splat/io/splat-writer.h>
 #include <splat/io/splat_reader.h>
 #include <splat/io/spz_reader.h>
+#include <splat/io/spz_writer.h>
 #include <splat/maths/maths.h>
 #include <splat/maths/rotate-sh.h>
+#include <splat/models/column-storage.h>
+#include <splat/models/data-table-view.h>
 #include <splat/models/data-table.h>
+#include <splat/models/gaussian.h>
 #include <splat/models/lcc.h>
 #include <splat/models/ply.h>
 #include <splat/models/sog.h>
@@ -53,9 +58,12 @@
 #include <splat/spatial/btree.h>
 #include <splat/spatial/kdtree.h>
 #include <splat/spatial/kmeans.h>
+#include <splat/spatial/quantize1d.h>
 #include <splat/splat_version.h>
 #include <splat/utils/crc.h>
 #include <splat/utils/logger.h>
+#include <splat/utils/mapped-file.h>
+#include <splat/utils/output-file.h>
 #include <splat/utils/webp-codec.h>
 #include <splat/utils/zip-reader.h>
 #include <splat/utils/zip-writer.h>
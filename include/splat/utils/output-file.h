@@ -0,0 +1,89 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace splat {
+
+/**
+ * @brief Write-only file written at explicit offsets
+ *
+ * Writes at disjoint offsets do not share a file position, so a dedicated I/O thread can write one
+ * buffer while the next is being filled. With direct I/O the page cache is bypassed; every write must
+ * then start at a multiple of kDirectAlignment, cover a multiple of it and come from a buffer aligned
+ * to it, and the file is cut to its real length with truncate() at the end.
+ */
+class OutputFile {
+ public:
+  /**
+   * @brief Alignment of offsets, sizes and buffers for direct writes
+   */
+  static constexpr size_t kDirectAlignment = 4096;
+
+  /**
+   * @brief Create or truncate filename for writing
+   * @param directIO Request unbuffered writes (O_DIRECT / FILE_FLAG_NO_BUFFERING); falls back to
+   *        buffered writes where the file system refuses them, see direct()
+   * @throws std::runtime_error if the file cannot be created
+   */
+  explicit OutputFile(const std::string& filename, bool directIO = false);
+  ~OutputFile();
+
+  OutputFile(const OutputFile&) = delete;
+  OutputFile& operator=(const OutputFile&) = delete;
+
+  /**
+   * @brief Whether writes bypass the page cache and must honour kDirectAlignment
+   */
+  bool direct() const { return direct_; }
+
+  /**
+   * @brief Write size bytes at offset, retrying short writes
+   * @throws std::runtime_error on I/O errors
+   */
+  void write(const uint8_t* data, size_t size, uint64_t offset);
+
+  /**
+   * @brief Set the file length, dropping the padding of the last direct write
+   */
+  void truncate(uint64_t size);
+
+ private:
+  std::string filename_;
+  bool direct_ = false;
+#ifdef _WIN32
+  void* file_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+};
+
+}  // namespace splat
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <exception>
 #include <functional>
 #include <future>
 #include <memory>
@@ -66,6 +68,73 @@ class ThreadPool {
     return res;
   }
 
+  /**
+   * Splits [begin, end) into chunks of at most `grain` items and runs fn(chunkBegin, chunkEnd) on the
+   * workers, blocking until every chunk has finished. The first exception thrown by fn is rethrown here.
+   *
+   * The calling thread claims chunks alongside the workers, so a task already running on this pool may
+   * call it: chunks no free worker picks up are run by the caller instead of waiting in the queue.
+   */
+  template <typename F>
+  void parallelFor(size_t begin, size_t end, size_t grain, F &&fn) {
+    if (begin >= end) {
+      return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    if (workers_.size() <= 1 || end - begin <= grain) {
+      fn(begin, end);
+      return;
+    }
+
+    struct Shared {
+      std::atomic<size_t> next{0};
+      size_t done = 0;
+      std::exception_ptr error;
+      std::mutex mutex;
+      std::condition_variable finished;
+    };
+
+    const size_t numChunks = (end - begin + grain - 1) / grain;
+    auto shared = std::make_shared<Shared>();
+
+    // fn is only touched after claiming a chunk, and the caller waits for every claimed chunk, so helpers
+    // that start late find nothing left and return without it
+    auto runChunks = [shared, body = &fn, begin, end, grain, numChunks] {
+      size_t completed = 0;
+      for (size_t chunk = shared->next++; chunk < numChunks; chunk = shared->next++) {
+        const size_t lo = begin + chunk * grain;
+        try {
+          (*body)(lo, std::min(end, lo + grain));
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(shared->mutex);
+          if (!shared->error) {
+            shared->error = std::current_exception();
+          }
+        }
+        completed++;
+      }
+      if (completed > 0) {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->done += completed;
+        if (shared->done == numChunks) {
+          shared->finished.notify_all();
+        }
+      }
+    };
+
+    const size_t helpers = std::min(workers_.size(), numChunks - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+      enqueue(runChunks);
+    }
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->finished.wait(lock, [&] { return shared->done == numChunks; });
+    if (shared->error) {
+      std::rethrow_exception(shared->error);
+    }
+  }
+
   size_t getQueueSize() const {
     std::unique_lock<std::mutex> lock(queue_mutex_);
     return tasks_.size();
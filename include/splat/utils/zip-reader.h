@@ -39,14 +39,16 @@ class ZipEntry {
  public:
   std::string name;
   uint32_t size;                                   // Uncompressed size
+  uint64_t offset;                                 // Start of the (stored) data in the archive
   std::function<std::vector<uint8_t>()> readData;  // Lazy data read function
-  ZipEntry(std::string n, uint32_t sz, std::function<std::vector<uint8_t>()> rd)
-      : name(std::move(n)), size(sz), readData(std::move(rd)) {}
+  ZipEntry(std::string n, uint32_t sz, uint64_t off, std::function<std::vector<uint8_t>()> rd)
+      : name(std::move(n)), size(sz), offset(off), readData(std::move(rd)) {}
 };
 
 /**
  * @brief Minimal ZIP reader supporting STORED (method 0) and data descriptors.
- * It sequentially parses Local File Headers to list entries.
+ * Entries are listed from the Central Directory, falling back to sequentially parsing Local File
+ * Headers for archives without one.
  */
 class ZipReader {
  private:
@@ -69,6 +71,7 @@ class ZipReader {
   std::vector<ZipEntry> list();
 
  private:
+  bool listCentralDirectory(std::vector<ZipEntry>& entries);
   std::vector<uint8_t> readAt(std::streamoff pos, size_t len);
   std::vector<uint8_t> read(size_t len);
   uint32_t readUint32LE(const std::vector<uint8_t>& data, size_t offset);
@@ -62,7 +62,7 @@ struct FileInfo {
  * - STORE compression method (no compression)
  * - Data descriptors for streaming writes
  * - Proper ZIP64 format handling for large files
- * - DOS-compatible timestamp encoding
+ * - DOS-compatible timestamp encoding, fixed at 1980-01-01 00:00 unless set otherwise
  *
  * @note This implementation uses synchronous I/O and is not thread-safe
  * @note Files are written with the STORE method (uncompressed) for simplicity and speed
@@ -114,10 +114,15 @@ class ZipWriter {
  public:
   /**
    * @brief Construct a ZipWriter and open the output file
+   *
+   * Every entry is stamped 1980-01-01 00:00 so that identical content produces an identical archive.
+   * SOURCE_DATE_EPOCH, when set, supplies the timestamp instead.
+   *
    * @param filename Path to the ZIP file to create
+   * @param useCurrentTime Stamp entries with the local time at construction when SOURCE_DATE_EPOCH is unset
    * @throws std::runtime_error if the file cannot be opened
    */
-  explicit ZipWriter(const std::string& filename);
+  explicit ZipWriter(const std::string& filename, bool useCurrentTime = false);
 
   /**
    * @brief Destructor - automatically closes the archive if not already closed
@@ -105,13 +105,14 @@ static uint32_t packRot(float x, float y, float z, float w) {
   return result;
 }
 
-static const std::vector<std::string> members = {"x",       "y",      "z",      "scale_0", "scale_1",
-                                                 "scale_2", "f_dc_0", "f_dc_1", "f_dc_2",  "opacity",
-                                                 "rot_0",   "rot_1",  "rot_2",  "rot_3"};
+static constexpr std::array<GaussianAttr, 14> members = {
+    GaussianAttr::X,       GaussianAttr::Y,       GaussianAttr::Z,       GaussianAttr::SCALE_0, GaussianAttr::SCALE_1,
+    GaussianAttr::SCALE_2, GaussianAttr::F_DC_0,  GaussianAttr::F_DC_1,  GaussianAttr::F_DC_2,  GaussianAttr::OPACITY,
+    GaussianAttr::ROT_0,   GaussianAttr::ROT_1,   GaussianAttr::ROT_2,   GaussianAttr::ROT_3};
 
 CompressedChunk::CompressedChunk(size_t sz) : size(sz) {
-  for (const auto& m : members) {
-    this->data[m].resize(size);
+  for (auto& column : this->data) {
+    column.resize(size);
   }
   this->chunkData.resize(18);
   this->position.resize(size);
@@ -120,30 +121,44 @@ CompressedChunk::CompressedChunk(size_t sz) : size(sz) {
   this->color.resize(size);
 }
 
-void CompressedChunk::set(size_t index, const std::map<std::string, float>& dataMap) {
+void CompressedChunk::set(size_t index, const ConstGaussianRef& gaussian) {
   if (index >= size) return;
-  for (const auto& m : members) {
-    if (dataMap.count(m)) {
-      this->data[m][index] = dataMap.at(m);
+  for (size_t m = 0; m < members.size(); ++m) {
+    if (gaussian.has(members[m])) {
+      this->data[m][index] = gaussian[members[m]];
     }
   }
 }
 
+void CompressedChunk::gather(const ConstGaussianView& view, const uint32_t* rows, size_t count) {
+  count = std::min(count, size);
+  for (size_t m = 0; m < members.size(); ++m) {
+    const float* column = view.column(members[m]);
+    if (!column || count == 0) continue;
+
+    auto& staged = this->data[m];
+    for (size_t j = 0; j < count; ++j) {
+      staged[j] = column[rows[j]];
+    }
+    std::fill(staged.begin() + count, staged.end(), staged[count - 1]);
+  }
+}
+
 void CompressedChunk::pack() {
-  auto& x = data["x"];
-  auto& y = data["y"];
-  auto& z = data["z"];
-  auto& scale_0 = data["scale_0"];
-  auto& scale_1 = data["scale_1"];
-  auto& scale_2 = data["scale_2"];
-  auto& rot_0 = data["rot_0"];
-  auto& rot_1 = data["rot_1"];
-  auto& rot_2 = data["rot_2"];
-  auto& rot_3 = data["rot_3"];
-  auto& f_dc_0 = data["f_dc_0"];
-  auto& f_dc_1 = data["f_dc_1"];
-  auto& f_dc_2 = data["f_dc_2"];
-  auto& opacity = data["opacity"];
+  auto& x = data[0];
+  auto& y = data[1];
+  auto& z = data[2];
+  auto& scale_0 = data[3];
+  auto& scale_1 = data[4];
+  auto& scale_2 = data[5];
+  auto& f_dc_0 = data[6];
+  auto& f_dc_1 = data[7];
+  auto& f_dc_2 = data[8];
+  auto& opacity = data[9];
+  auto& rot_0 = data[10];
+  auto& rot_1 = data[11];
+  auto& rot_2 = data[12];
+  auto& rot_3 = data[13];
 
   MinMax px = calcMinMax(x);
   MinMax py = calcMinMax(y);
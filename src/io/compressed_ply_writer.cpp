@@ -25,14 +25,19 @@
  *
  ***********************************************************************************/
 
-#include <absl/strings/str_join.h>
 #include <splat/io/compressed_chunk.h>
 #include <splat/io/compressed_ply_writer.h>
+#include <splat/io/ply_writer.h>
+#include <splat/models/gaussian.h>
+#include <splat/models/ply.h>
 #include <splat/op/morton-order.h>
 #include <splat/splat_version.h>
+#include <splat/utils/threadpool.h>
 
 #include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <thread>
 
 namespace splat {
 
@@ -54,115 +59,110 @@ static std::array<std::string, 4> vertexProps = {
     "packed_color"
 };
 
-static std::array<std::string, 45> shNames = {"f_rest_0",  "f_rest_1",  "f_rest_2",  "f_rest_3",  "f_rest_4",
-                                              "f_rest_5",  "f_rest_6",  "f_rest_7",  "f_rest_8",
-
-                                              "f_rest_9",  "f_rest_10", "f_rest_11", "f_rest_12", "f_rest_13",
-                                              "f_rest_14", "f_rest_15", "f_rest_16", "f_rest_17",
-
-                                              "f_rest_18", "f_rest_19", "f_rest_20", "f_rest_21", "f_rest_22",
-                                              "f_rest_23", "f_rest_24", "f_rest_25", "f_rest_26",
-
-                                              "f_rest_27", "f_rest_28", "f_rest_29", "f_rest_30", "f_rest_31",
-                                              "f_rest_32", "f_rest_33", "f_rest_34", "f_rest_35",
-
-                                              "f_rest_36", "f_rest_37", "f_rest_38", "f_rest_39", "f_rest_40",
-                                              "f_rest_41", "f_rest_42", "f_rest_43", "f_rest_44"};
-
 // clang-format on
 
-static constexpr auto CHUNK_SIZE = 256ULL;
+static constexpr size_t CHUNK_SIZE = 256;
+
+// Chunks per parallelFor task; each task packs its chunks with one staging CompressedChunk.
+static constexpr size_t kChunksPerTask = 64;
 
 void writeCompressedPly(const std::string& filename, DataTable* dataTable) {
-  (void)filename;
-
-  auto it = std::find_if(shNames.begin(), shNames.end(),
-                         [&](const std::string& name) { return !dataTable->hasColumn(name); });
-
-  const int missingIdx = (it == shNames.end()) ? -1 : static_cast<int>(std::distance(shNames.begin(), it));
-  int shBands = 0;
-  switch (missingIdx) {
-    case 9:
-      shBands = 1;
-      break;
-    case 24:
-      shBands = 2;
-      break;
-    case -1:
-      shBands = 3;
-      break;
-    default:
-      shBands = 0;
-      break;
-  };
-  const int outputSHCoeffs = (shBands == 0) ? 0 : (shBands * shBands + 2 * shBands);
+  ConstGaussianView view(*dataTable);
+  if (!view.hasPosition()) {
+    throw std::runtime_error("writeCompressedPly: table has no x, y and z columns");
+  }
 
-  const size_t numSplats = dataTable->getNumRows();
-  const size_t numChunks = std::ceil(numSplats / CHUNK_SIZE);
+  // only complete bands are written
+  const int shBands = view.shBands();
+  const size_t outputSHCoeffs = (shBands == 0) ? 0 : (shBands * shBands + 2 * shBands);
+  const size_t numShCols = outputSHCoeffs * 3;
 
-  std::string shHeader = {};
+  const size_t numSplats = dataTable->getNumRows();
+  const size_t numChunks = (numSplats + CHUNK_SIZE - 1) / CHUNK_SIZE;
 
-  if (shBands > 0) {
-    shHeader += "element sh " + std::to_string(numSplats) + "\n";
-    for (int i = 0; i < outputSHCoeffs * 3; ++i) {
-      shHeader += "property uchar f_rest_" + std::to_string(i) + "\n";
-    }
+  // packed values are written straight into the output columns, which are then interleaved by writePly
+  std::vector<ColumnSpec> chunkSpecs;
+  for (const auto& p : chunkProps) {
+    chunkSpecs.push_back({p, ColumnType::FLOAT32});
+  }
+  std::vector<ColumnSpec> vertexSpecs;
+  for (const auto& p : vertexProps) {
+    vertexSpecs.push_back({p, ColumnType::UINT32});
+  }
+  std::vector<ColumnSpec> shSpecs;
+  for (size_t k = 0; k < numShCols; ++k) {
+    shSpecs.push_back({"f_rest_" + std::to_string(k), ColumnType::UINT8});
   }
 
-  std::vector<std::string> headerTexts;
-  headerTexts.emplace_back("ply");
-  headerTexts.emplace_back("format binary_little_endian 1.0");
-  headerTexts.emplace_back("comment " + std::string("Generated by") + splat::splat_info);
-  for (auto& p : chunkProps) {
-    headerTexts.emplace_back("property float " + p);
+  auto chunkTable = std::make_unique<DataTable>(allocateColumns(chunkSpecs, numChunks));
+  auto vertexTable = std::make_unique<DataTable>(allocateColumns(vertexSpecs, numSplats));
+  std::unique_ptr<DataTable> shTable;
+  if (numShCols > 0) {
+    shTable = std::make_unique<DataTable>(allocateColumns(shSpecs, numSplats));
   }
-  headerTexts.emplace_back("element vertex " + std::to_string(numChunks));
-  for (auto& p : vertexProps) {
-    headerTexts.emplace_back("property uint " + p);
+
+  std::vector<float*> chunkColumns;
+  for (auto& column : chunkTable->columns) {
+    chunkColumns.push_back(column.asVector<float>().data());
   }
-  headerTexts.emplace_back(shHeader);
-  headerTexts.emplace_back("end_header");
+  uint32_t* packedPosition = vertexTable->getColumn(0).asVector<uint32_t>().data();
+  uint32_t* packedRotation = vertexTable->getColumn(1).asVector<uint32_t>().data();
+  uint32_t* packedScale = vertexTable->getColumn(2).asVector<uint32_t>().data();
+  uint32_t* packedColor = vertexTable->getColumn(3).asVector<uint32_t>().data();
 
-  std::string headerText = absl::StrJoin(headerTexts, "\n");
-  std::vector<float> chunkData(numChunks * chunkProps.size(), 0.0f);
-  std::vector<uint32_t> splatIData(numChunks * vertexProps.size(), 0);
-  std::vector<uint8_t> shData(numSplats * outputSHCoeffs * 3, 0);
   // sort splats into some kind of order (morton order rn)
-  std::vector<uint32_t> sortIndices(dataTable->getNumRows(), 0);
-  for (size_t i = 0; i < sortIndices.size(); ++i) {
-    sortIndices[i] = i;
-  }
+  std::vector<uint32_t> sortIndices(numSplats);
+  std::iota(sortIndices.begin(), sortIndices.end(), 0);
   sortMortonOrder(dataTable, absl::MakeSpan(sortIndices));
 
-  Row row;
-  CompressedChunk chunk;
-  for (size_t i = 0; i < numChunks; i++) {
-    const size_t num = std::min(numSplats, static_cast<size_t>((i + 1) * CHUNK_SIZE)) - i * CHUNK_SIZE;
-    for (size_t j = 0; j < num; j++) {
-      const uint32_t index = sortIndices[i * CHUNK_SIZE + j];
+  // every 256-splat chunk is quantized against its own bounds, so chunks pack independently
+  auto packChunks = [&](size_t chunkBegin, size_t chunkEnd) {
+    CompressedChunk chunk(CHUNK_SIZE);
+    for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+      const size_t first = i * CHUNK_SIZE;
+      const size_t num = std::min(numSplats, first + CHUNK_SIZE) - first;
+      const uint32_t* rows = sortIndices.data() + first;
 
-      // read splat data
-      dataTable->getRow(index, row);
+      // repeats the last gaussian to fill the rest of the final chunk
+      chunk.gather(view, rows, num);
+      chunk.pack();
 
-      // quantize and write sh data
-      chunk.set(j, row);
+      for (size_t p = 0; p < chunkColumns.size(); ++p) {
+        chunkColumns[p][i] = chunk.chunkData[p];
+      }
+      std::copy_n(chunk.position.begin(), num, packedPosition + first);
+      std::copy_n(chunk.rotation.begin(), num, packedRotation + first);
+      std::copy_n(chunk.scale.begin(), num, packedScale + first);
+      std::copy_n(chunk.color.begin(), num, packedColor + first);
 
       // quantize and write sh data
-      auto off = (i * CHUNK_SIZE + j) * outputSHCoeffs * 3;
-      for (int k = 0; k < outputSHCoeffs * 3; k++) {
-        const auto nvalue = row[shNames[k]] / 8 + 0.5f;
-        shData[off++] = std::max(0, std::min(255, (int)trunc(nvalue * 256)));
+      for (size_t k = 0; k < numShCols; ++k) {
+        const float* src = view.column(static_cast<GaussianAttr>(gaussianSlot(GaussianAttr::REST_0) + k));
+        uint8_t* dst = shTable->getColumn(k).asVector<uint8_t>().data() + first;
+        for (size_t j = 0; j < num; ++j) {
+          const float nvalue = src[rows[j]] / 8 + 0.5f;
+          dst[j] = static_cast<uint8_t>(std::max(0, std::min(255, static_cast<int>(std::trunc(nvalue * 256)))));
+        }
       }
     }
+  };
 
-    // repeat the last gaussian to fill the rest of the final chunk
-    for (size_t j = 0; j < CHUNK_SIZE; j++) {
-      chunk.set(j, row);
-    }
+  const size_t hardwareThreads = std::thread::hardware_concurrency();
+  if (hardwareThreads > 1 && numChunks > kChunksPerTask) {
+    ThreadPool pool(hardwareThreads);
+    pool.parallelFor(0, numChunks, kChunksPerTask, packChunks);
+  } else {
+    packChunks(0, numChunks);
+  }
 
-    // pack the chunk
-    chunk.pack();
+  PlyData plyData;
+  plyData.comments.emplace_back(std::string("Generated by ") + splat::splat_info);
+  plyData.elements.push_back({"chunk", std::move(chunkTable)});
+  plyData.elements.push_back({"vertex", std::move(vertexTable)});
+  if (shTable) {
+    plyData.elements.push_back({"sh", std::move(shTable)});
   }
+  writePly(filename, plyData);
 }
 
 }  // namespace splat
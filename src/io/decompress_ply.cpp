@@ -26,46 +26,213 @@
  ***********************************************************************************/
 
 #include <splat/io/decompress_ply.h>
+#include <splat/utils/threadpool.h>
 
-#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SPLAT_DECOMPRESS_X86 1
+#endif
 
 namespace splat {
 
 static constexpr size_t CHUNK_SIZE = 256;
 
+// Chunks per parallelFor task.
+static constexpr size_t kChunksPerTask = 64;
+
+static const float SH_C0 = 0.28209479177387814f;
+
+// ---------------------------------------------------------------------------------------------
+// Chunk decoders
+//
+// A chunk's 256 splats share one set of bounds, so each attribute is decoded as a run of lanes:
+// extract the bit field, scale it to [0, 1] and lerp between the chunk's min and max. The AVX2
+// decoder performs exactly the scalar operations (no FMA contraction), so both produce identical
+// floats.
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * @brief Packed input of one chunk; every pointer addresses the chunk's first splat
+ */
+struct PackedChunk {
+  const uint32_t* position;
+  const uint32_t* rotation;
+  const uint32_t* scale;
+  const uint32_t* color;
+};
+
+/**
+ * @brief Decoded output of one chunk; every pointer addresses the chunk's first splat
+ */
+struct DecodedChunk {
+  float* x;
+  float* y;
+  float* z;
+  std::array<float*, 4> rot;
+  std::array<float*, 3> scale;
+  std::array<float*, 3> dc;
+  float* opacity;
+};
+
+/**
+ * @param bounds The chunk row: min xyz, max xyz, min scale xyz, max scale xyz, min rgb, max rgb
+ * @param count Splats in the chunk (the last chunk may be partial)
+ */
+using DecodeChunkFn = void (*)(const PackedChunk& in, const float* bounds, size_t count, const DecodedChunk& out);
+
 static float lerp(float a, float b, float t) { return a * (1.0f - t) + b * t; }
 
-static float unpackUnorm(uint32_t value, int bits) {
-  uint32_t t = (1u << bits) - 1u;
-  return static_cast<float>(value & t) / static_cast<float>(t);
+template <int Shift, int Bits>
+static float unpackUnorm(uint32_t value) {
+  constexpr uint32_t t = (1u << Bits) - 1u;
+  return static_cast<float>((value >> Shift) & t) / static_cast<float>(t);
 }
 
-static Eigen::Vector3f unpack111011(uint32_t value) {
-  return Eigen::Vector3f(unpackUnorm(value >> 21, 11), unpackUnorm(value >> 11, 10), unpackUnorm(value, 11));
+static void decodeChunkScalar(const PackedChunk& in, const float* bounds, size_t count, const DecodedChunk& out) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t p = in.position[i];
+    out.x[i] = lerp(bounds[0], bounds[3], unpackUnorm<21, 11>(p));
+    out.y[i] = lerp(bounds[1], bounds[4], unpackUnorm<11, 10>(p));
+    out.z[i] = lerp(bounds[2], bounds[5], unpackUnorm<0, 11>(p));
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t s = in.scale[i];
+    out.scale[0][i] = lerp(bounds[6], bounds[9], unpackUnorm<21, 11>(s));
+    out.scale[1][i] = lerp(bounds[7], bounds[10], unpackUnorm<11, 10>(s));
+    out.scale[2][i] = lerp(bounds[8], bounds[11], unpackUnorm<0, 11>(s));
+  }
+
+  // opacity keeps the unorm alpha here; decodeOpacity() applies the inverse sigmoid
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t c = in.color[i];
+    out.dc[0][i] = (lerp(bounds[12], bounds[15], unpackUnorm<24, 8>(c)) - 0.5f) / SH_C0;
+    out.dc[1][i] = (lerp(bounds[13], bounds[16], unpackUnorm<16, 8>(c)) - 0.5f) / SH_C0;
+    out.dc[2][i] = (lerp(bounds[14], bounds[17], unpackUnorm<8, 8>(c)) - 0.5f) / SH_C0;
+    out.opacity[i] = unpackUnorm<0, 8>(c);
+  }
+
+  // smallest three components, the largest is rebuilt from the unit norm and stored at index 'which'
+  const float norm = 1.0f / (std::sqrt(2.0f) * 0.5f);
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t r = in.rotation[i];
+    const float a = (unpackUnorm<20, 10>(r) - 0.5f) * norm;
+    const float b = (unpackUnorm<10, 10>(r) - 0.5f) * norm;
+    const float c = (unpackUnorm<0, 10>(r) - 0.5f) * norm;
+    const float m = std::sqrt(std::max(0.0f, 1.0f - (a * a + b * b + c * c)));
+
+    const uint32_t which = r >> 30;
+    out.rot[0][i] = which == 0 ? m : a;
+    out.rot[1][i] = which == 0 ? a : which == 1 ? m : b;
+    out.rot[2][i] = which <= 1 ? b : which == 2 ? m : c;
+    out.rot[3][i] = which == 3 ? m : c;
+  }
 }
 
-static Eigen::Vector4f unpack8888(uint32_t value) {
-  return Eigen::Vector4f(unpackUnorm(value >> 24, 8), unpackUnorm(value >> 16, 8), unpackUnorm(value >> 8, 8),
-                         unpackUnorm(value, 8));
+#ifdef SPLAT_DECOMPRESS_X86
+
+template <int Shift, int Bits>
+__attribute__((target("avx2"))) static inline __m256 unpackUnormAvx2(__m256i value) {
+  constexpr uint32_t t = (1u << Bits) - 1u;
+  const __m256i field = _mm256_and_si256(_mm256_srli_epi32(value, Shift), _mm256_set1_epi32(static_cast<int>(t)));
+  return _mm256_div_ps(_mm256_cvtepi32_ps(field), _mm256_set1_ps(static_cast<float>(t)));
 }
 
-static Eigen::Vector4f unpackRot(uint32_t value) {
-  const float norm = 1.0f / (std::sqrt(2.0f) * 0.5f);
-  float a = (unpackUnorm(value >> 20, 10) - 0.5f) * norm;
-  float b = (unpackUnorm(value >> 10, 10) - 0.5f) * norm;
-  float c = (unpackUnorm(value, 10) - 0.5f) * norm;
-  float m = std::sqrt(std::max(0.0f, 1.0f - (a * a + b * b + c * c)));
-
-  uint32_t which = value >> 30;
-  switch (which) {
-    case 0:
-      return Eigen::Vector4f(m, a, b, c);
-    case 1:
-      return Eigen::Vector4f(a, m, b, c);
-    case 2:
-      return Eigen::Vector4f(a, b, m, c);
-    default:
-      return Eigen::Vector4f(a, b, c, m);
+__attribute__((target("avx2"))) static inline __m256 lerpAvx2(__m256 a, __m256 b, __m256 t) {
+  return _mm256_add_ps(_mm256_mul_ps(a, _mm256_sub_ps(_mm256_set1_ps(1.0f), t)), _mm256_mul_ps(b, t));
+}
+
+__attribute__((target("avx2"))) static inline __m256 lerpAvx2(float a, float b, __m256 t) {
+  return lerpAvx2(_mm256_set1_ps(a), _mm256_set1_ps(b), t);
+}
+
+__attribute__((target("avx2"))) static inline __m256i load8(const uint32_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+__attribute__((target("avx2"))) static void decodeChunkAvx2(const PackedChunk& in, const float* bounds,
+                                                            size_t count, const DecodedChunk& out) {
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 shC0 = _mm256_set1_ps(SH_C0);
+  const __m256 norm = _mm256_set1_ps(1.0f / (std::sqrt(2.0f) * 0.5f));
+  const __m256 one = _mm256_set1_ps(1.0f);
+
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i p = load8(in.position + i);
+    _mm256_storeu_ps(out.x + i, lerpAvx2(bounds[0], bounds[3], unpackUnormAvx2<21, 11>(p)));
+    _mm256_storeu_ps(out.y + i, lerpAvx2(bounds[1], bounds[4], unpackUnormAvx2<11, 10>(p)));
+    _mm256_storeu_ps(out.z + i, lerpAvx2(bounds[2], bounds[5], unpackUnormAvx2<0, 11>(p)));
+
+    const __m256i s = load8(in.scale + i);
+    _mm256_storeu_ps(out.scale[0] + i, lerpAvx2(bounds[6], bounds[9], unpackUnormAvx2<21, 11>(s)));
+    _mm256_storeu_ps(out.scale[1] + i, lerpAvx2(bounds[7], bounds[10], unpackUnormAvx2<11, 10>(s)));
+    _mm256_storeu_ps(out.scale[2] + i, lerpAvx2(bounds[8], bounds[11], unpackUnormAvx2<0, 11>(s)));
+
+    const __m256i c = load8(in.color + i);
+    const __m256 r = lerpAvx2(bounds[12], bounds[15], unpackUnormAvx2<24, 8>(c));
+    const __m256 g = lerpAvx2(bounds[13], bounds[16], unpackUnormAvx2<16, 8>(c));
+    const __m256 b = lerpAvx2(bounds[14], bounds[17], unpackUnormAvx2<8, 8>(c));
+    _mm256_storeu_ps(out.dc[0] + i, _mm256_div_ps(_mm256_sub_ps(r, half), shC0));
+    _mm256_storeu_ps(out.dc[1] + i, _mm256_div_ps(_mm256_sub_ps(g, half), shC0));
+    _mm256_storeu_ps(out.dc[2] + i, _mm256_div_ps(_mm256_sub_ps(b, half), shC0));
+    _mm256_storeu_ps(out.opacity + i, unpackUnormAvx2<0, 8>(c));
+
+    const __m256i q = load8(in.rotation + i);
+    const __m256 qa = _mm256_mul_ps(_mm256_sub_ps(unpackUnormAvx2<20, 10>(q), half), norm);
+    const __m256 qb = _mm256_mul_ps(_mm256_sub_ps(unpackUnormAvx2<10, 10>(q), half), norm);
+    const __m256 qc = _mm256_mul_ps(_mm256_sub_ps(unpackUnormAvx2<0, 10>(q), half), norm);
+    const __m256 sumAB = _mm256_add_ps(_mm256_mul_ps(qa, qa), _mm256_mul_ps(qb, qb));
+    const __m256 sum = _mm256_add_ps(sumAB, _mm256_mul_ps(qc, qc));
+    const __m256 m = _mm256_sqrt_ps(_mm256_max_ps(_mm256_sub_ps(one, sum), _mm256_setzero_ps()));
+
+    const __m256i which = _mm256_srli_epi32(q, 30);
+    const __m256 is0 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(which, _mm256_set1_epi32(0)));
+    const __m256 is1 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(which, _mm256_set1_epi32(1)));
+    const __m256 is2 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(which, _mm256_set1_epi32(2)));
+    const __m256 is3 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(which, _mm256_set1_epi32(3)));
+    _mm256_storeu_ps(out.rot[0] + i, _mm256_blendv_ps(qa, m, is0));
+    _mm256_storeu_ps(out.rot[1] + i, _mm256_blendv_ps(_mm256_blendv_ps(qb, m, is1), qa, is0));
+    _mm256_storeu_ps(out.rot[2] + i, _mm256_blendv_ps(_mm256_blendv_ps(qc, m, is2), qb, _mm256_or_ps(is0, is1)));
+    _mm256_storeu_ps(out.rot[3] + i, _mm256_blendv_ps(qc, m, is3));
+  }
+
+  if (i < count) {
+    const PackedChunk tailIn = {in.position + i, in.rotation + i, in.scale + i, in.color + i};
+    const DecodedChunk tailOut = {out.x + i,
+                                  out.y + i,
+                                  out.z + i,
+                                  {out.rot[0] + i, out.rot[1] + i, out.rot[2] + i, out.rot[3] + i},
+                                  {out.scale[0] + i, out.scale[1] + i, out.scale[2] + i},
+                                  {out.dc[0] + i, out.dc[1] + i, out.dc[2] + i},
+                                  out.opacity + i};
+    decodeChunkScalar(tailIn, bounds, count - i, tailOut);
+  }
+}
+
+#endif  // SPLAT_DECOMPRESS_X86
+
+static DecodeChunkFn selectDecodeChunk() {
+#ifdef SPLAT_DECOMPRESS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return decodeChunkAvx2;
+  }
+#endif
+  return decodeChunkScalar;
+}
+
+/**
+ * @brief Turn the unorm alphas left in the opacity column into logits
+ */
+static void decodeOpacity(float* opacity, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    opacity[i] = -std::log(1.0f / std::max(1e-7f, opacity[i]) - 1.0f);
   }
 }
 
@@ -155,89 +322,107 @@ std::unique_ptr<DataTable> decompressPly(const PlyData* ply) {
   if (vertexIt == ply->elements.end()) throw std::runtime_error("Missing 'vertex' element");
   const DataTable& vertexData = *vertexIt->dataTable;
 
-  auto packed_pos = vertexData.getColumnByName("packed_position").asSpan<uint32_t>();
-  auto packed_rot = vertexData.getColumnByName("packed_rotation").asSpan<uint32_t>();
-  auto packed_scale = vertexData.getColumnByName("packed_scale").asSpan<uint32_t>();
-  auto packed_color = vertexData.getColumnByName("packed_color").asSpan<uint32_t>();
-
-  size_t numSplats = vertexData.getNumRows();
-  constexpr int CHUNK_SIZE = 256;
-
-  auto result = std::make_unique<DataTable>();
-  std::vector<std::string> targetCols = {"x",     "y",     "z",     "f_dc_0", "f_dc_1",  "f_dc_2",  "opacity",
-                                         "rot_0", "rot_1", "rot_2", "rot_3",  "scale_0", "scale_1", "scale_2"};
-  for (const auto& name : targetCols) {
-    result->addColumn(Column{name, std::vector<float>(numSplats)});
-  }
-
-  auto ox = result->getColumnByName("x").asSpan<float>();
-  auto oy = result->getColumnByName("y").asSpan<float>();
-  auto oz = result->getColumnByName("z").asSpan<float>();
-  auto of = std::array<absl::Span<float>, 3>{result->getColumnByName("f_dc_0").asSpan<float>(),
-                                             result->getColumnByName("f_dc_1").asSpan<float>(),
-                                             result->getColumnByName("f_dc_2").asSpan<float>()};
-  auto oo = result->getColumnByName("opacity").asSpan<float>();
-  auto orot = std::array<absl::Span<float>, 4>{
-      result->getColumnByName("rot_0").asSpan<float>(), result->getColumnByName("rot_1").asSpan<float>(),
-      result->getColumnByName("rot_2").asSpan<float>(), result->getColumnByName("rot_3").asSpan<float>()};
-  auto os = std::array<absl::Span<float>, 3>{result->getColumnByName("scale_0").asSpan<float>(),
-                                             result->getColumnByName("scale_1").asSpan<float>(),
-                                             result->getColumnByName("scale_2").asSpan<float>()};
-
-  const float SH_C0 = 0.28209479177387814f;
-
-  for (size_t i = 0; i < numSplats; ++i) {
-    size_t ci = i / CHUNK_SIZE;
-
-    Eigen::Vector3f p_raw = unpack111011(packed_pos[i]);
-    Eigen::Vector4f r_raw = unpackRot(packed_rot[i]);
-    Eigen::Vector3f s_raw = unpack111011(packed_scale[i]);
-    Eigen::Vector4f c_raw = unpack8888(packed_color[i]);
-
-    ox[i] = lerp(chunkData.getColumnByName("min_x").getValue<float>(ci),
-                 chunkData.getColumnByName("max_x").getValue<float>(ci), p_raw.x());
-    oy[i] = lerp(chunkData.getColumnByName("min_y").getValue<float>(ci),
-                 chunkData.getColumnByName("max_y").getValue<float>(ci), p_raw.y());
-    oz[i] = lerp(chunkData.getColumnByName("min_z").getValue<float>(ci),
-                 chunkData.getColumnByName("max_z").getValue<float>(ci), p_raw.z());
-
-    for (int j = 0; j < 4; ++j) orot[j][i] = r_raw[j];
-
-    os[0][i] = lerp(chunkData.getColumnByName("min_scale_x").getValue<float>(ci),
-                    chunkData.getColumnByName("max_scale_x").getValue<float>(ci), s_raw.x());
-    os[1][i] = lerp(chunkData.getColumnByName("min_scale_y").getValue<float>(ci),
-                    chunkData.getColumnByName("max_scale_y").getValue<float>(ci), s_raw.y());
-    os[2][i] = lerp(chunkData.getColumnByName("min_scale_z").getValue<float>(ci),
-                    chunkData.getColumnByName("max_scale_z").getValue<float>(ci), s_raw.z());
-
-    float cr = lerp(chunkData.getColumnByName("min_r").getValue<float>(ci),
-                    chunkData.getColumnByName("max_r").getValue<float>(ci), c_raw.x());
-    float cg = lerp(chunkData.getColumnByName("min_g").getValue<float>(ci),
-                    chunkData.getColumnByName("max_g").getValue<float>(ci), c_raw.y());
-    float cb = lerp(chunkData.getColumnByName("min_b").getValue<float>(ci),
-                    chunkData.getColumnByName("max_b").getValue<float>(ci), c_raw.z());
-
-    of[0][i] = (cr - 0.5f) / SH_C0;
-    of[1][i] = (cg - 0.5f) / SH_C0;
-    of[2][i] = (cb - 0.5f) / SH_C0;
-
-    oo[i] = -std::log(1.0f / std::max(1e-7f, c_raw.w()) - 1.0f);
+  const PackedChunk packed = {vertexData.getColumnByName("packed_position").asSpan<uint32_t>().data(),
+                              vertexData.getColumnByName("packed_rotation").asSpan<uint32_t>().data(),
+                              vertexData.getColumnByName("packed_scale").asSpan<uint32_t>().data(),
+                              vertexData.getColumnByName("packed_color").asSpan<uint32_t>().data()};
+
+  const size_t numSplats = vertexData.getNumRows();
+  const size_t numChunks = (numSplats + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+  // Chunk bounds in decoder order. Files without per-chunk color store colors over [0, 1], which
+  // lerp(0, 1, t) reproduces exactly.
+  static const std::array<const char*, 18> boundNames = {
+      "min_x",       "min_y",       "min_z",       "max_x",       "max_y",       "max_z",
+      "min_scale_x", "min_scale_y", "min_scale_z", "max_scale_x", "max_scale_y", "max_scale_z",
+      "min_r",       "min_g",       "min_b",       "max_r",       "max_g",       "max_b"};
+  std::array<const float*, 18> boundColumns{};
+  for (size_t b = 0; b < boundNames.size(); ++b) {
+    const int index = chunkData.getColumnIndex(boundNames[b]);
+    if (index >= 0) {
+      boundColumns[b] = chunkData.getColumn(index).asSpan<float>().data();
+    } else if (b < 12) {
+      throw std::runtime_error(std::string("Column not found: ") + boundNames[b]);
+    }
+  }
+
+  // every element is written below, so the columns are allocated uninitialised from one arena
+  std::vector<ColumnSpec> targetCols;
+  for (const char* name : {"x", "y", "z", "f_dc_0", "f_dc_1", "f_dc_2", "opacity", "rot_0", "rot_1", "rot_2", "rot_3",
+                           "scale_0", "scale_1", "scale_2"}) {
+    targetCols.push_back({name, ColumnType::FLOAT32});
   }
 
   auto shIt = std::find_if(ply->elements.begin(), ply->elements.end(), [](const auto& e) { return e.name == "sh"; });
-  if (shIt != ply->elements.end()) {
-    const DataTable& shData = *shIt->dataTable;
-    for (size_t k = 0; k < shData.getNumColumns(); ++k) {
-      const Column& col = shData.getColumn(k);
-      auto src = col.asSpan<uint8_t>();
-      std::vector<float> dst(numSplats);
-
-      for (size_t i = 0; i < numSplats; ++i) {
-        float n = (src[i] == 0) ? 0.0f : (src[i] == 255) ? 1.0f : (static_cast<float>(src[i]) + 0.5f) / 256.0f;
-        dst[i] = (n - 0.5f) * 8.0f;
+  const DataTable* shData = shIt != ply->elements.end() ? shIt->dataTable.get() : nullptr;
+  if (shData) {
+    for (const auto& column : shData->columns) {
+      targetCols.push_back({column.name, ColumnType::FLOAT32});
+    }
+  }
+  auto result = std::make_unique<DataTable>(allocateColumns(targetCols, numSplats));
+
+  auto column = [&](const char* name) { return result->getColumnByName(name).asSpan<float>().data(); };
+  const DecodedChunk decoded = {column("x"),
+                                column("y"),
+                                column("z"),
+                                {column("rot_0"), column("rot_1"), column("rot_2"), column("rot_3")},
+                                {column("scale_0"), column("scale_1"), column("scale_2")},
+                                {column("f_dc_0"), column("f_dc_1"), column("f_dc_2")},
+                                column("opacity")};
+
+  // 8 bit SH values dequantize through a table
+  std::array<float, 256> shTable;
+  for (size_t v = 0; v < shTable.size(); ++v) {
+    const float n = (v == 0) ? 0.0f : (v == 255) ? 1.0f : (static_cast<float>(v) + 0.5f) / 256.0f;
+    shTable[v] = (n - 0.5f) * 8.0f;
+  }
+  std::vector<std::pair<const uint8_t*, float*>> shColumns;
+  if (shData) {
+    for (size_t k = 0; k < shData->getNumColumns(); ++k) {
+      shColumns.emplace_back(shData->getColumn(k).asSpan<uint8_t>().data(),
+                             result->getColumn(targetCols.size() - shData->getNumColumns() + k).asSpan<float>().data());
+    }
+  }
+
+  const DecodeChunkFn decodeChunk = selectDecodeChunk();
+  auto decodeChunks = [&](size_t chunkBegin, size_t chunkEnd) {
+    for (size_t ci = chunkBegin; ci < chunkEnd; ++ci) {
+      const size_t first = ci * CHUNK_SIZE;
+      const size_t count = std::min(CHUNK_SIZE, numSplats - first);
+
+      float bounds[18];
+      for (size_t b = 0; b < boundNames.size(); ++b) {
+        bounds[b] = boundColumns[b] ? boundColumns[b][ci] : (b < 15 ? 0.0f : 1.0f);
+      }
+
+      const PackedChunk in = {packed.position + first, packed.rotation + first, packed.scale + first,
+                              packed.color + first};
+      const DecodedChunk out = {decoded.x + first,
+                                decoded.y + first,
+                                decoded.z + first,
+                                {decoded.rot[0] + first, decoded.rot[1] + first, decoded.rot[2] + first,
+                                 decoded.rot[3] + first},
+                                {decoded.scale[0] + first, decoded.scale[1] + first, decoded.scale[2] + first},
+                                {decoded.dc[0] + first, decoded.dc[1] + first, decoded.dc[2] + first},
+                                decoded.opacity + first};
+      decodeChunk(in, bounds, count, out);
+      decodeOpacity(out.opacity, count);
+
+      for (const auto& [src, dst] : shColumns) {
+        for (size_t i = first; i < first + count; ++i) {
+          dst[i] = shTable[src[i]];
+        }
       }
-      result->addColumn(Column{col.name, std::move(dst)});
     }
+  };
+
+  const size_t hardwareThreads = std::thread::hardware_concurrency();
+  if (hardwareThreads > 1 && numChunks > kChunksPerTask) {
+    ThreadPool pool(hardwareThreads);
+    pool.parallelFor(0, numChunks, kChunksPerTask, decodeChunks);
+  } else {
+    decodeChunks(0, numChunks);
   }
 
   return result;
@@ -171,32 +171,39 @@ std::unique_ptr<DataTable> readKsplat(const std::string& filename) {
   }
 
   // Initialize data storage with base columns
-  std::vector<Column> columns = {// Position
-                                 {"x", std::vector<float>(numSplats, 0.0f)},
-                                 {"y", std::vector<float>(numSplats, 0.0f)},
-                                 {"z", std::vector<float>(numSplats, 0.0f)},
-
-                                 // Scale (stored as linear in .splat, convert to log for internal use)
-                                 {"scale_0", std::vector<float>(numSplats, 0.0f)},
-                                 {"scale_1", std::vector<float>(numSplats, 0.0f)},
-                                 {"scale_2", std::vector<float>(numSplats, 0.0f)},
-
-                                 // Color/opacity
-                                 {"f_dc_0", std::vector<float>(numSplats, 0.0f)},  // Red
-                                 {"f_dc_1", std::vector<float>(numSplats, 0.0f)},  // Green
-                                 {"f_dc_2", std::vector<float>(numSplats, 0.0f)},  // Blue
-                                 {"opacity", std::vector<float>(numSplats, 0.0f)},
-
-                                 // Rotation quaternion
-                                 {"rot_0", std::vector<float>(numSplats, 0.0f)},
-                                 {"rot_1", std::vector<float>(numSplats, 0.0f)},
-                                 {"rot_2", std::vector<float>(numSplats, 0.0f)},
-                                 {"rot_3", std::vector<float>(numSplats, 0.0f)}};
+  std::vector<ColumnSpec> specs = {// Position
+                                   {"x", ColumnType::FLOAT32},
+                                   {"y", ColumnType::FLOAT32},
+                                   {"z", ColumnType::FLOAT32},
+
+                                   // Scale (stored as linear in .splat, convert to log for internal use)
+                                   {"scale_0", ColumnType::FLOAT32},
+                                   {"scale_1", ColumnType::FLOAT32},
+                                   {"scale_2", ColumnType::FLOAT32},
+
+                                   // Color/opacity
+                                   {"f_dc_0", ColumnType::FLOAT32},  // Red
+                                   {"f_dc_1", ColumnType::FLOAT32},  // Green
+                                   {"f_dc_2", ColumnType::FLOAT32},  // Blue
+                                   {"opacity", ColumnType::FLOAT32},
+
+                                   // Rotation quaternion
+                                   {"rot_0", ColumnType::FLOAT32},
+                                   {"rot_1", ColumnType::FLOAT32},
+                                   {"rot_2", ColumnType::FLOAT32},
+                                   {"rot_3", ColumnType::FLOAT32}};
 
   // Add spherical harmonics columns based on maximum degree found
   const size_t maxHarmonicsComponentCount = HARMONICS_COMPONENT_COUNT[maxHarmonicsDegree];
   for (size_t i = 0; i < maxHarmonicsComponentCount; i++) {
-    columns.push_back({"f_rest_" + std::to_string(i), std::vector<float>(numSplats)});
+    specs.push_back({"f_rest_" + std::to_string(i), ColumnType::FLOAT32});
+  }
+
+  // base attributes are written for every splat; sections with fewer bands leave higher SH untouched
+  std::vector<Column> columns = allocateColumns(specs, numSplats);
+  for (size_t i = 14; i < columns.size(); i++) {
+    auto values = columns[i].asSpan<float>();
+    std::fill(values.begin(), values.end(), 0.0f);
   }
 
   const auto& config = COMPRESSION_MODES[compressionMode];
@@ -211,7 +218,7 @@ std::unique_ptr<DataTable> readKsplat(const std::string& filename) {
   const auto& harmonicsStartByte = config.harmonicsStartByte;
   const auto& scaleQuantRange = config.scaleQuantRange;
 
-  const auto currentSectionDataOffset = MAIN_HEADER_SIZE + maxSections * SECTION_HEADER_SIZE;
+  uint64_t currentSectionDataOffset = MAIN_HEADER_SIZE + maxSections * SECTION_HEADER_SIZE;
   size_t splatIndex = 0;
 
   // Process each section
@@ -219,7 +226,7 @@ std::unique_ptr<DataTable> readKsplat(const std::string& filename) {
     const auto sectionHeaderOffset = MAIN_HEADER_SIZE + sectionIdx * SECTION_HEADER_SIZE;
     file.seekg(sectionHeaderOffset, std::ios::beg);
 
-    std::vector<uint8_t> sectionHeader;
+    std::vector<uint8_t> sectionHeader(SECTION_HEADER_SIZE);
     if (!file.read(reinterpret_cast<char*>(sectionHeader.data()), SECTION_HEADER_SIZE)) {
       continue;  // Section header is invalid/missing, stop processing sections
     }
@@ -230,7 +237,8 @@ std::unique_ptr<DataTable> readKsplat(const std::string& filename) {
     const auto bucketCount = getUint32(sectionHeader.data(), 12);
     const auto spatialBlockSize = getFloat32(sectionHeader.data(), 16);
     const auto bucketStorageSize = getUint16(sectionHeader.data(), 20);
-    const auto quantizationRange = getUint32(sectionHeader.data(), 24) || scaleQuantRange;
+    const uint32_t sectionQuantRange = getUint32(sectionHeader.data(), 24);
+    const uint32_t quantizationRange = sectionQuantRange ? sectionQuantRange : scaleQuantRange;
     const auto fullBuckets = getUint32(sectionHeader.data(), 32);
     const auto partialBuckets = getUint32(sectionHeader.data(), 36);
     const auto harmonicsDegree = getUint16(sectionHeader.data(), 40);
@@ -247,19 +255,23 @@ std::unique_ptr<DataTable> readKsplat(const std::string& filename) {
     // Calculate decompression parameters
     const float positionScale = spatialBlockSize / 2.0f / quantizationRange;
 
-    // Get bucket centers
-    const auto bucketCentersOffset = currentSectionDataOffset + partialBucketMetaSize;
-    (void)bucketCentersOffset;
-    std::vector<float> bucketCenters(bucketCount * 3);
-    if (!file.read(reinterpret_cast<char*>(bucketCenters.data()), bucketCount * 3 * sizeof(float))) {
-      throw std::runtime_error("Failed to read bucket centers");
+    if (splatIndex + sectionSplatCount > numSplats || sectionSplatCount > maxSectionSplats) {
+      throw std::runtime_error("Invalid .ksplat file: section splat count out of range");
     }
-    // Get partial bucket sizes
+
+    // Section data starts with the partial bucket sizes, followed by the bucket centers
+    file.seekg(currentSectionDataOffset, std::ios::beg);
     std::vector<uint32_t> partialBucketSizes(partialBuckets);
     if (!file.read(reinterpret_cast<char*>(partialBucketSizes.data()), partialBucketSizes.size() * sizeof(uint32_t))) {
       throw std::runtime_error("Failed to read partial bucket sizes");
     }
+    // Get bucket centers
+    std::vector<float> bucketCenters(bucketCount * 3);
+    if (!file.read(reinterpret_cast<char*>(bucketCenters.data()), bucketCount * 3 * sizeof(float))) {
+      throw std::runtime_error("Failed to read bucket centers");
+    }
     // Get splat data
+    file.seekg(currentSectionDataOffset + totalBucketStorageSize, std::ios::beg);
     std::vector<uint8_t> splatData(sectionDataSize);
     if (!file.read(reinterpret_cast<char*>(splatData.data()), splatData.size())) {
       throw std::runtime_error("Failed to read splat data");
@@ -287,6 +299,7 @@ std::unique_ptr<DataTable> readKsplat(const std::string& filename) {
     // Process splats in this section
     for (size_t splatIdx = 0; splatIdx < sectionSplatCount; ++splatIdx) {
       const size_t splatByteOffset = splatIdx * bytesPerSplat;
+      const size_t row = splatIndex + splatIdx;
 
       // Determine which bucket this splat belongs to
       uint32_t bucketIdx;
@@ -308,12 +321,13 @@ std::unique_ptr<DataTable> readKsplat(const std::string& filename) {
         y = getFloat32(splatData.data(), splatByteOffset + 4);
         z = getFloat32(splatData.data(), splatByteOffset + 8);
       } else {
-        x = (getUint16(splatData.data(), splatByteOffset + 0) - quantizationRange) * positionScale +
-            bucketCenters[bucketIdx * 3];
-        y = (getUint16(splatData.data(), splatByteOffset + 2) - quantizationRange) * positionScale +
-            bucketCenters[bucketIdx * 3 + 1];
-        z = (getUint16(splatData.data(), splatByteOffset + 4) - quantizationRange) * positionScale +
-            bucketCenters[bucketIdx * 3 + 2];
+        const float* center = &bucketCenters[bucketIdx * 3];
+        x = (static_cast<float>(getUint16(splatData.data(), splatByteOffset + 0)) - quantizationRange) * positionScale +
+            center[0];
+        y = (static_cast<float>(getUint16(splatData.data(), splatByteOffset + 2)) - quantizationRange) * positionScale +
+            center[1];
+        z = (static_cast<float>(getUint16(splatData.data(), splatByteOffset + 4)) - quantizationRange) * positionScale +
+            center[2];
       }
 
       // Decode scales
@@ -349,31 +363,31 @@ std::unique_ptr<DataTable> readKsplat(const std::string& filename) {
       uint8_t opacity = splatData[splatByteOffset + colorStartByte + 3];
 
       // store position
-      columns[0].setValue<float>(splatIdx, x);
-      columns[1].setValue<float>(splatIdx, y);
-      columns[2].setValue<float>(splatIdx, z);
+      columns[0].setValue<float>(row, x);
+      columns[1].setValue<float>(row, y);
+      columns[2].setValue<float>(row, z);
 
       // Store scale (convert from linear in .ksplat to log scale for internal use)
-      columns[3].setValue<float>(splatIdx, scaleX > 0 ? logf(scaleX) : -10.0f);
-      columns[4].setValue<float>(splatIdx, scaleY > 0 ? logf(scaleY) : -10.0f);
-      columns[5].setValue<float>(splatIdx, scaleZ > 0 ? logf(scaleZ) : -10.0f);
+      columns[3].setValue<float>(row, scaleX > 0 ? logf(scaleX) : -10.0f);
+      columns[4].setValue<float>(row, scaleY > 0 ? logf(scaleY) : -10.0f);
+      columns[5].setValue<float>(row, scaleZ > 0 ? logf(scaleZ) : -10.0f);
 
       // Store color (convert from uint8 back to spherical harmonics)
       static constexpr auto SH_C0 = 0.28209479177387814;
-      columns[6].setValue<float>(splatIdx, (red / 255.0f - 0.5f) / SH_C0);
-      columns[7].setValue<float>(splatIdx, (green / 255.0f - 0.5f) / SH_C0);
-      columns[8].setValue<float>(splatIdx, (blue / 255.0f - 0.5f) / SH_C0);
+      columns[6].setValue<float>(row, (red / 255.0f - 0.5f) / SH_C0);
+      columns[7].setValue<float>(row, (green / 255.0f - 0.5f) / SH_C0);
+      columns[8].setValue<float>(row, (blue / 255.0f - 0.5f) / SH_C0);
 
       // Store opacity (convert from uint8 to float and apply inverse sigmoid)
       static constexpr auto epsilon = 1e-6f;
       const auto normalizedOpacity = std::max(epsilon, std::min(1.0f - epsilon, opacity / 255.0f));
-      columns[9].setValue<float>(splatIdx, logf(normalizedOpacity / (1.0 - normalizedOpacity)));
+      columns[9].setValue<float>(row, logf(normalizedOpacity / (1.0 - normalizedOpacity)));
 
       // Store quaternion
-      columns[10].setValue<float>(splatIdx, rot0);
-      columns[11].setValue<float>(splatIdx, rot1);
-      columns[12].setValue<float>(splatIdx, rot2);
-      columns[13].setValue<float>(splatIdx, rot3);
+      columns[10].setValue<float>(row, rot0);
+      columns[11].setValue<float>(row, rot1);
+      columns[12].setValue<float>(row, rot2);
+      columns[13].setValue<float>(row, rot3);
 
       // Store spherical harmonics
       const size_t baseColumnIndex = 14;
@@ -393,19 +407,18 @@ std::unique_ptr<DataTable> readKsplat(const std::string& filename) {
         }
 
         const size_t col = channel * (maxHarmonicsComponentCount / 3) + coeff;
-        columns[baseColumnIndex + col].setValue<float>(splatIdx, decodeHarmonics(splatByteOffset, i));
+        columns[baseColumnIndex + col].setValue<float>(row, decodeHarmonics(splatByteOffset, i));
       }
-
-      splatIdx++;
     }
-    file.seekg(static_cast<std::streamsize>(file.tellg()) + sectionDataSize + totalBucketStorageSize);
+    splatIndex += sectionSplatCount;
+    currentSectionDataOffset += totalBucketStorageSize + sectionDataSize;
   }
 
   if (splatIndex != numSplats) {
     throw std::runtime_error("Splat count mismatch: expected " + std::to_string(numSplats) + ", processed " +
                              std::to_string(splatIndex));
   }
-  return std::make_unique<DataTable>(columns);
+  return std::make_unique<DataTable>(std::move(columns));
 }
 
 }  // namespace splat
@@ -0,0 +1,421 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <absl/container/flat_hash_map.h>
+#include <splat/io/ksplat_writer.h>
+#include <splat/maths/maths.h>
+#include <splat/models/gaussian.h>
+#include <splat/op/morton-order.h>
+#include <splat/utils/output-file.h>
+#include <splat/utils/threadpool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <thread>
+
+namespace splat {
+
+static constexpr size_t MAIN_HEADER_SIZE = 4096;
+static constexpr size_t SECTION_HEADER_SIZE = 1024;
+
+// Each bucket stores its centre as three floats
+static constexpr uint16_t BUCKET_STORAGE_SIZE = 12;
+
+static constexpr float SH_C0 = 0.28209479177387814f;
+
+struct CompressionConfig {
+  size_t centerBytes;
+  size_t scaleBytes;
+  size_t rotationBytes;
+  size_t colorBytes;
+  size_t harmonicsBytes;
+  uint32_t scaleQuantRange;
+};
+
+static const CompressionConfig COMPRESSION_MODES[] = {
+    // Mode 0: Full precision
+    {12, 12, 16, 4, 4, 1},
+    // Mode 1: Half precision / Quantized position
+    {6, 6, 8, 4, 2, 32767},
+    // Mode 2: Byte harmonics / Half scale/rotation / Quantized position
+    {6, 6, 8, 4, 1, 32767}};
+
+static const size_t HARMONICS_COMPONENT_COUNT[] = {0, 9, 24, 45};
+
+// Rounds to nearest even; overflow saturates to infinity
+static uint16_t encodeFloat16(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+  const uint32_t absBits = bits & 0x7fffffff;
+
+  if (absBits >= 0x7f800000) {
+    return sign | (absBits > 0x7f800000 ? 0x7e00 : 0x7c00);
+  }
+  if (absBits >= 0x477ff000) {
+    return sign | 0x7c00;
+  }
+  if (absBits < 0x38800000) {
+    // denormalized half: count units of 2^-24
+    if (absBits < 0x33000000) return sign;
+    const uint32_t mantissa = (absBits & 0x7fffff) | 0x800000;
+    const uint32_t shift = 126 - (absBits >> 23);
+    uint32_t half = mantissa >> shift;
+    const uint32_t rest = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (rest > halfway || (rest == halfway && (half & 1))) half++;
+    return sign | static_cast<uint16_t>(half);
+  }
+
+  // rebias the exponent from 127 to 15 and drop 13 mantissa bits
+  uint32_t half = (absBits - 0x38000000) >> 13;
+  const uint32_t rest = absBits & 0x1fff;
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;
+  return sign | static_cast<uint16_t>(half);
+}
+
+static uint8_t toUint8(float v) {
+  if (!(v > 0.0f)) return 0;
+  return static_cast<uint8_t>(std::min(std::round(v), 255.0f));
+}
+
+template <typename T>
+static void put(uint8_t* out, size_t offset, T value) {
+  std::memcpy(out + offset, &value, sizeof(T));
+}
+
+/**
+ * @brief KSPLAT order of the higher order SH coefficients: band by band, each band channel-major
+ *
+ * Returns the f_rest coefficient index within a channel for KSPLAT component i.
+ */
+static void harmonicsComponent(size_t i, size_t& channel, size_t& coeff) {
+  if (i < 9) {
+    channel = i / 3;
+    coeff = i % 3;
+  } else if (i < 24) {
+    channel = (i - 9) / 5;
+    coeff = (i - 9) % 5 + 3;
+  } else {
+    channel = (i - 24) / 7;
+    coeff = (i - 24) % 7 + 8;
+  }
+}
+
+namespace {
+
+/// Splats sharing one quantisation centre
+struct KsplatBucket {
+  uint32_t begin;  ///< First entry in the cell-grouped splat order
+  uint32_t count;
+  float center[3];
+};
+
+struct KsplatSection {
+  std::vector<KsplatBucket> buckets;  ///< Full buckets first, then partially filled ones
+  uint32_t fullBuckets = 0;
+  uint32_t splatCount = 0;
+  uint64_t dataOffset = 0;
+  size_t dataSize = 0;
+};
+
+}  // namespace
+
+void writeKsplat(const std::string& filename, const DataTable* dataTable, const KsplatWriteOptions& options) {
+  if (options.compressionMode > 2) {
+    throw std::invalid_argument("writeKsplat: invalid compression mode " + std::to_string(options.compressionMode));
+  }
+  if (!(options.blockSize > 0.0f) || options.bucketSize == 0 || options.sectionSize == 0) {
+    throw std::invalid_argument("writeKsplat: blockSize, bucketSize and sectionSize must be positive");
+  }
+
+  ConstGaussianView view(*dataTable);
+  if (!view.hasPosition() || !view.hasRotation() || !view.hasScale() || !view.hasColor() || !view.hasOpacity()) {
+    throw std::runtime_error("writeKsplat: table lacks position, rotation, scale, colour or opacity columns");
+  }
+
+  const size_t numSplats = dataTable->getNumRows();
+  if (numSplats == 0) {
+    throw std::runtime_error("writeKsplat: table is empty");
+  }
+  if (numSplats > UINT32_MAX) {
+    throw std::runtime_error("writeKsplat: too many splats");
+  }
+
+  const float* pos[3] = {view.column(GaussianAttr::X), view.column(GaussianAttr::Y), view.column(GaussianAttr::Z)};
+
+  // only complete bands are written
+  const int shDegree = view.shBands();
+  const size_t harmonicsCount = HARMONICS_COMPONENT_COUNT[shDegree];
+  const size_t coeffsPerChannel = static_cast<size_t>(view.shCoeffsPerChannel());
+  std::vector<const float*> harmonics(harmonicsCount);
+  for (size_t i = 0; i < harmonicsCount; ++i) {
+    size_t channel, coeff;
+    harmonicsComponent(i, channel, coeff);
+    harmonics[i] = view.column(static_cast<GaussianAttr>(gaussianSlot(GaussianAttr::REST_0) +
+                                                         channel * coeffsPerChannel + coeff));
+  }
+
+  float sceneMin[3], sceneMax[3];
+  for (int d = 0; d < 3; ++d) {
+    sceneMin[d] = std::numeric_limits<float>::max();
+    sceneMax[d] = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < numSplats; ++i) {
+      sceneMin[d] = std::min(sceneMin[d], pos[d][i]);
+      sceneMax[d] = std::max(sceneMax[d], pos[d][i]);
+    }
+    if (sceneMin[d] > sceneMax[d]) sceneMin[d] = sceneMax[d] = 0.0f;
+  }
+
+  // mode 2 stores SH bytes against the file-wide range
+  float minHarmonics = -1.0f, maxHarmonics = 1.0f;
+  if (options.compressionMode == 2 && harmonicsCount > 0) {
+    minHarmonics = std::numeric_limits<float>::max();
+    maxHarmonics = std::numeric_limits<float>::lowest();
+    for (const float* column : harmonics) {
+      const auto [lo, hi] = std::minmax_element(column, column + numSplats);
+      minHarmonics = std::min(minHarmonics, *lo);
+      maxHarmonics = std::max(maxHarmonics, *hi);
+    }
+    if (!(maxHarmonics > minHarmonics)) maxHarmonics = minHarmonics + 1.0f;
+  }
+
+  // sort splats into morton order, then group them by grid cell in order of first appearance
+  std::vector<uint32_t> mortonIndices(numSplats);
+  std::iota(mortonIndices.begin(), mortonIndices.end(), 0);
+  sortMortonOrder(dataTable, absl::MakeSpan(mortonIndices));
+
+  const float blockSize = options.blockSize;
+  auto cellCoord = [&](int d, uint32_t i) {
+    const float c = std::floor((pos[d][i] - sceneMin[d]) / blockSize);
+    return static_cast<uint32_t>(std::clamp(c == c ? c : 0.0f, 0.0f, 2097151.0f));
+  };
+
+  std::vector<uint32_t> cellOf(numSplats);
+  std::vector<uint32_t> cellCounts;
+  std::vector<uint32_t> cellSamples;  // one splat of each cell, to recover its coordinates
+  {
+    absl::flat_hash_map<uint64_t, uint32_t> cellIds;
+    for (uint32_t i : mortonIndices) {
+      const uint64_t key = (static_cast<uint64_t>(cellCoord(0, i)) << 42) |
+                           (static_cast<uint64_t>(cellCoord(1, i)) << 21) | cellCoord(2, i);
+      auto [it, inserted] = cellIds.try_emplace(key, static_cast<uint32_t>(cellCounts.size()));
+      if (inserted) {
+        cellCounts.push_back(0);
+        cellSamples.push_back(i);
+      }
+      cellOf[i] = it->second;
+      cellCounts[it->second]++;
+    }
+  }
+
+  // counting sort by cell keeps the morton order inside each cell
+  const size_t numCells = cellCounts.size();
+  std::vector<uint32_t> cellStart(numCells + 1, 0);
+  for (size_t c = 0; c < numCells; ++c) cellStart[c + 1] = cellStart[c] + cellCounts[c];
+  std::vector<uint32_t> order(numSplats);
+  {
+    std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    for (uint32_t i : mortonIndices) order[cursor[cellOf[i]]++] = i;
+  }
+
+  // cut cells into buckets and runs of cells into sections
+  const auto& config = COMPRESSION_MODES[options.compressionMode];
+  const size_t bytesPerSplat = config.centerBytes + config.scaleBytes + config.rotationBytes + config.colorBytes +
+                               harmonicsCount * config.harmonicsBytes;
+
+  std::vector<KsplatSection> sections;
+  {
+    KsplatSection section;
+    std::vector<KsplatBucket> partial;
+    auto closeSection = [&]() {
+      section.fullBuckets = static_cast<uint32_t>(section.buckets.size());
+      section.buckets.insert(section.buckets.end(), partial.begin(), partial.end());
+      sections.push_back(std::move(section));
+      section = KsplatSection();
+      partial.clear();
+    };
+
+    for (size_t c = 0; c < numCells; ++c) {
+      KsplatBucket bucket{cellStart[c], 0, {}};
+      for (int d = 0; d < 3; ++d) {
+        bucket.center[d] = sceneMin[d] + (static_cast<float>(cellCoord(d, cellSamples[c])) + 0.5f) * blockSize;
+      }
+
+      const uint32_t count = cellCounts[c];
+      for (uint32_t b = 0; b < count; b += options.bucketSize) {
+        bucket.begin = cellStart[c] + b;
+        bucket.count = std::min(options.bucketSize, count - b);
+        (bucket.count == options.bucketSize ? section.buckets : partial).push_back(bucket);
+      }
+      section.splatCount += count;
+      if (section.splatCount >= options.sectionSize) closeSection();
+    }
+    if (section.splatCount > 0) closeSection();
+  }
+
+  // the file holds the main header, every section header, then every section's bucket storage and splats
+  uint64_t offset = MAIN_HEADER_SIZE + sections.size() * SECTION_HEADER_SIZE;
+  for (auto& section : sections) {
+    const size_t partialBuckets = section.buckets.size() - section.fullBuckets;
+    section.dataOffset = offset;
+    section.dataSize =
+        partialBuckets * 4 + section.buckets.size() * BUCKET_STORAGE_SIZE + section.splatCount * bytesPerSplat;
+    offset += section.dataSize;
+  }
+
+  std::vector<uint8_t> header(MAIN_HEADER_SIZE + sections.size() * SECTION_HEADER_SIZE, 0);
+  header[0] = 0;  // major version
+  header[1] = 1;  // minor version
+  put<uint32_t>(header.data(), 4, static_cast<uint32_t>(sections.size()));
+  put<uint32_t>(header.data(), 8, static_cast<uint32_t>(sections.size()));
+  put<uint32_t>(header.data(), 12, static_cast<uint32_t>(numSplats));
+  put<uint32_t>(header.data(), 16, static_cast<uint32_t>(numSplats));
+  put<uint16_t>(header.data(), 20, options.compressionMode);
+  for (int d = 0; d < 3; ++d) {
+    put<float>(header.data(), 24 + d * 4, (sceneMin[d] + sceneMax[d]) * 0.5f);
+  }
+  put<float>(header.data(), 36, minHarmonics);
+  put<float>(header.data(), 40, maxHarmonics);
+
+  for (size_t s = 0; s < sections.size(); ++s) {
+    const auto& section = sections[s];
+    uint8_t* sectionHeader = header.data() + MAIN_HEADER_SIZE + s * SECTION_HEADER_SIZE;
+    put<uint32_t>(sectionHeader, 0, section.splatCount);
+    put<uint32_t>(sectionHeader, 4, section.splatCount);
+    put<uint32_t>(sectionHeader, 8, options.bucketSize);
+    put<uint32_t>(sectionHeader, 12, static_cast<uint32_t>(section.buckets.size()));
+    put<float>(sectionHeader, 16, blockSize);
+    put<uint16_t>(sectionHeader, 20, BUCKET_STORAGE_SIZE);
+    put<uint32_t>(sectionHeader, 24, config.scaleQuantRange);
+    put<uint32_t>(sectionHeader, 28, static_cast<uint32_t>(section.dataSize));
+    put<uint32_t>(sectionHeader, 32, section.fullBuckets);
+    put<uint32_t>(sectionHeader, 36, static_cast<uint32_t>(section.buckets.size() - section.fullBuckets));
+    put<uint16_t>(sectionHeader, 40, static_cast<uint16_t>(shDegree));
+  }
+
+  OutputFile file(filename);
+  file.write(header.data(), header.size(), 0);
+
+  const float* rot[4] = {view.column(GaussianAttr::ROT_0), view.column(GaussianAttr::ROT_1),
+                         view.column(GaussianAttr::ROT_2), view.column(GaussianAttr::ROT_3)};
+  const float* scale[3] = {view.column(GaussianAttr::SCALE_0), view.column(GaussianAttr::SCALE_1),
+                           view.column(GaussianAttr::SCALE_2)};
+  const float* dc[3] = {view.column(GaussianAttr::F_DC_0), view.column(GaussianAttr::F_DC_1),
+                        view.column(GaussianAttr::F_DC_2)};
+  const float* opacity = view.column(GaussianAttr::OPACITY);
+
+  const uint16_t mode = options.compressionMode;
+  const float quantRange = static_cast<float>(config.scaleQuantRange);
+  const float positionQuant = quantRange * 2.0f / blockSize;
+  const float harmonicsQuant = 255.0f / (maxHarmonics - minHarmonics);
+
+  // sections are independent: each is encoded into its own buffer and written at its offset
+  auto encodeSections = [&](size_t sectionBegin, size_t sectionEnd) {
+    std::vector<uint8_t> data;
+    for (size_t s = sectionBegin; s < sectionEnd; ++s) {
+      const auto& section = sections[s];
+      data.assign(section.dataSize, 0);
+      uint8_t* out = data.data();
+
+      for (size_t b = section.fullBuckets; b < section.buckets.size(); ++b, out += 4) {
+        put<uint32_t>(out, 0, section.buckets[b].count);
+      }
+      for (const auto& bucket : section.buckets) {
+        std::memcpy(out, bucket.center, BUCKET_STORAGE_SIZE);
+        out += BUCKET_STORAGE_SIZE;
+      }
+
+      for (const auto& bucket : section.buckets) {
+        for (uint32_t k = 0; k < bucket.count; ++k, out += bytesPerSplat) {
+          const uint32_t i = order[bucket.begin + k];
+
+          size_t o = 0;
+          if (mode == 0) {
+            for (int d = 0; d < 3; ++d, o += 4) put<float>(out, o, pos[d][i]);
+            for (int d = 0; d < 3; ++d, o += 4) put<float>(out, o, std::exp(scale[d][i]));
+          } else {
+            for (int d = 0; d < 3; ++d, o += 2) {
+              const float q = std::round((pos[d][i] - bucket.center[d]) * positionQuant) + quantRange;
+              put<uint16_t>(out, o, static_cast<uint16_t>(std::clamp(q == q ? q : quantRange, 0.0f, 65535.0f)));
+            }
+            for (int d = 0; d < 3; ++d, o += 2) put<uint16_t>(out, o, encodeFloat16(std::exp(scale[d][i])));
+          }
+
+          float q[4] = {rot[0][i], rot[1][i], rot[2][i], rot[3][i]};
+          const float len = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+          if (len > 0.0f && std::isfinite(len)) {
+            for (float& v : q) v /= len;
+          } else {
+            q[0] = 1.0f;
+            q[1] = q[2] = q[3] = 0.0f;
+          }
+          for (int d = 0; d < 4; ++d) {
+            if (mode == 0) {
+              put<float>(out, o, q[d]);
+              o += 4;
+            } else {
+              put<uint16_t>(out, o, encodeFloat16(q[d]));
+              o += 2;
+            }
+          }
+
+          for (int d = 0; d < 3; ++d) out[o++] = toUint8((0.5f + SH_C0 * dc[d][i]) * 255.0f);
+          out[o++] = toUint8(sigmoid(opacity[i]) * 255.0f);
+
+          for (size_t h = 0; h < harmonicsCount; ++h) {
+            const float v = harmonics[h][i];
+            if (mode == 0) {
+              put<float>(out, o, v);
+              o += 4;
+            } else if (mode == 1) {
+              put<uint16_t>(out, o, encodeFloat16(v));
+              o += 2;
+            } else {
+              out[o++] = toUint8((v - minHarmonics) * harmonicsQuant);
+            }
+          }
+        }
+      }
+
+      file.write(data.data(), data.size(), section.dataOffset);
+    }
+  };
+
+  const size_t hardwareThreads = std::thread::hardware_concurrency();
+  if (hardwareThreads > 1 && sections.size() > 1) {
+    ThreadPool pool(hardwareThreads);
+    pool.parallelFor(0, sections.size(), 1, encodeSections);
+  } else {
+    encodeSections(0, sections.size());
+  }
+}
+
+}  // namespace splat
@@ -27,6 +27,7 @@
 
 #include <splat/io/lod_writer.h>
 #include <splat/io/sog_writer.h>
+#include <splat/models/data-table-view.h>
 #include <splat/op/morton-order.h>
 #include <splat/spatial/btree.h>
 #include <splat/utils/threadpool.h>
@@ -148,12 +149,21 @@ static std::map<float, std::vector<uint32_t>> binIndices(BTree::BTreeNode* paren
 }
 
 void writeLod(const std::string& filename, const DataTable* dataTable, DataTable* envDataTable, bool bundle,
-              int iterations, size_t lodChunkCount, size_t lodChunkExtent) {
+              int iterations, size_t lodChunkCount, size_t lodChunkExtent, const KMeansOptions& kmeansOptions,
+              webpcodec::Preset webpPreset) {
   fs::path outputDir = fs::path(filename).parent_path();
 
   // ensure top-level output folder exists
   bool rt = fs::create_directories(outputDir);
 
+  // units are written one after another, each writeSog spreading its stages, clustering and encodes over
+  // this one pool; running units as tasks of it would park its workers on their own stage results
+#ifdef NDEBUG
+  ThreadPool pool(std::thread::hardware_concurrency());
+#else
+  ThreadPool pool(1);
+#endif
+
   // write the environment sog
   if (envDataTable && envDataTable->getNumRows() > 0) {
     fs::path pathname;
@@ -164,7 +174,7 @@ void writeLod(const std::string& filename, const DataTable* dataTable, DataTable
     }
     fs::create_directories(pathname.parent_path());
     std::cout << "writing " << pathname.string() << "..." << "\n";
-    writeSog(pathname.string(), envDataTable, bundle, iterations);
+    writeSog(pathname.string(), envDataTable, bundle, iterations, {}, kmeansOptions, webpPreset, &pool);
   }
 
   // construct a kd-tree based on centroids from all lods
@@ -282,12 +292,6 @@ void writeLod(const std::string& filename, const DataTable* dataTable, DataTable
   ofs.flush();
   ofs.close();
 
-#ifdef NDEBUG
-  ThreadPool pool(std::thread::hardware_concurrency());
-#else
-  ThreadPool pool(1);
-#endif
-
   // write file units
   for (auto&& [lodValue, fileUnits] : lodFiles) {
     for (size_t i = 0; i < fileUnits.size(); i++) {
@@ -302,30 +306,22 @@ void writeLod(const std::string& filename, const DataTable* dataTable, DataTable
         fs::create_directories(pathname.parent_path());
       }
 
-      while (pool.getQueueSize() > pool.getWorkerCount() * 2) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      size_t totalIndices =
+          std::accumulate(fileUnit.begin(), fileUnit.end(), size_t(0),
+                          [](size_t acc, const std::vector<uint32_t>& curr) { return acc + curr.size(); });
+
+      std::vector<uint32_t> indices(totalIndices, 0);
+      size_t offset = 0;
+      for (const auto& unitVec : fileUnit) {
+        std::copy(unitVec.begin(), unitVec.end(), indices.begin() + offset);
+        sortMortonOrder(dataTable, absl::Span<uint32_t>(&indices[offset], unitVec.size()));
+        offset += unitVec.size();
       }
+      fileUnit.clear();
 
-      pool.enqueue(
-          [this_path = pathname.string(), this_unit = std::move(fileUnit), dataTable, bundle, iterations]() mutable {
-            size_t totalIndices =
-                std::accumulate(this_unit.begin(), this_unit.end(), size_t(0),
-                                [](size_t acc, const std::vector<uint32_t>& curr) { return acc + curr.size(); });
-
-            std::vector<uint32_t> indices(totalIndices, 0);
-            size_t offset = 0;
-            for (const auto& unitVec : this_unit) {
-              std::copy(unitVec.begin(), unitVec.end(), indices.begin() + offset);
-              sortMortonOrder(dataTable, absl::Span<uint32_t>(&indices[offset], unitVec.size()));
-              offset += unitVec.size();
-            }
-
-            auto unitDataTable = dataTable->permuteRows(indices);
-
-            std::vector<uint32_t> writeIndices(totalIndices);
-            std::iota(writeIndices.begin(), writeIndices.end(), 0);
-            writeSog(this_path, unitDataTable.get(), bundle, iterations, writeIndices);
-          });
+      // the unit selects rows of the shared table; only the attributes being encoded get copied
+      writeSog(pathname.string(), DataTableView(*dataTable, std::move(indices)), bundle, iterations, kmeansOptions,
+               webpPreset, &pool);
     }
   }
 }
@@ -29,217 +29,690 @@
 #include <splat/models/ply.h>
 
 #include <algorithm>
+#include <charconv>
 #include <cstring>
 #include <fstream>
 #include <numeric>
-#include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
 
 #include "splat/io/decompress_ply.h"
+#include "splat/models/data-table-view.h"
 #include "splat/models/data-table.h"
+#include "splat/utils/mapped-file.h"
+#include "splat/utils/threadpool.h"
 
 namespace splat {
 
-static const std::vector<uint8_t> magicBytes = {'p', 'l', 'y', '\n'};
-static const std::vector<uint8_t> endHeaderBytes = {'\n', 'e', 'n', 'd', '_', 'h', 'e', 'a', 'd', 'e', 'r', '\n'};
+static constexpr std::string_view magicBytes = "ply\n";
+static constexpr std::string_view endHeaderBytes = "\nend_header\n";
 
-static bool cmp(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, size_t aOffset = 0) {
-  if (aOffset + b.size() > a.size()) {
-    return false;
-  }
-
-  return std::equal(b.begin(), b.end(), a.begin() + aOffset);
-}
-
-static Column createColumn(const std::string& name, ColumnType type, size_t count) {
-  switch (type) {
-    case ColumnType::INT8:
-      return {name, std::vector<uint8_t>(count)};
-    case ColumnType::UINT8:
-      return {name, std::vector<uint8_t>(count)};
-    case ColumnType::INT16:
-      return {name, std::vector<uint16_t>(count)};
-    case ColumnType::UINT16:
-      return {name, std::vector<uint16_t>(count)};
-    case ColumnType::INT32:
-      return {name, std::vector<int32_t>(count)};
-    case ColumnType::UINT32:
-      return {name, std::vector<uint32_t>(count)};
-    case ColumnType::FLOAT32:
-      return {name, std::vector<float>(count)};
-    case ColumnType::FLOAT64:
-      return {name, std::vector<double>(count)};
-  }
-  return {};
-}
+// Headers are read this many bytes at a time; real-world 3DGS headers fit in the first block.
+static constexpr size_t kHeaderBlockSize = 4096;
+static constexpr size_t kMaxHeaderSize = 128 * 1024;
 
 /**
  * @brief Maps PLY header type strings to C++ ColumnType and byte size.
  */
-static ColumnType getDataTypeMapping(const std::string& type) {
-  static const std::map<std::string, ColumnType> typeMap = {
+static ColumnType getDataTypeMapping(std::string_view type) {
+  static constexpr std::pair<std::string_view, ColumnType> typeMap[] = {
       {"char", ColumnType::INT8},       {"uchar", ColumnType::UINT8},    {"short", ColumnType::INT16},
       {"ushort", ColumnType::UINT16},   {"int", ColumnType::INT32},      {"uint", ColumnType::UINT32},
       {"float", ColumnType::FLOAT32},   {"double", ColumnType::FLOAT64}, {"float32", ColumnType::FLOAT32},
       {"float64", ColumnType::FLOAT64},
   };
-  auto it = typeMap.find(type);
-  if (it != typeMap.end()) {
-    return it->second;
+  for (const auto& [name, columnType] : typeMap) {
+    if (name == type) {
+      return columnType;
+    }
+  }
+  throw std::runtime_error("Unsupported PLY data type: " + std::string(type));
+}
+
+/**
+ * @brief Find the end of the header in the first size bytes of a file.
+ * @param from Offset to resume scanning at; bytes before it are known not to end the header
+ * @return Header size including the 'end_header' line, or 0 if the marker is not in the buffer
+ */
+static size_t findHeaderEnd(const uint8_t* data, size_t size, size_t from = 0) {
+  const uint8_t* end = data + size;
+  const uint8_t* p = data + from;
+  while (p < end && (p = static_cast<const uint8_t*>(std::memchr(p, '\n', end - p)))) {
+    if (static_cast<size_t>(end - p) < endHeaderBytes.size()) {
+      break;
+    }
+    if (std::memcmp(p, endHeaderBytes.data(), endHeaderBytes.size()) == 0) {
+      return static_cast<size_t>(p - data) + endHeaderBytes.size();
+    }
+    ++p;
   }
-  throw std::runtime_error("Unsupported PLY data type: " + type);
+  return 0;
+}
+
+/**
+ * @brief Read the header of a PLY stream a block at a time.
+ * @param[out] buffer Header bytes, followed by any data bytes the last block read past the header
+ * @return Header size in bytes
+ */
+static size_t readHeader(std::istream& file, std::vector<uint8_t>& buffer) {
+  buffer.clear();
+  size_t filled = 0;
+  while (true) {
+    const size_t scanned = filled;
+    buffer.resize(std::min(filled + kHeaderBlockSize, kMaxHeaderSize));
+    file.read(reinterpret_cast<char*>(buffer.data() + filled), static_cast<std::streamsize>(buffer.size() - filled));
+    filled += static_cast<size_t>(file.gcount());
+    buffer.resize(filled);
+
+    if (scanned < magicBytes.size()) {
+      if (filled < magicBytes.size()) {
+        throw std::runtime_error("Failed to read file header or file is too short.");
+      }
+      if (std::memcmp(buffer.data(), magicBytes.data(), magicBytes.size()) != 0) {
+        throw std::runtime_error("Invalid file header: missing 'ply'.");
+      }
+    }
+
+    // the marker may straddle the previous block
+    const size_t resume = scanned >= endHeaderBytes.size() ? scanned - endHeaderBytes.size() + 1 : 0;
+    const size_t headerSize = findHeaderEnd(buffer.data(), filled, resume);
+    if (headerSize) {
+      return headerSize;
+    }
+    if (filled >= kMaxHeaderSize) {
+      throw std::runtime_error("PLY header too large (>128KB) or missing 'end_header'.");
+    }
+    if (filled == scanned || !file) {
+      throw std::runtime_error("Failed to read file header: unexpected EOF.");
+    }
+  }
+}
+
+/**
+ * @brief Split the next whitespace separated token off the front of a header line.
+ */
+static std::string_view nextToken(std::string_view& line) {
+  static constexpr std::string_view whitespace = " \t\r\f\v";
+  const size_t begin = line.find_first_not_of(whitespace);
+  if (begin == std::string_view::npos) {
+    line = {};
+    return {};
+  }
+  const size_t end = std::min(line.find_first_of(whitespace, begin), line.size());
+  const std::string_view token = line.substr(begin, end - begin);
+  line.remove_prefix(end);
+  return token;
 }
 
 /**
  * @brief Parses the PLY header text data into structured PlyHeader components.
+ *
+ * Lines and tokens are views into data; the only allocations are the names and comments stored in
+ * the result.
+ *
  * @param data Buffer containing the PLY header text.
+ * @param size Header length in bytes.
  * @return PlyHeader The parsed header information.
  */
-static PlyHeader parseHeader(const std::vector<uint8_t>& data) {
-  // Decode header and split into lines
-  std::string headerStr(reinterpret_cast<const char*>(data.data()), data.size());
-  std::stringstream ss(headerStr);
-  std::string line;
+static PlyHeader parseHeader(const uint8_t* data, size_t size) {
+  const char* p = reinterpret_cast<const char*>(data);
+  const char* end = p + size;
 
   PlyHeader header;
+  header.dataOffset = size;
   PlyElement* currentElement = nullptr;
 
-  // skip the first line ('ply')
-  std::getline(ss, line);
+  bool firstLine = true;
+  while (p < end) {
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (!eol) {
+      eol = end;
+    }
+    std::string_view line(p, eol - p);
+    p = eol + 1;
+
+    // skip the first line ('ply')
+    if (firstLine) {
+      firstLine = false;
+      continue;
+    }
 
-  while (std::getline(ss, line)) {
     // Remove trailing carriage return if present (for cross-platform compatibility)
     if (!line.empty() && line.back() == '\r') {
-      line.pop_back();
+      line.remove_suffix(1);
     }
     if (line.empty()) continue;
 
-    std::stringstream line_ss(line);
-    std::string keyword;
-    line_ss >> keyword;
+    const std::string_view keyword = nextToken(line);
 
     if (keyword == "ply" || keyword == "format" || keyword == "end_header") {
       // skip
     } else if (keyword == "comment") {
       // Extract the rest of the line after "comment "
-      header.comments.push_back(line.substr(8));
+      if (!line.empty()) {
+        line.remove_prefix(1);
+      }
+      header.comments.emplace_back(line);
     } else if (keyword == "element") {
-      std::string name;
-      size_t count;
-      if (!(line_ss >> name >> count)) {
+      const std::string_view name = nextToken(line);
+      const std::string_view countStr = nextToken(line);
+      size_t count = 0;
+      const auto [ptr, ec] = std::from_chars(countStr.data(), countStr.data() + countStr.size(), count);
+      if (name.empty() || countStr.empty() || ec != std::errc() || ptr != countStr.data() + countStr.size()) {
         throw std::runtime_error("invalid ply header: 'element' syntax error.");
       }
-      header.elements.emplace_back(PlyElement{name, count, {}});
+      header.elements.emplace_back(PlyElement{std::string(name), count, {}});
       currentElement = &header.elements.back();
     } else if (keyword == "property") {
       if (!currentElement) {
         throw std::runtime_error("invalid ply header: 'property' outside 'element'.");
       }
-      std::string typeStr;
-      std::string name;
-
-      if (!(line_ss >> typeStr >> name)) {
+      const std::string_view typeStr = nextToken(line);
+      const std::string_view name = nextToken(line);
+      if (name.empty()) {
         throw std::runtime_error("invalid ply header: 'property' syntax error.");
       }
 
-      currentElement->properties.push_back({name, typeStr, getDataTypeMapping(typeStr)});
+      currentElement->properties.push_back({std::string(name), std::string(typeStr), getDataTypeMapping(typeStr)});
     } else {
-      throw std::runtime_error("unrecognized header value '" + keyword + "' in ply header");
+      throw std::runtime_error("unrecognized header value '" + std::string(keyword) + "' in ply header");
     }
   }
   return header;
 }
 
-std::unique_ptr<DataTable> readPly(const std::string& filename) {
-  // open the file for binary input
-  std::ifstream file(filename, std::ios::binary | std::ios::in);
-  if (!file.is_open()) {
-    throw std::runtime_error("Could not open file: " + filename);
+/**
+ * @brief Where one property of an interleaved row goes
+ */
+struct PropertyCopy {
+  size_t offset;  ///< Byte offset of the property within a row
+  size_t size;    ///< Bytes per value
+  uint8_t* dst;   ///< Column data
+};
+
+// Rows are transposed in blocks: one block of 62-float rows is ~124KB, so the strided reads of a block
+// stay in cache while every column is written sequentially.
+static constexpr size_t kTransposeBlockRows = 512;
+
+// Elements smaller than this are transposed on the calling thread.
+static constexpr size_t kParallelReadBytes = 16 * 1024 * 1024;
+
+template <size_t Size>
+static void copyStrided(const uint8_t* src, size_t stride, uint8_t* dst, size_t count) {
+  for (size_t r = 0; r < count; ++r) {
+    std::memcpy(dst + r * Size, src + r * stride, Size);
   }
+}
 
-  // read header --
-  const size_t maxHeaderSize = 128 * 1024;
-  std::vector<uint8_t> headerBuf(maxHeaderSize);
-  if (static_cast<size_t>(file.read(reinterpret_cast<char*>(headerBuf.data()), magicBytes.size()).gcount()) !=
-      magicBytes.size()) {
-    throw std::runtime_error("Failed to read file header or file is too short.");
+/**
+ * @brief Transpose rows [rowBegin, rowEnd) of an element with any mix of property types.
+ *
+ * Only the properties listed in props are copied; the bytes of the others are stepped over.
+ */
+static void transposeRows(const uint8_t* data, size_t rowSize, const std::vector<PropertyCopy>& props,
+                          size_t rowBegin, size_t rowEnd) {
+  for (size_t r0 = rowBegin; r0 < rowEnd; r0 += kTransposeBlockRows) {
+    const size_t count = std::min(kTransposeBlockRows, rowEnd - r0);
+    const uint8_t* block = data + r0 * rowSize;
+    for (const auto& prop : props) {
+      const uint8_t* src = block + prop.offset;
+      uint8_t* dst = prop.dst + r0 * prop.size;
+      switch (prop.size) {
+        case 1:
+          copyStrided<1>(src, rowSize, dst, count);
+          break;
+        case 2:
+          copyStrided<2>(src, rowSize, dst, count);
+          break;
+        case 4:
+          copyStrided<4>(src, rowSize, dst, count);
+          break;
+        default:
+          copyStrided<8>(src, rowSize, dst, count);
+          break;
+      }
+    }
   }
-  if (!cmp(headerBuf, magicBytes)) {
-    throw std::runtime_error("Invalid file header: missing 'ply'.");
+}
+
+/**
+ * @brief Transpose rows [rowBegin, rowEnd) of an element whose properties are all float32.
+ *
+ * NumFloats fixes the row width at compile time (0 = use numFloats), which lets the compiler fold the
+ * stride into the addressing of the 3DGS layouts below.
+ */
+template <size_t NumFloats>
+static void transposeFloat32(const uint8_t* data, size_t numFloats, float* const* columns, size_t rowBegin,
+                             size_t rowEnd) {
+  const size_t n = NumFloats ? NumFloats : numFloats;
+  const size_t stride = n * sizeof(float);
+  for (size_t r0 = rowBegin; r0 < rowEnd; r0 += kTransposeBlockRows) {
+    const size_t count = std::min(kTransposeBlockRows, rowEnd - r0);
+    const uint8_t* block = data + r0 * stride;
+    for (size_t c = 0; c < n; ++c) {
+      const uint8_t* src = block + c * sizeof(float);
+      float* dst = columns[c] + r0;
+      for (size_t r = 0; r < count; ++r) {
+        std::memcpy(dst + r, src + r * stride, sizeof(float));
+      }
+    }
   }
+}
 
-  size_t headerSize = magicBytes.size();
-  // Read the rest of the header until 'end_header' pattern is found
-  while (headerSize < maxHeaderSize) {
-    // read the next character
-    if (file.read(reinterpret_cast<char*>(headerBuf.data() + headerSize), 1).gcount() != 1) {
-      throw std::runtime_error("Failed to read file header: unexpected EOF.");
+/**
+ * @brief Which part of one element a read loads
+ */
+struct ElementSelection {
+  bool load = true;                ///< false steps over the whole element
+  std::vector<size_t> properties;  ///< Indices of the properties to load, in output order
+  size_t rowBegin = 0;             ///< First row to load
+  size_t rowEnd = 0;               ///< One past the last row to load
+};
+
+template <typename Elements>
+static bool hasChunkElement(const Elements& elements) {
+  return std::any_of(elements.begin(), elements.end(), [](const auto& e) { return e.name == "chunk"; });
+}
+
+/**
+ * @brief Requested property names with duplicates removed, keeping the first occurrence.
+ */
+static std::vector<std::string> uniqueProperties(const PlyReadOptions& options) {
+  std::vector<std::string> names;
+  for (const auto& name : options.properties) {
+    if (std::find(names.begin(), names.end(), name) == names.end()) {
+      names.push_back(name);
     }
-    headerSize++;
+  }
+  return names;
+}
 
-    // Check for the 'end_header' byte pattern
-    if (headerSize >= endHeaderBytes.size() && cmp(headerBuf, endHeaderBytes, headerSize - endHeaderBytes.size())) {
-      break;
+/**
+ * @brief Decide what to load of every element in the header.
+ *
+ * Files that may be compressed (they have a "chunk" element) are loaded whole: their vertex rows are
+ * packed, so the options can only be applied after decompressPly(). Otherwise only the first vertex
+ * element is loaded, restricted to the requested properties and rows.
+ */
+static std::vector<ElementSelection> selectElements(const PlyHeader& header, const PlyReadOptions& options) {
+  const bool loadAll = hasChunkElement(header.elements);
+
+  std::vector<ElementSelection> selections(header.elements.size());
+  bool vertexSeen = false;
+  for (size_t e = 0; e < header.elements.size(); ++e) {
+    const auto& element = header.elements[e];
+    auto& selection = selections[e];
+    selection.rowEnd = element.count;
+
+    const bool isVertex = !vertexSeen && element.name == "vertex";
+    vertexSeen = vertexSeen || isVertex;
+    if (!loadAll && !isVertex) {
+      selection.load = false;
+      continue;
+    }
+
+    if (loadAll || options.properties.empty()) {
+      selection.properties.resize(element.properties.size());
+      std::iota(selection.properties.begin(), selection.properties.end(), 0);
+    } else {
+      for (const auto& name : uniqueProperties(options)) {
+        auto it = std::find_if(element.properties.begin(), element.properties.end(),
+                               [&](const PlyProperty& p) { return p.name == name; });
+        if (it == element.properties.end()) {
+          throw std::runtime_error("Column not found: " + name);
+        }
+        selection.properties.push_back(static_cast<size_t>(it - element.properties.begin()));
+      }
+    }
+
+    if (!loadAll) {
+      selection.rowBegin = std::min(options.rowBegin, element.count);
+      selection.rowEnd = std::min(std::max(options.rowEnd, selection.rowBegin), element.count);
     }
   }
+  return selections;
+}
 
-  if (headerSize >= maxHeaderSize) {
-    throw std::runtime_error("PLY header too large (>128KB) or missing 'end_header'.");
+/**
+ * @brief Apply the read options to a table that was loaded whole.
+ */
+static std::unique_ptr<DataTable> applyReadOptions(std::unique_ptr<DataTable> table, const PlyReadOptions& options) {
+  const size_t numRows = table->getNumRows();
+  const size_t rowBegin = std::min(options.rowBegin, numRows);
+  const size_t rowEnd = std::min(std::max(options.rowEnd, rowBegin), numRows);
+  if (options.properties.empty() && rowBegin == 0 && rowEnd == numRows) {
+    return table;
   }
 
-  // parse header --
-  const std::vector<uint8_t> actualHeader(headerBuf.begin(), headerBuf.begin() + headerSize);
-  PlyHeader header = parseHeader(actualHeader);
+  std::vector<uint32_t> rows(rowEnd - rowBegin);
+  std::iota(rows.begin(), rows.end(), static_cast<uint32_t>(rowBegin));
+  return DataTableView(*table, std::move(rows)).materialize(uniqueProperties(options));
+}
 
-  // parse data --
-  std::vector<PlyElementData> elements;
-  for (auto& element : header.elements) {
-    std::vector<Column> columns;
-    std::vector<int> sizes;
-    std::vector<uint8_t*> buffers;
-    for (auto&& prop : element.properties) {
-      columns.emplace_back(createColumn(prop.name, prop.dataType, element.count));
-      sizes.emplace_back(columns.back().bytePreElement());
-      buffers.emplace_back(columns.back().rawPointer());
+/**
+ * @brief Allocate the selected columns of an element and describe where each comes from in a row.
+ * @param[out] props One entry per selected property, with dst pointing at row 0 of its column
+ * @return Columns of numRows rows, in selection order
+ */
+static std::vector<Column> allocateSelection(const PlyElement& element, const ElementSelection& selection,
+                                             size_t numRows, std::vector<PropertyCopy>& props) {
+  std::vector<size_t> offsets;
+  size_t offset = 0;
+  for (auto&& prop : element.properties) {
+    offsets.push_back(offset);
+    offset += columnTypeSize(prop.dataType);
+  }
+
+  // every byte is overwritten by the file data, so allocate all columns uninitialised in one arena
+  std::vector<ColumnSpec> specs;
+  for (size_t p : selection.properties) {
+    specs.push_back({element.properties[p].name, element.properties[p].dataType});
+  }
+  std::vector<Column> columns = allocateColumns(specs, numRows);
+
+  props.clear();
+  for (size_t i = 0; i < columns.size(); ++i) {
+    props.push_back({offsets[selection.properties[i]], columns[i].bytePreElement(), columns[i].rawPointer()});
+  }
+  return columns;
+}
+
+static size_t rowSizeOf(const PlyElement& element) {
+  size_t rowSize = 0;
+  for (auto&& prop : element.properties) {
+    rowSize += columnTypeSize(prop.dataType);
+  }
+  return rowSize;
+}
+
+/**
+ * @brief Sequential reader over a PLY stream: parses the header, then hands out rows in file order.
+ */
+class PlyDataStream {
+ public:
+  explicit PlyDataStream(const std::string& filename) : file_(filename, std::ios::binary | std::ios::in) {
+    if (!file_.is_open()) {
+      throw std::runtime_error("Could not open file: " + filename);
     }
+    headerSize_ = readHeader(file_, buffer_);
+    pending_ = headerSize_;
+  }
+
+  PlyHeader header() const { return parseHeader(buffer_.data(), headerSize_); }
 
-    size_t rowSize = std::reduce(sizes.begin(), sizes.end(), 0);
+  /**
+   * @brief Step over bytes without buffering them
+   */
+  void skip(size_t bytes) {
+    bytes -= takePending(nullptr, bytes);
+    if (bytes && static_cast<size_t>(file_.ignore(static_cast<std::streamsize>(bytes)).gcount()) != bytes) {
+      throw std::runtime_error("Failed to read data chunk.");
+    }
+  }
 
-    // read data in chunks of 1024 rows at a time
+  /**
+   * @brief Read the next numRows rows into columns, 1024 rows at a time
+   * @param props Destination of every wanted property, with dst pointing at the row that receives the first row
+   */
+  void readRows(size_t rowSize, size_t numRows, const std::vector<PropertyCopy>& props) {
     const size_t chunkSize = 1024;
-    const size_t numChunks = ceil(static_cast<double>(element.count) / chunkSize);
-    std::vector<uint8_t> chunkData(chunkSize * rowSize);
+    chunk_.resize(chunkSize * rowSize);
+    std::vector<PropertyCopy> chunkProps = props;
 
-    for (size_t c = 0; c < numChunks; ++c) {
-      const size_t numRows = std::min(chunkSize, element.count - c * chunkSize);
+    for (size_t rowOffset = 0; rowOffset < numRows; rowOffset += chunkSize) {
+      const size_t chunkRows = std::min(chunkSize, numRows - rowOffset);
+      read(chunk_.data(), rowSize * chunkRows);
 
-      if (!file.read(reinterpret_cast<char*>(chunkData.data()), rowSize * numRows)) {
-        throw std::runtime_error("Failed to read data chunk.");
+      // copy into column data
+      for (size_t p = 0; p < props.size(); ++p) {
+        chunkProps[p].dst = props[p].dst + rowOffset * props[p].size;
       }
+      transposeRows(chunk_.data(), rowSize, chunkProps, 0, chunkRows);
+    }
+  }
 
-      size_t offset = 0;
+ private:
+  // the last header block may have read past the header: those bytes are consumed first
+  size_t takePending(uint8_t* dst, size_t bytes) {
+    const size_t taken = std::min(bytes, buffer_.size() - pending_);
+    if (dst && taken) {
+      std::memcpy(dst, buffer_.data() + pending_, taken);
+    }
+    pending_ += taken;
+    return taken;
+  }
 
-      // read data row at a time
-      for (size_t r = 0; r < numRows; ++r) {
-        const auto rowOffset = c * chunkSize + r;
+  void read(uint8_t* dst, size_t bytes) {
+    const size_t taken = takePending(dst, bytes);
+    bytes -= taken;
+    if (bytes && static_cast<size_t>(file_.read(reinterpret_cast<char*>(dst + taken), bytes).gcount()) != bytes) {
+      throw std::runtime_error("Failed to read data chunk.");
+    }
+  }
 
-        // copy into column data
-        for (size_t p = 0; p < columns.size(); ++p) {
-          const auto s = sizes[p];
-          std::memcpy(buffers[p] + rowOffset * s, chunkData.data() + offset, s);
-          offset += s;
-        }
-      }
+  std::ifstream file_;
+  std::vector<uint8_t> buffer_;  ///< Header bytes followed by the first data bytes
+  size_t headerSize_ = 0;
+  size_t pending_ = 0;          ///< Next unconsumed byte in buffer_
+  std::vector<uint8_t> chunk_;  ///< Raw rows being transposed
+};
+
+/**
+ * @brief Fallback for files that cannot be memory mapped: read through a stream.
+ */
+static PlyData readPlyStream(const std::string& filename, const PlyReadOptions& options) {
+  PlyDataStream stream(filename);
+  PlyHeader header = stream.header();
+  const std::vector<ElementSelection> selections = selectElements(header, options);
+
+  // parse data --
+  std::vector<PlyElementData> elements;
+  for (size_t e = 0; e < header.elements.size(); ++e) {
+    const auto& element = header.elements[e];
+    const auto& selection = selections[e];
+    const size_t rowSize = rowSizeOf(element);
+    if (!selection.load) {
+      stream.skip(rowSize * element.count);
+      continue;
     }
-    elements.push_back({element.name, std::make_unique<DataTable>(columns)});
+
+    std::vector<PropertyCopy> props;
+    const size_t numRows = selection.rowEnd - selection.rowBegin;
+    std::vector<Column> columns = allocateSelection(element, selection, numRows, props);
+
+    stream.skip(rowSize * selection.rowBegin);
+    stream.readRows(rowSize, numRows, props);
+    stream.skip(rowSize * (element.count - selection.rowEnd));
+    elements.push_back({element.name, std::make_unique<DataTable>(std::move(columns))});
   }
 
   PlyData plyData;
   plyData.comments = std::move(header.comments);
   plyData.elements = std::move(elements);
+  return plyData;
+}
+
+/**
+ * @brief Transpose rows [0, count) of an interleaved element straight out of the mapping into its columns.
+ * @param allFloat Every property is float32 and all of them are selected, in file order
+ */
+static void transposeElement(const uint8_t* data, size_t count, size_t rowSize, const std::vector<PropertyCopy>& props,
+                             bool allFloat, ThreadPool* pool) {
+  std::vector<float*> floatColumns;
+  for (const auto& prop : props) {
+    floatColumns.push_back(reinterpret_cast<float*>(prop.dst));
+  }
+
+  const size_t numFloats = props.size();
+  auto run = [&](size_t lo, size_t hi) {
+    if (!allFloat) {
+      transposeRows(data, rowSize, props, lo, hi);
+    } else if (numFloats == 62) {
+      // 3DGS with normals and degree 3 SH: xyz, nxyz, f_dc 3, f_rest 45, opacity, scale 3, rot 4
+      transposeFloat32<62>(data, numFloats, floatColumns.data(), lo, hi);
+    } else if (numFloats == 59) {
+      // the same without normals
+      transposeFloat32<59>(data, numFloats, floatColumns.data(), lo, hi);
+    } else {
+      transposeFloat32<0>(data, numFloats, floatColumns.data(), lo, hi);
+    }
+  };
+
+  if (!pool || count * rowSize < kParallelReadBytes) {
+    run(0, count);
+    return;
+  }
+
+  // a few chunks per worker so page faults on the mapping overlap; chunks are whole blocks
+  const size_t chunks = pool->getWorkerCount() * 4;
+  size_t grain = (count + chunks - 1) / chunks;
+  grain = (grain + kTransposeBlockRows - 1) / kTransposeBlockRows * kTransposeBlockRows;
+  pool->parallelFor(0, count, grain, run);
+}
+
+/**
+ * @brief Read the selected elements of a memory mapped PLY file; the only copy is the row-to-column transpose.
+ */
+static PlyData readPlyMapped(const MappedFile& file, const PlyReadOptions& options) {
+  const uint8_t* data = file.data();
+  const size_t size = file.size();
+
+  // locate header --
+  if (size < magicBytes.size()) {
+    throw std::runtime_error("Failed to read file header or file is too short.");
+  }
+  if (std::memcmp(data, magicBytes.data(), magicBytes.size()) != 0) {
+    throw std::runtime_error("Invalid file header: missing 'ply'.");
+  }
+
+  const size_t headerSize = findHeaderEnd(data, std::min(size, kMaxHeaderSize));
+  if (!headerSize) {
+    if (size < kMaxHeaderSize) {
+      throw std::runtime_error("Failed to read file header: unexpected EOF.");
+    }
+    throw std::runtime_error("PLY header too large (>128KB) or missing 'end_header'.");
+  }
+
+  // parse header --
+  PlyHeader header = parseHeader(data, headerSize);
+  const std::vector<ElementSelection> selections = selectElements(header, options);
+
+  std::unique_ptr<ThreadPool> pool;
+  const size_t hardwareThreads = std::thread::hardware_concurrency();
+  if (hardwareThreads > 1 && size - headerSize >= kParallelReadBytes) {
+    pool = std::make_unique<ThreadPool>(hardwareThreads);
+  }
+
+  // parse data --
+  std::vector<PlyElementData> elements;
+  size_t offset = headerSize;
+  for (size_t e = 0; e < header.elements.size(); ++e) {
+    const auto& element = header.elements[e];
+    const auto& selection = selections[e];
+    const size_t rowSize = rowSizeOf(element);
+    const size_t elementSize = rowSize * element.count;
+    if (elementSize > size - offset) {
+      throw std::runtime_error("Failed to read data chunk.");
+    }
+    if (!selection.load) {
+      offset += elementSize;
+      continue;
+    }
+
+    std::vector<PropertyCopy> props;
+    const size_t numRows = selection.rowEnd - selection.rowBegin;
+    std::vector<Column> columns = allocateSelection(element, selection, numRows, props);
+
+    bool allFloat = selection.properties.size() == element.properties.size();
+    for (size_t i = 0; allFloat && i < selection.properties.size(); ++i) {
+      allFloat = selection.properties[i] == i && element.properties[i].dataType == ColumnType::FLOAT32;
+    }
+
+    // only the selected rows are touched, so only their pages are faulted in
+    const size_t rowsOffset = offset + selection.rowBegin * rowSize;
+    file.adviseSequential(rowsOffset, numRows * rowSize);
+    transposeElement(data + rowsOffset, numRows, rowSize, props, allFloat, pool.get());
+    offset += elementSize;
+
+    elements.push_back({element.name, std::make_unique<DataTable>(std::move(columns))});
+  }
+
+  PlyData plyData;
+  plyData.comments = std::move(header.comments);
+  plyData.elements = std::move(elements);
+  return plyData;
+}
+
+PlyHeader probePly(const std::string& filename) { return PlyDataStream(filename).header(); }
+
+void readPlyBatches(const std::string& filename, size_t batchRows, const PlyBatchCallback& callback,
+                    const PlyReadOptions& options) {
+  if (batchRows == 0) {
+    throw std::invalid_argument("readPlyBatches: batchRows must be positive");
+  }
+
+  PlyDataStream stream(filename);
+  const PlyHeader header = stream.header();
+
+  // compressed rows are decoded against their chunk element, so such files are read whole and sliced
+  if (hasChunkElement(header.elements)) {
+    const auto table = readPly(filename, options);
+    for (size_t first = 0; first < table->getNumRows(); first += batchRows) {
+      std::vector<uint32_t> rows(std::min(batchRows, table->getNumRows() - first));
+      std::iota(rows.begin(), rows.end(), static_cast<uint32_t>(first));
+      auto batch = DataTableView(*table, std::move(rows)).materialize();
+      if (!callback(*batch, options.rowBegin + first)) {
+        return;
+      }
+    }
+    return;
+  }
+
+  const std::vector<ElementSelection> selections = selectElements(header, options);
+  for (size_t e = 0; e < header.elements.size(); ++e) {
+    const auto& element = header.elements[e];
+    const auto& selection = selections[e];
+    const size_t rowSize = rowSizeOf(element);
+    if (!selection.load) {
+      stream.skip(rowSize * element.count);
+      continue;
+    }
+
+    // one batch table is reused for every full batch; only a shorter last batch gets its own
+    std::unique_ptr<DataTable> batch;
+    std::vector<PropertyCopy> props;
+    stream.skip(rowSize * selection.rowBegin);
+    for (size_t first = selection.rowBegin; first < selection.rowEnd; first += batchRows) {
+      const size_t numRows = std::min(batchRows, selection.rowEnd - first);
+      if (!batch || batch->getNumRows() != numRows) {
+        batch = std::make_unique<DataTable>(allocateSelection(element, selection, numRows, props));
+      }
+      stream.readRows(rowSize, numRows, props);
+      if (!callback(*batch, first)) {
+        return;
+      }
+    }
+
+    // selectElements loads the vertex element only, so nothing after it is needed
+    return;
+  }
+
+  throw std::runtime_error("PLY file does not contain vertex element");
+}
+
+std::unique_ptr<DataTable> readPly(const std::string& filename, const PlyReadOptions& options) {
+  // map the file when possible, fall back to streaming it otherwise (pipes, special files)
+  std::unique_ptr<MappedFile> mapped;
+  try {
+    mapped = std::make_unique<MappedFile>(filename);
+  } catch (const std::runtime_error&) {
+  }
+
+  PlyData plyData = mapped ? readPlyMapped(*mapped, options) : readPlyStream(filename, options);
 
   if (isCompressedPly(&plyData)) {
-    return decompressPly(&plyData);
+    return applyReadOptions(decompressPly(&plyData), options);
   }
 
   auto it = std::find_if(plyData.elements.begin(), plyData.elements.end(),
@@ -248,6 +721,10 @@ std::unique_ptr<DataTable> readPly(const std::string& filename) {
     throw std::runtime_error("PLY file does not contain vertex element");
   }
 
+  // without a chunk element the readers already applied the options (see selectElements)
+  if (hasChunkElement(plyData.elements)) {
+    return applyReadOptions(std::move(it->dataTable), options);
+  }
   return std::move(it->dataTable);
 }
 
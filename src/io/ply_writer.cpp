@@ -26,10 +26,16 @@
  ***********************************************************************************/
 
 #include <splat/io/ply_writer.h>
+#include <splat/utils/output-file.h>
+#include <splat/utils/threadpool.h>
 
+#include <algorithm>
 #include <cstring>
-#include <fstream>
-#include <numeric>
+#include <future>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 namespace splat {
@@ -57,70 +63,186 @@ static std::string columnTypeToPlyType(ColumnType type) {
   }
 }
 
-void writePly(const std::string& filename, const PlyData& plyData) {
+// Rows are interleaved into staging buffers of about this size; one is written while the next is filled.
+static constexpr size_t kStagingBytes = 16 * 1024 * 1024;
+
+// Elements smaller than this are interleaved on the calling thread.
+static constexpr size_t kParallelWriteBytes = 16 * 1024 * 1024;
+
+// Rows per interleave block: the strided writes of a block stay in cache while each column is read
+// sequentially.
+static constexpr size_t kInterleaveBlockRows = 512;
+
+/**
+ * @brief Staging buffer aligned for direct writes
+ */
+struct AlignedBufferDeleter {
+  void operator()(uint8_t* p) const { ::operator delete[](p, std::align_val_t(OutputFile::kDirectAlignment)); }
+};
+using StagingBuffer = std::unique_ptr<uint8_t[], AlignedBufferDeleter>;
+
+static StagingBuffer allocateStaging(size_t bytes) {
+  return StagingBuffer(new (std::align_val_t(OutputFile::kDirectAlignment)) uint8_t[bytes]);
+}
+
+template <size_t Size>
+static void scatterStrided(const uint8_t* src, uint8_t* dst, size_t stride, size_t count) {
+  for (size_t r = 0; r < count; ++r) {
+    std::memcpy(dst + r * stride, src + r * Size, Size);
+  }
+}
+
+/**
+ * @brief Interleave rows [rowBegin, rowEnd) of the columns into dst, which receives row rowBegin first.
+ */
+static void interleaveRows(const std::vector<Column>& columns, size_t rowSize, uint8_t* dst, size_t rowBegin,
+                           size_t rowEnd) {
+  for (size_t r0 = rowBegin; r0 < rowEnd; r0 += kInterleaveBlockRows) {
+    const size_t count = std::min(kInterleaveBlockRows, rowEnd - r0);
+    uint8_t* block = dst + (r0 - rowBegin) * rowSize;
+    size_t offset = 0;
+    for (const auto& column : columns) {
+      const size_t size = column.bytePreElement();
+      const uint8_t* src = column.rawPointer() + r0 * size;
+      switch (size) {
+        case 1:
+          scatterStrided<1>(src, block + offset, rowSize, count);
+          break;
+        case 2:
+          scatterStrided<2>(src, block + offset, rowSize, count);
+          break;
+        case 4:
+          scatterStrided<4>(src, block + offset, rowSize, count);
+          break;
+        default:
+          scatterStrided<8>(src, block + offset, rowSize, count);
+          break;
+      }
+      offset += size;
+    }
+  }
+}
+
+void writePly(const std::string& filename, const PlyData& plyData, const PlyWriteOptions& options) {
   // header strings
-  std::vector<std::string> header;
-  header.emplace_back("ply");
-  header.emplace_back("format binary_little_endian 1.0");
+  std::string header = "ply\nformat binary_little_endian 1.0\n";
   for (auto&& c : plyData.comments) {
-    header.emplace_back("comment " + c);
+    header += "comment " + c + "\n";
   }
+  size_t maxRowSize = 0;
+  uint64_t fileSize = 0;
   for (auto&& element : plyData.elements) {
-    header.emplace_back("element " + element.name + " " + std::to_string(element.dataTable->getNumRows()));
+    header += "element " + element.name + " " + std::to_string(element.dataTable->getNumRows()) + "\n";
+    size_t rowSize = 0;
     for (auto&& column : element.dataTable->columns) {
-      header.emplace_back("property " + columnTypeToPlyType(column.getType()) + " " + column.name);
+      header += "property " + columnTypeToPlyType(column.getType()) + " " + column.name + "\n";
+      rowSize += column.bytePreElement();
     }
+    maxRowSize = std::max(maxRowSize, rowSize);
+    fileSize += static_cast<uint64_t>(rowSize) * element.dataTable->getNumRows();
   }
-  header.emplace_back("end_header");
+  header += "end_header\n";
+  fileSize += header.size();
 
-  std::ofstream ofs(filename, std::ios::binary | std::ios::out);
-  if (!ofs.is_open()) {
-    throw std::runtime_error("Could not open file for writing");
-  }
+  OutputFile file(filename, options.directIO);
+  const size_t alignment = file.direct() ? OutputFile::kDirectAlignment : 1;
+
+  // Two staging buffers: rows are interleaved into one while the I/O thread writes the other. Direct
+  // writes must be whole aligned blocks, so the unaligned tail of each buffer is carried into the next.
+  // The capacity is a whole number of blocks so padding the final block never runs past the end.
+  constexpr size_t kBlock = OutputFile::kDirectAlignment;
+  const size_t capacity = (std::max(kStagingBytes, header.size()) + maxRowSize + kBlock - 1) / kBlock * kBlock + kBlock;
+  StagingBuffer buffers[2] = {allocateStaging(capacity), allocateStaging(capacity)};
+  std::future<void> pending[2];
+  size_t current = 0;
+  size_t fill = 0;
+  uint64_t offset = 0;
 
-  // write the header
-  for (const auto& h : header) {
-    ofs << h << "\n";
+  std::unique_ptr<ThreadPool> pool;
+  const size_t hardwareThreads = std::thread::hardware_concurrency();
+  if (hardwareThreads > 1 && fileSize >= kParallelWriteBytes) {
+    pool = std::make_unique<ThreadPool>(hardwareThreads);
   }
-  ofs.flush();
+  // declared last so it is joined before the buffers and the file it writes go away
+  ThreadPool io(1);
 
-  for (size_t i = 0; i < plyData.elements.size(); ++i) {
-    const auto& table = plyData.elements[i].dataTable;
-    const auto& columns = table->columns;
-    std::vector<const uint8_t*> buffers;
-    std::vector<size_t> sizes;
-    for (const auto& column : columns) {
-      sizes.push_back(column.bytePreElement());
-      buffers.push_back(column.rawPointer());
+  auto flush = [&](bool last) {
+    size_t length = fill / alignment * alignment;
+    if (last && length < fill) {
+      // pad the final block; truncate() cuts the file back to its real size
+      length += alignment;
+      std::memset(buffers[current].get() + fill, 0, length - fill);
     }
-    std::size_t rowSize = std::reduce(sizes.begin(), sizes.end(), size_t{0});
 
-    // write to file in chunks of 1024 rows
-    const size_t chunkSize = 1024;
-    const size_t numChunks = ceil(static_cast<double>(table->getNumRows()) / chunkSize);
-    std::vector<uint8_t> chunkData(chunkSize * rowSize);
+    const size_t next = current ^ 1;
+    if (pending[next].valid()) {
+      pending[next].get();
+    }
+    const size_t carry = fill > length ? fill - length : 0;
+    std::memcpy(buffers[next].get(), buffers[current].get() + length, carry);
 
-    for (size_t c = 0; c < numChunks; ++c) {
-      const auto numRows = std::min(chunkSize, table->getNumRows() - c * chunkSize);
+    const uint8_t* data = buffers[current].get();
+    pending[current] = io.enqueue([&file, data, length, offset] { file.write(data, length, offset); });
+    offset += length;
+    current = next;
+    fill = carry;
+  };
 
-      size_t offset = 0;
+  try {
+    std::memcpy(buffers[current].get(), header.data(), header.size());
+    fill = header.size();
+
+    for (const auto& element : plyData.elements) {
+      const auto& columns = element.dataTable->columns;
+      const size_t numRows = element.dataTable->getNumRows();
+      size_t rowSize = 0;
+      for (const auto& column : columns) {
+        rowSize += column.bytePreElement();
+      }
+      if (rowSize == 0) {
+        continue;
+      }
 
-      for (size_t r = 0; r < numRows; ++r) {
-        const auto rowOffset = c * chunkSize + r;
+      for (size_t row = 0; row < numRows;) {
+        const size_t count = std::min(numRows - row, (capacity - fill) / rowSize);
+        uint8_t* dst = buffers[current].get() + fill;
+        auto run = [&](size_t lo, size_t hi) { interleaveRows(columns, rowSize, dst + (lo - row) * rowSize, lo, hi); };
+        if (pool && count * rowSize >= kParallelWriteBytes / 4) {
+          const size_t chunks = pool->getWorkerCount() * 4;
+          size_t grain = (count + chunks - 1) / chunks;
+          grain = (grain + kInterleaveBlockRows - 1) / kInterleaveBlockRows * kInterleaveBlockRows;
+          pool->parallelFor(row, row + count, grain, run);
+        } else {
+          run(row, row + count);
+        }
+        fill += count * rowSize;
+        row += count;
 
-        for (size_t p = 0; p < columns.size(); ++p) {
-          const auto s = sizes[p];
-          memcpy(chunkData.data() + offset, buffers[p] + rowOffset * s, s);
-          offset += s;
+        if (capacity - fill < rowSize) {
+          flush(false);
         }
       }
+    }
+    flush(true);
 
-      // write the chunk
-      ofs.write(reinterpret_cast<const char*>(chunkData.data()), numRows * rowSize);
-      ofs.flush();
+    for (auto& write : pending) {
+      if (write.valid()) {
+        write.get();
+      }
     }
+  } catch (...) {
+    // no write may still reference the buffers when they are released
+    for (auto& write : pending) {
+      if (write.valid()) {
+        write.wait();
+      }
+    }
+    throw;
+  }
+
+  if (offset != fileSize) {
+    file.truncate(fileSize);
   }
-  ofs.close();
 }
 
 }  // namespace splat
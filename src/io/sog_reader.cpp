@@ -29,41 +29,27 @@
 #include <absl/strings/match.h>
 #include <splat/io/sog_reader.h>
 #include <splat/models/sog.h>
+#include <splat/utils/mapped-file.h>
+#include <splat/utils/threadpool.h>
 #include <splat/utils/webp-codec.h>
 #include <splat/utils/zip-reader.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
-#include <iostream>
+#include <deque>
+#include <filesystem>
+#include <future>
 #include <map>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace splat {
 
-static std::array<std::vector<uint16_t>, 3> decodeMeans(const std::vector<uint8_t>& lo, const std::vector<uint8_t>& hi,
-                                                        size_t count) {
-  std::vector<uint16_t> xs(count, 0);
-  for (size_t i = 0; i < count; i++) {
-    const auto o = i * 4;
-    xs[i] = static_cast<uint16_t>(lo[o + 0] | (hi[o + 1] << 8));
-  }
-  std::vector<uint16_t> ys(count, 0);
-  for (size_t i = 0; i < count; i++) {
-    const auto o = i * 4;
-    ys[i] = static_cast<uint16_t>(lo[o + 2] | (hi[o + 3] << 8));
-  }
-  std::vector<uint16_t> zs(count, 0);
-  for (size_t i = 0; i < count; i++) {
-    const auto o = i * 4;
-    zs[i] = static_cast<uint16_t>(lo[o + 4] | (hi[o + 5] << 8));
-  }
-  return {xs, ys, zs};
-}
-
 static float invLogTransform(float v) {
   const float a = fabs(v);
   const float e = exp(a) - 1;
@@ -99,238 +85,361 @@ static inline float sigmoidInv(float y) {
   return log(e / (1.0 - e));
 }
 
-std::unique_ptr<DataTable> readSog(const std::string& file, const std::string& sourceName) {
-  std::map<std::string, std::vector<uint8_t>> entries;
-  const std::string lowerName = absl::AsciiStrToLower(sourceName);
-  if (absl::EndsWith(lowerName, ".sog")) {
-    ZipReader zr(file);
-    const auto list = zr.list();
-    for (const auto& e : list) {
-      entries.insert({e.name, e.readData()});
+namespace {
+
+/// Bytes of one SOG entry, pointing into a mapping or into storage owned by the SogSource
+struct EntryBytes {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+/// Decoded RGBA pixels of one texture
+struct Texture {
+  std::unique_ptr<uint8_t[]> rgba;
+  int width = 0;
+  int height = 0;
+};
+
+/**
+ * @brief Resolves SOG entry names to their bytes
+ *
+ * Bundles are mapped once and entries are handed out as ranges of the mapping; stored (uncompressed)
+ * ZIP entries need no further copy. Unbundled entries are mapped file by file. Streams are only used
+ * where mapping fails. Entries are loaded on first request, so unused ones are never read.
+ */
+class SogSource {
+ public:
+  SogSource(const std::string& file, const std::string& sourceName) {
+    if (absl::EndsWith(absl::AsciiStrToLower(sourceName), ".sog")) {
+      // the entries' stream readers refer to the ZipReader, so it stays alive (and in place) with the source
+      zipReader_ = std::make_unique<ZipReader>(file);
+      for (auto& entry : zipReader_->list()) {
+        zipEntries_.emplace(entry.name, std::move(entry));
+      }
+      try {
+        bundle_ = std::make_unique<MappedFile>(file);
+      } catch (const std::runtime_error&) {
+      }
+    } else {
+      // sourceName names the directory holding the entries, or its meta.json
+      directory_ = sourceName;
+      if (directory_.filename() == "meta.json") {
+        directory_ = directory_.parent_path();
+      }
     }
   }
 
-  auto load = [&](const std::string& name) -> std::vector<uint8_t> {
-    if (entries.count(name)) {
-      return entries[name];
+  EntryBytes load(const std::string& name) {
+    if (zipReader_) {
+      auto it = zipEntries_.find(name);
+      if (it == zipEntries_.end()) {
+        throw std::runtime_error("SOG bundle has no entry: " + name);
+      }
+      const ZipEntry& entry = it->second;
+      if (bundle_) {
+        if (entry.offset > bundle_->size() || entry.size > bundle_->size() - entry.offset) {
+          throw std::runtime_error("SOG bundle entry out of range: " + name);
+        }
+        return {bundle_->data() + entry.offset, entry.size};
+      }
+      return own(entry.readData());
     }
 
-    std::filesystem::path fullPath;
-    if (sourceName.empty()) {
-      fullPath = name;
-    } else {
-      fullPath = std::filesystem::path(sourceName) / name;
+    const std::filesystem::path fullPath = directory_.empty() ? std::filesystem::path(name) : directory_ / name;
+    try {
+      files_.push_back(std::make_unique<MappedFile>(fullPath.string()));
+      return {files_.back()->data(), files_.back()->size()};
+    } catch (const std::runtime_error&) {
     }
 
     std::ifstream f(fullPath, std::ios::binary | std::ios::ate);
     if (!f.is_open()) {
       throw std::runtime_error("Could not open file: " + fullPath.string());
     }
-
-    try {
-      std::streamsize size = f.tellg();
-      f.seekg(0, std::ios::beg);
-      std::vector<uint8_t> buffer(size);
-      if (f.read(reinterpret_cast<char*>(buffer.data()), size)) {
-        f.close();
-        return buffer;
-      } else {
-        f.close();
-        throw std::runtime_error("Could not read file: " + fullPath.string());
-      }
-    } catch (const std::exception& e) {
-      std::cerr << e.what() << '\n';
+    std::vector<uint8_t> buffer(static_cast<size_t>(f.tellg()));
+    f.seekg(0, std::ios::beg);
+    if (!f.read(reinterpret_cast<char*>(buffer.data()), buffer.size())) {
+      throw std::runtime_error("Could not read file: " + fullPath.string());
     }
-    return {};
-  };
+    return own(std::move(buffer));
+  }
+
+ private:
+  EntryBytes own(std::vector<uint8_t> bytes) {
+    owned_.push_back(std::move(bytes));
+    return {owned_.back().data(), owned_.back().size()};
+  }
+
+  std::map<std::string, ZipEntry> zipEntries_;
+  std::unique_ptr<ZipReader> zipReader_;
+  std::unique_ptr<MappedFile> bundle_;
+  std::filesystem::path directory_;
+  std::vector<std::unique_ptr<MappedFile>> files_;
+  std::deque<std::vector<uint8_t>> owned_;
+};
+
+}  // namespace
+
+static Texture decodeTexture(const EntryBytes& bytes) {
+  Texture texture;
+  std::tie(texture.width, texture.height) = webpcodec::getDimensions(bytes.data, bytes.size);
+  const size_t size = static_cast<size_t>(texture.width) * texture.height * 4;
+  texture.rgba.reset(new uint8_t[size]);
+  webpcodec::decodeRGBAInto(bytes.data, bytes.size, texture.rgba.get(), size, texture.width * 4);
+  return texture;
+}
+
+std::unique_ptr<DataTable> readSog(const std::string& file, const std::string& sourceName,
+                                   const SogReadOptions& options) {
+  SogSource source(file, sourceName);
 
   // meta.json
-  const auto metaBytes = load("meta.json");
-  const auto meta = Meta::parseFromJson(metaBytes);
+  const EntryBytes metaBytes = source.load("meta.json");
+  const auto meta = Meta::parseFromJson(std::vector<uint8_t>(metaBytes.data, metaBytes.data + metaBytes.size));
   const int count = meta.count;
 
-  std::vector<Column> columns = {// Position
-                                 {"x", std::vector<float>(count, 0.0f)},
-                                 {"y", std::vector<float>(count, 0.0f)},
-                                 {"z", std::vector<float>(count, 0.0f)},
-
-                                 // Scale (stored as linear in .splat, convert to log for internal use)
-                                 {"scale_0", std::vector<float>(count, 0.0f)},
-                                 {"scale_1", std::vector<float>(count, 0.0f)},
-                                 {"scale_2", std::vector<float>(count, 0.0f)},
-
-                                 // Color/opacity
-                                 {"f_dc_0", std::vector<float>(count, 0.0f)},  // Red
-                                 {"f_dc_1", std::vector<float>(count, 0.0f)},  // Green
-                                 {"f_dc_2", std::vector<float>(count, 0.0f)},  // Blue
-                                 {"opacity", std::vector<float>(count, 0.0f)},
-
-                                 // Rotation quaternion
-                                 {"rot_0", std::vector<float>(count, 0.0f)},
-                                 {"rot_1", std::vector<float>(count, 0.0f)},
-                                 {"rot_2", std::vector<float>(count, 0.0f)},
-                                 {"rot_3", std::vector<float>(count, 0.0f)}};
-
-  // Prepare output columns
-  auto& xCol = columns[0];
-  auto& yCol = columns[1];
-  auto& zCol = columns[2];
-
-  auto& scale0Col = columns[3];
-  auto& scale1Col = columns[4];
-  auto& scale2Col = columns[5];
-
-  auto& dc0 = columns[6];
-  auto& dc1 = columns[7];
-  auto& dc2 = columns[8];
-
-  auto& opCol = columns[9];
-
-  auto& r0 = columns[10];
-  auto& r1 = columns[11];
-  auto& r2 = columns[12];
-  auto& r3 = columns[13];
-
-  // means: two textures means_l and means_u
-  const auto meansLoWebp = load(meta.means.files[0]);
-  const auto meansHiWebp = load(meta.means.files[1]);
-  const auto& [lo, width, height] = webpcodec::decodeRGBA(meansHiWebp);
-  const auto& [hi, _hw, _hh] = webpcodec::decodeRGBA(meansLoWebp);
-  const auto total = width * height;
-  if (total < count) {
-    throw std::runtime_error("SOG means texture too small for count");
+  auto wanted = [&](SogAttribute group) {
+    return options.attributes.empty() ||
+           std::find(options.attributes.begin(), options.attributes.end(), group) != options.attributes.end();
+  };
+  const bool wantMeans = wanted(SogAttribute::Means);
+  const bool wantQuats = wanted(SogAttribute::Quats);
+  const bool wantScales = wanted(SogAttribute::Scales);
+  const bool wantColor = wanted(SogAttribute::Color);
+
+  static std::array<int, 4> bandItems = {0, 3, 8, 15};
+  const int shCoffs = meta.shN.has_value() && wanted(SogAttribute::ShN) ? bandItems[meta.shN->bands] : 0;
+
+  std::vector<ColumnSpec> specs;
+  auto addColumns = [&](bool add, std::initializer_list<const char*> names) {
+    for (const char* name : names) {
+      if (add) specs.push_back({name, ColumnType::FLOAT32});
+    }
+  };
+  // Position
+  addColumns(wantMeans, {"x", "y", "z"});
+  // Scale (stored as linear in .splat, convert to log for internal use)
+  addColumns(wantScales, {"scale_0", "scale_1", "scale_2"});
+  // Color/opacity
+  addColumns(wantColor, {"f_dc_0", "f_dc_1", "f_dc_2", "opacity"});
+  // Rotation quaternion
+  addColumns(wantQuats, {"rot_0", "rot_1", "rot_2", "rot_3"});
+  for (int i = 0; i < shCoffs * 3; ++i) {
+    specs.push_back({"f_rest_" + std::to_string(i), ColumnType::FLOAT32});
   }
-  const auto mins = meta.means.mins;
-  const auto maxs = meta.means.maxs;
-  const auto& [xs, ys, zs] = decodeMeans(lo, hi, count);
-
-  const auto xMin = mins[0];
-  const auto xScale = (maxs[0] - mins[0]) || 1;
-  const auto yMin = mins[1];
-  const auto yScale = (maxs[1] - mins[1]) || 1;
-  const auto zMin = mins[2];
-  const auto zScale = (maxs[2] - mins[2]) || 1;
-
-  for (int i = 0; i < count; ++i) {
-    const auto lx = xMin + xScale * (xs[i] / 65535.0f);
-    const auto ly = yMin + yScale * (ys[i] / 65535.0f);
-    const auto lz = zMin + zScale * (zs[i] / 65535.0f);
-    xCol.setValue<float>(i, invLogTransform(lx));
-    yCol.setValue<float>(i, invLogTransform(ly));
-    zCol.setValue<float>(i, invLogTransform(lz));
+  // only ShN can be missing, so this is a request for nothing but higher SH bands the file does not have
+  if (specs.empty()) {
+    throw std::runtime_error("requested SOG attribute groups are not present in " + file);
   }
 
-  // quats
-  const auto quatsWebp = load(meta.quats.files[0]);
-  const auto& [qr, qw, qh] = webpcodec::decodeRGBA(quatsWebp);
-  if (qw * qh < count) {
-    throw std::runtime_error("SOG quats texture too small for count");
-  }
+  // every element of every column is written below
+  std::vector<Column> columns = allocateColumns(specs, count);
+  auto column = [&](const std::string& name) {
+    const auto it = std::find_if(specs.begin(), specs.end(), [&](const ColumnSpec& spec) { return spec.name == name; });
+    return columns[it - specs.begin()].asSpan<float>().data();
+  };
 
-  for (int i = 0; i < count; ++i) {
-    const auto o = i * 4;
-    const auto tag = qr[o + 3];
-    if (tag < 252) {
-      r0.setValue(i, 0.0f);
-      r1.setValue(i, 0.0f);
-      r2.setValue(i, 0.0f);
-      r3.setValue(i, 1.0f);
-      continue;
-    }
-    const auto [x, y, z, wq] = unpackQuat(qr[o], qr[o + 1], qr[o + 2], tag);
-    r0.setValue<float>(i, x);
-    r1.setValue<float>(i, y);
-    r2.setValue<float>(i, z);
-    r3.setValue<float>(i, wq);
+  // Every texture decodes as its own task and every attribute group converts as a task queued after all
+  // decodes. The queue is FIFO, so a conversion only ever waits on decodes that are running or done.
+  const size_t hardwareThreads = std::thread::hardware_concurrency();
+  std::unique_ptr<ThreadPool> pool;
+  if (hardwareThreads > 1) {
+    pool = std::make_unique<ThreadPool>(hardwareThreads);
   }
 
-  // scales: labels + codebook
-  const auto scalesWebp = load(meta.scales.files[0]);
-  const auto& [sl, sw, sh] = webpcodec::decodeRGBA(scalesWebp);
-  if (sw * sh < count) {
-    throw std::runtime_error("SOG scales texture too small for count");
-  }
-  const auto sCode = meta.scales.codebook;
+  // without a pool every task runs, in order, when its result is first needed
+  auto launch = [&](auto fn) -> std::future<decltype(fn())> {
+    if (pool) {
+      return pool->enqueue(std::move(fn));
+    }
+    return std::async(std::launch::deferred, std::move(fn));
+  };
 
-  for (int i = 0; i < count; ++i) {
-    const auto o = i * 4;
-    scale0Col.setValue<float>(i, sCode[sl[o]]);
-    scale1Col.setValue<float>(i, sCode[sl[o + 1]]);
-    scale2Col.setValue<float>(i, sCode[sl[o + 2]]);
-  }
+  // entries are resolved on this thread; only decoding is spread out
+  auto decode = [&](const std::string& name) {
+    const EntryBytes bytes = source.load(name);
+    return launch([bytes] { return decodeTexture(bytes); });
+  };
 
-  // colors + opacity: sh0.webp encodes 3 labels + opacity byte
-  const auto sh0Webp = load(meta.sh0.files[0]);
-  const auto& [c0, cw, ch] = webpcodec::decodeRGBA(sh0Webp);
-  if (cw * ch < count) {
-    throw std::runtime_error("SOG sh0 texture too small for count");
-  }
-  const auto cCode = meta.sh0.codebook;
-
-  for (int i = 0; i < count; i++) {
-    const auto o = i * 4;
-    dc0.setValue<float>(i, cCode[c0[o + 0]]);
-    dc1.setValue<float>(i, cCode[c0[o + 1]]);
-    dc2.setValue<float>(i, cCode[c0[o + 2]]);
-    opCol.setValue<float>(i, sigmoidInv(c0[o + 3] / 255.0f));
-  }
+  auto checkSize = [&](const Texture& texture, const char* what) {
+    if (static_cast<int64_t>(texture.width) * texture.height < count) {
+      throw std::runtime_error(std::string("SOG ") + what + " texture too small for count");
+    }
+  };
 
-  // Note: If present, SH higher bands (shN) are reconstructed into columns below.
-  // Higher-order SH (optional)
-  if (meta.shN.has_value()) {
-    auto bands = meta.shN->bands;
-    auto paletteCount = meta.shN->count;
-    static std::array<int, 4> bandItems = {0, 3, 8, 15};
-    const int shCoffs = bandItems[bands];
+  std::vector<std::future<void>> conversions;
+  try {
+    // only the entries of the requested groups are loaded
+    std::future<Texture> meansLoFuture, meansHiFuture, quatsFuture, scalesFuture, sh0Future;
+    std::future<Texture> centroidsFuture, labelsFuture;
+    if (wantMeans) {
+      // means: two textures means_l and means_u
+      meansLoFuture = decode(meta.means.files[0]);
+      meansHiFuture = decode(meta.means.files[1]);
+    }
+    if (wantQuats) {
+      quatsFuture = decode(meta.quats.files[0]);
+    }
+    if (wantScales) {
+      scalesFuture = decode(meta.scales.files[0]);
+    }
+    if (wantColor) {
+      sh0Future = decode(meta.sh0.files[0]);
+    }
     if (shCoffs > 0) {
-      const auto codebook = meta.shN->codebook;
-      const auto centroidsWebp = load(meta.shN->files[0]);
-      const auto labelsWebp = load(meta.shN->files[1]);
+      centroidsFuture = decode(meta.shN->files[0]);
+      labelsFuture = decode(meta.shN->files[1]);
+    }
 
-      const auto& centroidsDecoded = webpcodec::decodeRGBA(centroidsWebp);
-      const auto& labelsDecoded = webpcodec::decodeRGBA(labelsWebp);
+    if (wantMeans) {
+      conversions.push_back(launch([&] {
+        const Texture lo = meansLoFuture.get();
+        const Texture hi = meansHiFuture.get();
+        checkSize(lo, "means");
+        checkSize(hi, "means");
+
+        float* out[3] = {column("x"), column("y"), column("z")};
+        for (int axis = 0; axis < 3; ++axis) {
+          const float minV = meta.means.mins[axis];
+          const float range = meta.means.maxs[axis] - minV;
+          const float scale = range != 0.0f ? range : 1.0f;
+          for (int i = 0; i < count; ++i) {
+            const uint16_t q = static_cast<uint16_t>(lo.rgba[i * 4 + axis] | (hi.rgba[i * 4 + axis] << 8));
+            out[axis][i] = invLogTransform(minV + scale * (q / 65535.0f));
+          }
+        }
+      }));
+    }
 
-      const auto& centroidsRGBA = std::get<0>(centroidsDecoded);
-      const auto& cW = std::get<1>(centroidsDecoded);
-      const auto& cH = std::get<2>(centroidsDecoded);
+    if (wantQuats) {
+      conversions.push_back(launch([&] {
+        const Texture quats = quatsFuture.get();
+        checkSize(quats, "quats");
+        const uint8_t* qr = quats.rgba.get();
+
+        float* r0 = column("rot_0");
+        float* r1 = column("rot_1");
+        float* r2 = column("rot_2");
+        float* r3 = column("rot_3");
+        for (int i = 0; i < count; ++i) {
+          const auto o = i * 4;
+          const auto tag = qr[o + 3];
+          if (tag < 252) {
+            r0[i] = 0.0f;
+            r1[i] = 0.0f;
+            r2[i] = 0.0f;
+            r3[i] = 1.0f;
+            continue;
+          }
+          const auto [x, y, z, wq] = unpackQuat(qr[o], qr[o + 1], qr[o + 2], tag);
+          r0[i] = x;
+          r1[i] = y;
+          r2[i] = z;
+          r3[i] = wq;
+        }
+      }));
+    }
 
-      const auto& labelsRGBA = std::get<0>(labelsDecoded);
-      const auto& _lw = std::get<1>(labelsDecoded);
-      const auto& _lh = std::get<2>(labelsDecoded);
+    // scales: labels + codebook
+    if (wantScales) {
+      conversions.push_back(launch([&] {
+        const Texture scales = scalesFuture.get();
+        checkSize(scales, "scales");
+        const uint8_t* sl = scales.rgba.get();
+        const auto& sCode = meta.scales.codebook;
+
+        float* s0 = column("scale_0");
+        float* s1 = column("scale_1");
+        float* s2 = column("scale_2");
+        for (int i = 0; i < count; ++i) {
+          const auto o = i * 4;
+          s0[i] = sCode[sl[o]];
+          s1[i] = sCode[sl[o + 1]];
+          s2[i] = sCode[sl[o + 2]];
+        }
+      }));
+    }
 
-      // Prepare f_rest_i columns
-      static constexpr auto baseIdx = 14;
-      for (int i = 0; i < shCoffs * 3; ++i) {
-        columns.push_back({"f_rest_" + std::to_string(i), std::vector<float>(count, 0.0f)});
-      }
+    // colors + opacity: sh0.webp encodes 3 labels + opacity byte
+    if (wantColor) {
+      conversions.push_back(launch([&] {
+        const Texture sh0 = sh0Future.get();
+        checkSize(sh0, "sh0");
+        const uint8_t* c0 = sh0.rgba.get();
+        const auto& cCode = meta.sh0.codebook;
+
+        float* dc0 = column("f_dc_0");
+        float* dc1 = column("f_dc_1");
+        float* dc2 = column("f_dc_2");
+        float* op = column("opacity");
+        for (int i = 0; i < count; i++) {
+          const auto o = i * 4;
+          dc0[i] = cCode[c0[o + 0]];
+          dc1[i] = cCode[c0[o + 1]];
+          dc2[i] = cCode[c0[o + 2]];
+          op[i] = sigmoidInv(c0[o + 3] / 255.0f);
+        }
+      }));
+    }
 
-      const int stride = 4;
-      auto getCentroidPixel = [&](int centroidIndex, int coeff) -> std::array<uint8_t, 3> {
-        const int cx = (centroidIndex % 64) * shCoffs + coeff;
-        const int cy = (int)floor(centroidIndex / 64.0f);
-        if (cx >= cW || cy >= cH) return {0u, 0u, 0u};
-
-        const auto idx = (cy * cW + cx) * stride;
-        return {centroidsRGBA[idx], centroidsRGBA[idx + 1], centroidsRGBA[idx + 2]};
-      };
-
-      for (int i = 0; i < count; ++i) {
-        const auto o = i * 4;
-        const uint16_t label = labelsRGBA[o] | (labelsRGBA[o + 1] << 8);  // 16-bit palette index
-        if (label >= paletteCount) {
-          continue;
+    // Higher-order SH (optional)
+    if (shCoffs > 0) {
+      conversions.push_back(launch([&] {
+        const Texture centroids = centroidsFuture.get();
+        const Texture labels = labelsFuture.get();
+        checkSize(labels, "shN labels");
+
+        const auto paletteCount = meta.shN->count;
+        const auto& codebook = meta.shN->codebook;
+        const uint8_t* centroidsRGBA = centroids.rgba.get();
+        const uint8_t* labelsRGBA = labels.rgba.get();
+        const int cW = centroids.width;
+        const int cH = centroids.height;
+
+        std::vector<float*> rest(shCoffs * 3);
+        for (int j = 0; j < shCoffs * 3; ++j) {
+          rest[j] = column("f_rest_" + std::to_string(j));
         }
-        for (int j = 0; j < shCoffs; ++j) {
-          const auto& [lr, lg, lb] = getCentroidPixel(label, j);
-          columns[baseIdx + j + shCoffs * 0].setValue<float>(i, codebook[lr]);
-          columns[baseIdx + j + shCoffs * 1].setValue<float>(i, codebook[lg]);
-          columns[baseIdx + j + shCoffs * 2].setValue<float>(i, codebook[lb]);
+
+        const int stride = 4;
+        auto getCentroidPixel = [&](int centroidIndex, int coeff) -> std::array<uint8_t, 3> {
+          const int cx = (centroidIndex % 64) * shCoffs + coeff;
+          const int cy = centroidIndex / 64;
+          if (cx >= cW || cy >= cH) return {0u, 0u, 0u};
+
+          const auto idx = (static_cast<size_t>(cy) * cW + cx) * stride;
+          return {centroidsRGBA[idx], centroidsRGBA[idx + 1], centroidsRGBA[idx + 2]};
+        };
+
+        for (int i = 0; i < count; ++i) {
+          const auto o = i * 4;
+          const uint16_t label = labelsRGBA[o] | (labelsRGBA[o + 1] << 8);  // 16-bit palette index
+          if (label >= paletteCount) {
+            for (int j = 0; j < shCoffs * 3; ++j) {
+              rest[j][i] = 0.0f;
+            }
+            continue;
+          }
+          for (int j = 0; j < shCoffs; ++j) {
+            const auto& [lr, lg, lb] = getCentroidPixel(label, j);
+            rest[j + shCoffs * 0][i] = codebook[lr];
+            rest[j + shCoffs * 1][i] = codebook[lg];
+            rest[j + shCoffs * 2][i] = codebook[lb];
+          }
         }
-      }
+      }));
+    }
+
+    for (auto& conversion : conversions) {
+      conversion.get();
     }
+  } catch (...) {
+    // let in-flight tasks finish before the state they reference goes away
+    pool.reset();
+    throw;
   }
 
-  return std::make_unique<DataTable>(columns);
+  return std::make_unique<DataTable>(std::move(columns));
 }
 
 }  // namespace splat
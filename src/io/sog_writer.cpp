@@ -29,19 +29,31 @@
 #include <absl/strings/match.h>
 #include <splat/io/sog_writer.h>
 #include <splat/maths/maths.h>
+#include <splat/models/gaussian.h>
 #include <splat/models/sog.h>
 #include <splat/op/morton-order.h>
 #include <splat/spatial/kmeans.h>
+#include <splat/spatial/quantize1d.h>
 #include <splat/splat_version.h>
 #include <splat/utils/logger.h>
+#include <splat/utils/threadpool.h>
 #include <splat/utils/webp-codec.h>
 #include <splat/utils/zip-writer.h>
 
+#include <algorithm>
 #include <cmath>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <mutex>
 #include <numeric>
 #include <optional>
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SPLAT_SOG_X86 1
+#endif
 
 namespace fs = std::filesystem;
 
@@ -65,93 +77,167 @@ static const std::array<std::string, 45> shNames = {"f_rest_0",  "f_rest_1",  "f
 
                                                     "f_rest_40", "f_rest_41", "f_rest_42", "f_rest_43", "f_rest_44"};
 
-static std::vector<std::array<float, 2>> calcMinMax(const DataTable* dataTable,
-                                                    const std::vector<std::string>& columnNames,
-                                                    const std::vector<uint32_t>& indices) {
-  const size_t numCols = columnNames.size();
+static float logTransform(float value) { return std::copysign(1.0f, value) * logf(std::abs(value) + 1.0f); }
 
-  std::vector<std::array<float, 2>> minMax(
-      numCols, {std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()});
+// Per-splat packing kernels. Source columns are read through the view's row list (rows == nullptr for a
+// contiguous view, whose first row src already points at), so no row is ever copied or boxed.
 
-  std::vector<const Column*> targetColumns;
-  for (const auto& name : columnNames) {
-    targetColumns.push_back(&dataTable->getColumnByName(name));
-  }
+/// Fold src[rows[i]] into min/max; NaNs are skipped
+using MinMaxFn = void (*)(const float* src, const uint32_t* rows, size_t count, float& min, float& max);
 
-  for (uint32_t idx : indices) {
-    for (size_t j = 0; j < numCols; ++j) {
-      float value = targetColumns[j]->getValue<float>(idx);
+/// Interleave up to four byte planes into RGBA pixels; a null plane writes its fill value
+using InterleaveFn = void (*)(const std::array<const uint8_t*, 4>& planes, const std::array<uint8_t, 4>& fill,
+                              size_t count, uint8_t* out);
 
-      auto& [currentMin, currentMax] = minMax[j];
-      if (value < currentMin) currentMin = value;
-      if (value > currentMax) currentMax = value;
-    }
+static void minMaxScalar(const float* src, const uint32_t* rows, size_t count, float& min, float& max) {
+  for (size_t i = 0; i < count; ++i) {
+    const float value = src[rows ? rows[i] : i];
+    if (value < min) min = value;
+    if (value > max) max = value;
   }
+}
 
-  return minMax;
+static void interleaveScalar(const std::array<const uint8_t*, 4>& planes, const std::array<uint8_t, 4>& fill,
+                             size_t count, uint8_t* out) {
+  for (int c = 0; c < 4; ++c) {
+    const uint8_t* plane = planes[c];
+    if (plane) {
+      for (size_t i = 0; i < count; ++i) out[i * 4 + c] = plane[i];
+    } else {
+      for (size_t i = 0; i < count; ++i) out[i * 4 + c] = fill[c];
+    }
+  }
 }
 
-static float logTransform(float value) { return std::copysign(1.0f, value) * logf(std::abs(value) + 1.0f); }
+#ifdef SPLAT_SOG_X86
+
+// min_ps/max_ps return their second operand when the first is NaN, which matches the scalar compares
+__attribute__((target("avx2"))) static void minMaxAvx2(const float* src, const uint32_t* rows, size_t count,
+                                                       float& min, float& max) {
+  __m256 vmin = _mm256_set1_ps(min);
+  __m256 vmax = _mm256_set1_ps(max);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256 v =
+        rows ? _mm256_i32gather_ps(src, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + i)), 4)
+             : _mm256_loadu_ps(src + i);
+    vmin = _mm256_min_ps(v, vmin);
+    vmax = _mm256_max_ps(v, vmax);
+  }
 
-static std::tuple<std::unique_ptr<DataTable>, std::unique_ptr<DataTable>> cluster1d(const DataTable* dataTable,
-                                                                                    int iterations) {
-  const auto numColumns = dataTable->getNumColumns();
-  const auto numRows = dataTable->getNumRows();
+  alignas(32) float lanes[16];
+  _mm256_store_ps(lanes, vmin);
+  _mm256_store_ps(lanes + 8, vmax);
+  for (int k = 0; k < 8; ++k) {
+    if (lanes[k] < min) min = lanes[k];
+    if (lanes[8 + k] > max) max = lanes[8 + k];
+  }
+  minMaxScalar(rows ? src : src + i, rows ? rows + i : nullptr, count - i, min, max);
+}
 
-  // construct 1d points from the columns of data
-  std::vector<float> data(numRows * numColumns, 0.f);
-  for (size_t i = 0; i < numColumns; ++i) {
-    const auto& colData = dataTable->getColumn(i).asSpan<float>();
-    std::copy(colData.begin(), colData.end(), data.begin() + (i * numRows));
+__attribute__((target("avx2"))) static void interleaveAvx2(const std::array<const uint8_t*, 4>& planes,
+                                                           const std::array<uint8_t, 4>& fill, size_t count,
+                                                           uint8_t* out) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i c[4];
+    for (int k = 0; k < 4; ++k) {
+      c[k] = planes[k] ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[k] + i))
+                       : _mm_set1_epi8(static_cast<char>(fill[k]));
+    }
+    const __m128i rgLo = _mm_unpacklo_epi8(c[0], c[1]);
+    const __m128i rgHi = _mm_unpackhi_epi8(c[0], c[1]);
+    const __m128i baLo = _mm_unpacklo_epi8(c[2], c[3]);
+    const __m128i baHi = _mm_unpackhi_epi8(c[2], c[3]);
+    __m128i* dst = reinterpret_cast<__m128i*>(out + i * 4);
+    _mm_storeu_si128(dst + 0, _mm_unpacklo_epi16(rgLo, baLo));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(rgLo, baLo));
+    _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(rgHi, baHi));
+    _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(rgHi, baHi));
   }
 
-  auto src = std::make_unique<DataTable>();
-  src->addColumn({"data", std::move(data)});
+  std::array<const uint8_t*, 4> tail;
+  for (int k = 0; k < 4; ++k) tail[k] = planes[k] ? planes[k] + i : nullptr;
+  interleaveScalar(tail, fill, count - i, out + i * 4);
+}
 
-  auto [centroids, labels] = kmeans(src.release(), 256, iterations);
+#endif  // SPLAT_SOG_X86
 
-  // order centroids smallest to largest
-  auto centroidsData = centroids->getColumn(0).asSpan<float>();
-  std::vector<size_t> order(centroidsData.size());
-  std::iota(order.begin(), order.end(), 0);
-  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return centroidsData[a] < centroidsData[b]; });
+struct SogKernels {
+  MinMaxFn minMax;
+  InterleaveFn interleave;
+};
 
-  // reorder centroids
-  std::vector<float> tmp(centroidsData.begin(), centroidsData.end());
-  for (size_t i = 0; i < order.size(); i++) {
-    centroidsData[i] = tmp[order[i]];
+static SogKernels selectKernels() {
+#ifdef SPLAT_SOG_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {minMaxAvx2, interleaveAvx2};
   }
+#endif
+  return {minMaxScalar, interleaveScalar};
+}
 
-  std::vector<uint32_t> invOrder(order.size());
-  for (size_t i = 0; i < order.size(); i++) {
-    invOrder[order[i]] = i;
+/// Run fn(lo, hi) over [0, count) in chunks on the pool, or inline without one.
+template <typename F>
+static void forEachChunk(ThreadPool* pool, size_t count, size_t grain, F&& fn) {
+  if (pool) {
+    pool->parallelFor(0, count, grain, fn);
+  } else if (count > 0) {
+    fn(size_t(0), count);
   }
+}
 
-  // reorder labels
-  for (size_t i = 0; i < labels.size(); i++) {
-    labels[i] = invOrder[labels[i]];
-  }
+static const size_t PACK_GRAIN = 65536;
+
+static std::vector<std::array<float, 2>> calcMinMax(const DataTableView& view,
+                                                    const std::vector<std::string>& columnNames,
+                                                    const SogKernels& kernels, ThreadPool* pool) {
+  const size_t numCols = columnNames.size();
+  const size_t numRows = view.getNumRows();
+  const uint32_t* rows = view.rowIndices();
+  const size_t first = rows || numRows == 0 ? 0 : view.baseRow(0);
 
-  std::vector<Column> resultColumns;
-  auto names = dataTable->getColumnNames();
-  for (auto& name : names) {
-    resultColumns.push_back({name, std::vector<uint8_t>(numRows)});
+  std::vector<const float*> targetColumns;
+  for (const auto& name : columnNames) {
+    targetColumns.push_back(view.base().getColumnByName(name).asSpan<float>().data() + first);
   }
-  for (size_t i = 0; i < numColumns; i++) {
-    auto&& vec = resultColumns[i].asSpan<uint8_t>();
-    size_t startOffset = i * numRows;
-    for (size_t r = 0; r < numRows; ++r) {
-      vec[r] = static_cast<uint8_t>(labels[startOffset + r]);
+
+  // one partial result per chunk, folded in chunk order
+  const size_t numChunks = std::max<size_t>(1, (numRows + PACK_GRAIN - 1) / PACK_GRAIN);
+  std::vector<std::array<float, 2>> partial(
+      numChunks * numCols, {std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()});
+
+  forEachChunk(pool, numRows, PACK_GRAIN, [&](size_t lo, size_t hi) {
+    auto* out = &partial[lo / PACK_GRAIN * numCols];
+    for (size_t j = 0; j < numCols; ++j) {
+      const float* src = rows ? targetColumns[j] : targetColumns[j] + lo;
+      kernels.minMax(src, rows ? rows + lo : nullptr, hi - lo, out[j][0], out[j][1]);
+    }
+  });
+
+  std::vector<std::array<float, 2>> minMax(partial.begin(), partial.begin() + numCols);
+  for (size_t c = 1; c < numChunks; ++c) {
+    for (size_t j = 0; j < numCols; ++j) {
+      const auto& [chunkMin, chunkMax] = partial[c * numCols + j];
+      auto& [currentMin, currentMax] = minMax[j];
+      if (chunkMin < currentMin) currentMin = chunkMin;
+      if (chunkMax > currentMax) currentMax = chunkMax;
     }
   }
 
-  return {std::move(centroids), std::make_unique<DataTable>(resultColumns)};
+  return minMax;
 }
 
-void writeSog(const std::string& outputFilename, DataTable* dataTable, bool bundle, int iterations,
-              const std::vector<uint32_t>& idxs) {
-  std::unique_ptr<ZipWriter> zipWriter = bundle ? std::make_unique<ZipWriter>(outputFilename) : nullptr;
+static std::pair<std::vector<float>, std::unique_ptr<DataTable>> cluster1d(const DataTable* dataTable,
+                                                                          int iterations, ThreadPool* pool) {
+  // all columns share one 256 entry codebook, sorted smallest to largest
+  return quantize1d(dataTable, 256, iterations, pool);
+}
 
+void writeSog(const std::string& outputFilename, DataTable* dataTable, bool bundle, int iterations,
+              const std::vector<uint32_t>& idxs, const KMeansOptions& kmeansOptions, webpcodec::Preset webpPreset,
+              ThreadPool* pool) {
   // generateIndices
   std::vector<uint32_t> indices;
   if (idxs.empty()) {
@@ -162,80 +248,117 @@ void writeSog(const std::string& outputFilename, DataTable* dataTable, bool bund
     indices = idxs;
   }
 
-  const size_t numRows = indices.size();
+  writeSog(outputFilename, DataTableView(*dataTable, std::move(indices)), bundle, iterations, kmeansOptions,
+           webpPreset, pool);
+}
+
+void writeSog(const std::string& outputFilename, const DataTableView& view, bool bundle, int iterations,
+              const KMeansOptions& kmeansOptions, webpcodec::Preset webpPreset, ThreadPool* pool) {
+  std::unique_ptr<ZipWriter> zipWriter = bundle ? std::make_unique<ZipWriter>(outputFilename) : nullptr;
+
+  const size_t numRows = view.getNumRows();
   const size_t width = ceil(sqrt(static_cast<double>(numRows)) / 4) * 4;
   const size_t height = std::ceil(static_cast<double>(numRows) / width / 4) * 4;
   const size_t channels = 4;
 
-  // the layout function determines how the data is packed into the output texture.
-  auto writeWebp = [&](const std::string& filename, const std::vector<uint8_t>& data, size_t w, size_t h) {
-    std::vector<uint8_t> webp = webpcodec::encodeLosslessRGBA(data, w, h);
-    if (zipWriter) {
-      zipWriter->writeFile(filename, webp);
-    } else {
-      fs::path pathname = fs::path(outputFilename).parent_path() / filename;
-      std::ofstream out(pathname, std::ios::binary);
-      out.write(reinterpret_cast<const char*>(webp.data()), webp.size());
+  // Attribute stages and WebP encodes run as tasks on one pool: each stage queues the encodes of its
+  // textures as soon as their pixels are ready. Every encode fills its own slot, and the slots are written
+  // out in this fixed order once all encodes have finished, so the bundle's bytes do not depend on which
+  // encode completes first.
+  static const std::array<std::string, 7> textureNames = {
+      "means_l.webp", "means_u.webp", "quats.webp", "scales.webp", "sh0.webp", "shN_centroids.webp", "shN_labels.webp"};
+  std::array<std::vector<uint8_t>, textureNames.size()> textures;
+
+  std::mutex encodesMutex;
+  std::vector<std::future<void>> encodes;
+
+  // stages, clustering and encodes all share one pool, the caller's when given
+  const size_t hardwareThreads = std::thread::hardware_concurrency();
+  std::unique_ptr<ThreadPool> ownedPool;
+  if (!pool && hardwareThreads > 1) {
+    ownedPool = std::make_unique<ThreadPool>(hardwareThreads);
+    pool = ownedPool.get();
+  }
+  KMeansOptions shKMeansOptions = kmeansOptions;
+  if (!shKMeansOptions.pool) {
+    shKMeansOptions.pool = pool;
+  }
+
+  // without a pool every task runs, in order, when its result is first needed
+  auto launch = [&](auto fn) -> std::future<decltype(fn())> {
+    if (pool) {
+      return pool->enqueue(std::move(fn));
     }
+    return std::async(std::launch::deferred, std::move(fn));
   };
 
+  // the layout function determines how the data is packed into the output texture.
+  auto writeWebp = [&](const std::string& filename, std::vector<uint8_t> data, size_t w, size_t h) {
+    const size_t slot = std::find(textureNames.begin(), textureNames.end(), filename) - textureNames.begin();
+    auto pixels = std::make_shared<std::vector<uint8_t>>(std::move(data));
+    auto encode = [&, slot, pixels, w, h] {
+      textures[slot] = webpcodec::encodeLosslessRGBA(*pixels, w, h, 0, webpPreset);
+    };
+
+    std::lock_guard<std::mutex> lock(encodesMutex);
+    encodes.push_back(launch(std::move(encode)));
+  };
+
+  const SogKernels kernels = selectKernels();
+
+  // contiguous views read base columns from their first row on; permuted views go through rowIndices()
+  const uint32_t* rows = view.rowIndices();
+  const size_t firstRow = rows || numRows == 0 ? 0 : view.baseRow(0);
+  auto floatColumn = [&](const std::string& name) {
+    return view.base().getColumnByName(name).asSpan<float>().data() + firstRow;
+  };
+
+  // table rows are view rows and every column is a byte plane
   auto writeTableData = [&](const std::string& filename, const DataTable* table, size_t w, size_t h) {
     std::vector<uint8_t> data(w * h * channels, 0);
-    const size_t numColumns = table->getNumColumns();
-    for (size_t i = 0; i < indices.size(); i++) {
-      uint32_t idx = indices[i];
-      data[i * channels + 0] = table->getColumn(0).getValue<uint8_t>(idx);
-      data[i * channels + 1] = numColumns > 1 ? table->getColumn(1).getValue<uint8_t>(idx) : 0;
-      data[i * channels + 2] = numColumns > 2 ? table->getColumn(2).getValue<uint8_t>(idx) : 0;
-      data[i * channels + 3] = numColumns > 3 ? table->getColumn(3).getValue<uint8_t>(idx) : 255;
+    std::array<const uint8_t*, 4> planes = {nullptr, nullptr, nullptr, nullptr};
+    for (size_t c = 0; c < std::min<size_t>(table->getNumColumns(), planes.size()); ++c) {
+      planes[c] = table->getColumn(c).asSpan<uint8_t>().data();
     }
-    writeWebp(filename, data, w, h);
+    kernels.interleave(planes, {0, 0, 0, 255}, numRows, data.data());
+    writeWebp(filename, std::move(data), w, h);
   };
 
-  auto writeMeans = [&]() -> std::pair<std::vector<float>, std::vector<float>> {
-    std::vector<uint8_t> meansL(width * height * channels);
-    std::vector<uint8_t> meansU(width * height * channels);
-    static std::vector<std::string> meansNames = {"x", "y", "z"};
-    auto meansMinMax = calcMinMax(dataTable, meansNames, indices);
+  // The packing stages below run on the calling thread and spread their rows over the pool. Clustering
+  // stages run as tasks and split their own work over the same pool, which parallelFor allows.
+
+  std::vector<uint8_t> meansL;
+  std::vector<uint8_t> meansU;
+  auto packMeans = [&]() -> std::pair<std::vector<float>, std::vector<float>> {
+    meansL.assign(width * height * channels, 0);
+    meansU.assign(width * height * channels, 0);
+    static const std::vector<std::string> meansNames = {"x", "y", "z"};
+    auto meansMinMax = calcMinMax(view, meansNames, kernels, pool);
     for (auto&& v : meansMinMax) {
       v[0] = logTransform(v[0]);
       v[1] = logTransform(v[1]);
     }
 
-    std::vector<int> meansColumnIdxs;
-    for (const auto& name : meansNames) {
-      meansColumnIdxs.push_back(dataTable->getColumnIndex(name));
-    }
-    Row row;
-
-    for (int i = 0; i < indices.size(); i++) {
-      auto process = [&](const float& value, int axisIdx) -> uint16_t {
-        float val = logTransform(value);
-        float minV = meansMinMax[axisIdx][0];
-        float maxV = meansMinMax[axisIdx][1];
-
-        float normalized = (val - minV) / (maxV - minV);
-        return static_cast<uint16_t>(std::clamp(normalized * 65535.0f, 0.0f, 65535.0f));
-      };
-
-      dataTable->getRow(indices[i], row, meansColumnIdxs);
-      uint16_t x = process(row["x"], 0);
-      uint16_t y = process(row["y"], 1);
-      uint16_t z = process(row["z"], 2);
-
-      meansL[i * 4 + 0] = static_cast<uint8_t>(x & 0xff);
-      meansL[i * 4 + 1] = static_cast<uint8_t>(y & 0xff);
-      meansL[i * 4 + 2] = static_cast<uint8_t>(z & 0xff);
-      meansL[i * 4 + 3] = 0xff;
-
-      meansU[i * 4 + 0] = static_cast<uint8_t>((x >> 8) & 0xff);
-      meansU[i * 4 + 1] = static_cast<uint8_t>((y >> 8) & 0xff);
-      meansU[i * 4 + 2] = static_cast<uint8_t>((z >> 8) & 0xff);
-      meansU[i * 4 + 3] = 0xff;
-    }
-
-    writeWebp("means_l.webp", meansL, width, height);
-    writeWebp("means_u.webp", meansU, width, height);
+    const std::array<const float*, 3> src = {floatColumn("x"), floatColumn("y"), floatColumn("z")};
+
+    // log-transform and quantize to 16 bits, low bytes to means_l and high bytes to means_u
+    forEachChunk(pool, numRows, PACK_GRAIN, [&](size_t lo, size_t hi) {
+      for (size_t axis = 0; axis < 3; ++axis) {
+        const float* values = src[axis];
+        const float minV = meansMinMax[axis][0];
+        const float range = meansMinMax[axis][1] - minV;
+        for (size_t i = lo; i < hi; ++i) {
+          const float normalized = (logTransform(values[rows ? rows[i] : i]) - minV) / range;
+          const uint16_t q = static_cast<uint16_t>(std::clamp(normalized * 65535.0f, 0.0f, 65535.0f));
+          meansL[i * 4 + axis] = static_cast<uint8_t>(q & 0xff);
+          meansU[i * 4 + axis] = static_cast<uint8_t>(q >> 8);
+        }
+      }
+      for (size_t i = lo; i < hi; ++i) {
+        meansL[i * 4 + 3] = 0xff;
+        meansU[i * 4 + 3] = 0xff;
+      }
+    });
 
     std::vector<float> _mins;
     _mins.reserve(meansMinMax.size());
@@ -249,79 +372,68 @@ void writeSog(const std::string& outputFilename, DataTable* dataTable, bool bund
     return {_mins, _maxs};
   };
 
-  auto writeQuaternions = [&]() {
-    std::vector<uint8_t> quats(width * height * channels, 0);
-    static std::vector<std::string> quatsNames = {"rot_0", "rot_1", "rot_2", "rot_3"};
-    std::vector<int> quatsColumnIdxs;
-    for (const auto& name : quatsNames) {
-      quatsColumnIdxs.push_back(dataTable->getColumnIndex(name));
-    }
-    std::array<float, 4> q = {0.0, 0.0, 0.0, 0.0};
-
-    for (int i = 0; i < indices.size(); i++) {
-      Row row;
-      dataTable->getRow(indices[i], row, quatsColumnIdxs);
-      q[0] = row["rot_0"];
-      q[1] = row["rot_1"];
-      q[2] = row["rot_2"];
-      q[3] = row["rot_3"];
-
-      const float l = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
-
-      // normalize
-      std::for_each(q.begin(), q.end(), [&](float& v) { v /= l; });
-
-      // find max component
-      auto it = std::max_element(q.begin(), q.end(), [](float a, float b) { return std::abs(a) < std::abs(b); });
-      const size_t maxComp = std::distance(q.begin(), it);
-
-      // invert if max component is negative
-      if (q[maxComp] < 0) {
-        std::for_each(q.begin(), q.end(), [](float& v) { v = -v; });
+  std::vector<uint8_t> quats;
+  auto packQuaternions = [&]() {
+    quats.assign(width * height * channels, 0);
+    const std::array<const float*, 4> src = {floatColumn("rot_0"), floatColumn("rot_1"), floatColumn("rot_2"),
+                                             floatColumn("rot_3")};
+
+    static const int QUAT_IDX_MAP[4][3] = {
+        {1, 2, 3},  // maxComp = 0 (x)
+        {0, 2, 3},  // maxComp = 1 (y)
+        {0, 1, 3},  // maxComp = 2 (z)
+        {0, 1, 2}   // maxComp = 3 (w)
+    };
+
+    // smallest three: drop the largest component, store the others and its index
+    forEachChunk(pool, numRows, PACK_GRAIN, [&](size_t lo, size_t hi) {
+      for (size_t i = lo; i < hi; ++i) {
+        const size_t r = rows ? rows[i] : i;
+        float q[4] = {src[0][r], src[1][r], src[2][r], src[3][r]};
+
+        const float l = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        size_t maxComp = 0;
+        for (size_t k = 0; k < 4; ++k) {
+          q[k] /= l;
+          if (std::abs(q[maxComp]) < std::abs(q[k])) maxComp = k;
+        }
+
+        // invert if max component is negative, then scale by sqrt(2) to fit in [-1, 1] range
+        const float sign = q[maxComp] < 0 ? -1.0f : 1.0f;
+        const int* idx = QUAT_IDX_MAP[maxComp];
+        for (size_t k = 0; k < 3; ++k) {
+          const float v = static_cast<float>(sign * q[idx[k]] * M_SQRT2);
+          quats[i * 4 + k] = static_cast<uint8_t>(255.0 * (static_cast<double>(v) * 0.5 + 0.5));
+        }
+        quats[i * 4 + 3] = static_cast<uint8_t>(252 + maxComp);
       }
-
-      // scale by sqrt(2) to fit in [-1, 1] range
-      std::for_each(q.begin(), q.end(), [](float& v) { v *= M_SQRT2; });
-
-      static const int QUAT_IDX_MAP[4][3] = {
-          {1, 2, 3},  // maxComp = 0 (x)
-          {0, 2, 3},  // maxComp = 1 (y)
-          {0, 1, 3},  // maxComp = 2 (z)
-          {0, 1, 2}   // maxComp = 3 (w)
-      };
-
-      const int* idx = QUAT_IDX_MAP[maxComp];
-      quats[i * 4 + 0] = static_cast<uint8_t>(255.0 * (static_cast<double>(q[idx[0]]) * 0.5 + 0.5));
-      quats[i * 4 + 1] = static_cast<uint8_t>(255.0 * (static_cast<double>(q[idx[1]]) * 0.5 + 0.5));
-      quats[i * 4 + 2] = static_cast<uint8_t>(255.0 * (static_cast<double>(q[idx[2]]) * 0.5 + 0.5));
-      quats[i * 4 + 3] = static_cast<uint8_t>(252 + maxComp);
-    }
-
-    writeWebp("quats.webp", quats, width, height);
+    });
   };
 
   auto writeScales = [&]() {
-    auto&& [centroids, labels] = cluster1d(dataTable->clone({"scale_0", "scale_1", "scale_2"}).release(), iterations);
+    auto&& [codebook, labels] =
+        cluster1d(view.materialize({"scale_0", "scale_1", "scale_2"}).get(), iterations, pool);
 
-    writeTableData("scales.webp", labels.release(), width, height);
+    writeTableData("scales.webp", labels.get(), width, height);
 
-    return centroids->getColumn(0).asVector<float>();
+    return codebook;
   };
 
   auto writeColors = [&]() {
-    auto&& [centroids, labels] = cluster1d(dataTable->clone({"f_dc_0", "f_dc_1", "f_dc_2"}).release(), iterations);
+    auto&& [codebook, labels] =
+        cluster1d(view.materialize({"f_dc_0", "f_dc_1", "f_dc_2"}).get(), iterations, pool);
 
     // generate and store sigmoid(opacity) [0..1]
-    const auto& opacity = dataTable->getColumnByName("opacity").asSpan<float>();
-    std::vector<uint8_t> opacityData(opacity.size());
+    const auto& opacity = view.base().getColumnByName("opacity").asSpan<float>();
+    ColumnVector<uint8_t> opacityData(numRows);
     for (size_t i = 0; i < numRows; i++) {
-      double v = sigmoid(static_cast<double>(opacity[i])) * 255.0;
+      double v = sigmoid(static_cast<double>(opacity[view.baseRow(i)])) * 255.0;
       opacityData[i] = static_cast<uint8_t>(std::max(0.0, std::min(255.0, std::floor(v))));
     }
-    labels->addColumn({"opacity", opacityData});
+    labels->addColumn({"opacity", std::move(opacityData)});
 
-    writeTableData("sh0.webp", labels.release(), width, height);
-    return centroids->getColumn(0).asVector<float>();
+    writeTableData("sh0.webp", labels.get(), width, height);
+    return codebook;
   };
 
   auto writeSH = [&](int shBands) -> Meta::SHN {
@@ -333,36 +445,28 @@ void writeSog(const std::string& outputFilename, DataTable* dataTable, bool bund
       shColumnNames.push_back(shNames[i]);
     }
 
-    // create a table with just spherical harmonics data
-    // NOTE: this step should also copy the rows referenced in indices, but that's a
-    // lot of duplicate data when it's unneeded (which is currently never). so that
-    // means k-means is clustering the full dataset, instead of the rows referenced in
-    // indices.
-    auto shDataTable = dataTable->clone(shColumnNames);
-    int paletteSize =
-        std::min(64, static_cast<int>(std::pow(2, std::floor(std::log2(indices.size() / 1024.0f))))) * 1024;
+    // create a table with just the spherical harmonics data of the rows being written
+    auto shDataTable = view.materialize(shColumnNames);
+    int paletteSize = std::min(64, static_cast<int>(std::pow(2, std::floor(std::log2(numRows / 1024.0f))))) * 1024;
 
-    auto&& [centroids, labels] = kmeans(shDataTable.release(), paletteSize, iterations);
+    auto&& [centroids, labels] = kmeans(shDataTable.get(), paletteSize, iterations, shKMeansOptions);
 
     // construct a codebook for all spherical harmonic coefficients
-    auto&& codebook = cluster1d(centroids.get(), iterations);
+    auto&& codebook = cluster1d(centroids.get(), iterations, pool);
 
     // write centroids
     size_t numRowsCentroids = centroids->getNumRows();
     size_t ceilRows = static_cast<size_t>(std::ceil(numRowsCentroids / 64.0f));
     std::vector<uint8_t> centroidsBuf(64 * shCoeffs * ceilRows * 4, 0);
-    Row centroidsRow;
+    std::vector<const uint8_t*> codebookLabels;
+    for (const auto& name : shColumnNames) {
+      codebookLabels.push_back(codebook.second->getColumnByName(name).asVector<uint8_t>().data());
+    }
     for (size_t i = 0; i < centroids->getNumRows(); i++) {
-      std::get<1>(codebook)->getRow(i, centroidsRow);
       for (int j = 0; j < shCoeffs; ++j) {
-        // Convert float values to uint8_t (0-255 range)
-        float x_val = centroidsRow[shColumnNames[shCoeffs * 0 + j]];
-        float y_val = centroidsRow[shColumnNames[shCoeffs * 1 + j]];
-        float z_val = centroidsRow[shColumnNames[shCoeffs * 2 + j]];
-
-        uint8_t x = static_cast<uint8_t>(std::clamp(x_val, 0.0f, 255.0f));
-        uint8_t y = static_cast<uint8_t>(std::clamp(y_val, 0.0f, 255.0f));
-        uint8_t z = static_cast<uint8_t>(std::clamp(z_val, 0.0f, 255.0f));
+        const uint8_t x = codebookLabels[shCoeffs * 0 + j][i];
+        const uint8_t y = codebookLabels[shCoeffs * 1 + j][i];
+        const uint8_t z = codebookLabels[shCoeffs * 2 + j][i];
 
         centroidsBuf[i * shCoeffs * 4 + j * 4 + 0] = x;
         centroidsBuf[i * shCoeffs * 4 + j * 4 + 1] = y;
@@ -371,30 +475,30 @@ void writeSog(const std::string& outputFilename, DataTable* dataTable, bool bund
       }
     }
 
-    writeWebp("shN_centroids.webp", centroidsBuf, 64 * shCoeffs, ceilRows);
+    writeWebp("shN_centroids.webp", std::move(centroidsBuf), 64 * shCoeffs, ceilRows);
 
     // write labels
     std::vector<uint8_t> labelsBuf(width * height * channels, 0);
-    for (size_t i = 0; i < indices.size(); ++i) {
-      const uint32_t label = labels[indices[i]];
+    for (size_t i = 0; i < numRows; ++i) {
+      const uint32_t label = labels[i];
 
       labelsBuf[i * 4 + 0] = static_cast<uint8_t>(label & 0xff);
       labelsBuf[i * 4 + 1] = static_cast<uint8_t>((label >> 8) & 0xff);
       labelsBuf[i * 4 + 2] = 0;
       labelsBuf[i * 4 + 3] = 0xff;
     }
-    writeWebp("shN_labels.webp", labelsBuf, width, height);
+    writeWebp("shN_labels.webp", std::move(labelsBuf), width, height);
 
     return {paletteSize,
             shBands,
-            std::get<0>(codebook)->getColumn(0).asVector<float>(),
+            codebook.first,
             {"shN_centroids.webp", "shN_labels.webp"}};
   };
 
   // main
   int missingIdx = -1;
   for (int i = 0; i < (int)shNames.size(); ++i) {
-    if (!dataTable->hasColumn(shNames[i])) {
+    if (!view.hasColumn(shNames[i])) {
       missingIdx = i;
       break;
     }
@@ -410,20 +514,78 @@ void writeSog(const std::string& outputFilename, DataTable* dataTable, bool bund
   else
     shBands = 0;
 
-  // convert and write attributes
-  LOG_INFO("begin write means");
-  std::pair<std::vector<float>, std::vector<float>> meansMinMax = writeMeans();
-  LOG_INFO("begin write quaternions");
-  writeQuaternions();
-
-  LOG_INFO("begin write scales");
-  std::vector<float> scalesCodebook = writeScales();
-  LOG_INFO("begin write colors");
-  std::vector<float> colorsCodebook = writeColors();
+  // convert and write attributes; SH k-means is the critical path, so it starts first
+  std::pair<std::vector<float>, std::vector<float>> meansMinMax;
+  std::vector<float> scalesCodebook;
+  std::vector<float> colorsCodebook;
   std::optional<Meta::SHN> shN;
-  if (shBands > 0) {
-    LOG_INFO("begin write shBands");
-    shN = writeSH(shBands);
+  std::future<Meta::SHN> shFuture;
+  std::future<std::vector<float>> scalesFuture;
+  std::future<std::vector<float>> colorsFuture;
+  try {
+    if (shBands > 0) {
+      shFuture = launch([&] {
+        LOG_INFO("begin write shBands");
+        return writeSH(shBands);
+      });
+    }
+
+    // pack means and quaternions on the workers SH leaves idle, queueing their encodes only afterwards so
+    // the packing chunks are not stuck behind them
+    LOG_INFO("begin write means");
+    meansMinMax = packMeans();
+    LOG_INFO("begin write quaternions");
+    packQuaternions();
+    writeWebp("means_l.webp", std::move(meansL), width, height);
+    writeWebp("means_u.webp", std::move(meansU), width, height);
+    writeWebp("quats.webp", std::move(quats), width, height);
+
+    scalesFuture = launch([&] {
+      LOG_INFO("begin write scales");
+      return writeScales();
+    });
+    colorsFuture = launch([&] {
+      LOG_INFO("begin write colors");
+      return writeColors();
+    });
+
+    scalesCodebook = scalesFuture.get();
+    colorsCodebook = colorsFuture.get();
+    if (shFuture.valid()) {
+      shN = shFuture.get();
+    }
+
+    // every stage has queued its encodes by now
+    for (auto& encode : encodes) {
+      encode.get();
+    }
+
+    // textures of attributes the table lacks stay empty
+    for (size_t slot = 0; slot < textureNames.size(); ++slot) {
+      if (textures[slot].empty()) continue;
+      if (zipWriter) {
+        zipWriter->writeFile(textureNames[slot], textures[slot]);
+      } else {
+        fs::path pathname = fs::path(outputFilename).parent_path() / textureNames[slot];
+        std::ofstream out(pathname, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(textures[slot].data()), textures[slot].size());
+      }
+    }
+  } catch (...) {
+    // let in-flight tasks finish before the state they reference goes away; the pool may be the caller's,
+    // so wait for this call's tasks rather than for the pool. Without a pool nothing is in flight.
+    if (pool) {
+      for (auto* stage : {&scalesFuture, &colorsFuture}) {
+        if (stage->valid()) stage->wait();
+      }
+      if (shFuture.valid()) shFuture.wait();
+
+      // stages queue no more encodes once they have finished
+      for (auto& encode : encodes) {
+        if (encode.valid()) encode.wait();
+      }
+    }
+    throw;
   }
 
   Meta meta;
@@ -74,26 +74,26 @@ std::unique_ptr<DataTable> readSplat(const std::string& filename) {
   // Create columns for the standard Gaussian splat data
   std::vector<Column> columns = {
       // Position
-      {"x", std::vector<float>(numSplats, 0.0f)},
-      {"y", std::vector<float>(numSplats, 0.0f)},
-      {"z", std::vector<float>(numSplats, 0.0f)},
+      {"x", ColumnVector<float>(numSplats, 0.0f)},
+      {"y", ColumnVector<float>(numSplats, 0.0f)},
+      {"z", ColumnVector<float>(numSplats, 0.0f)},
 
       // Scale (stored as linear in .splat, convert to log for internal use)
-      {"scale_0", std::vector<float>(numSplats, 0.0f)},
-      {"scale_1", std::vector<float>(numSplats, 0.0f)},
-      {"scale_2", std::vector<float>(numSplats, 0.0f)},
+      {"scale_0", ColumnVector<float>(numSplats, 0.0f)},
+      {"scale_1", ColumnVector<float>(numSplats, 0.0f)},
+      {"scale_2", ColumnVector<float>(numSplats, 0.0f)},
 
       // Color/opacity
-      {"f_dc_0", std::vector<float>(numSplats, 0.0f)},  // red
-      {"f_dc_1", std::vector<float>(numSplats, 0.0f)},  // green
-      {"f_dc_2", std::vector<float>(numSplats, 0.0f)},  // blue
-      {"opacity", std::vector<float>(numSplats, 0.0f)},
+      {"f_dc_0", ColumnVector<float>(numSplats, 0.0f)},  // red
+      {"f_dc_1", ColumnVector<float>(numSplats, 0.0f)},  // green
+      {"f_dc_2", ColumnVector<float>(numSplats, 0.0f)},  // blue
+      {"opacity", ColumnVector<float>(numSplats, 0.0f)},
 
       // Rotation quaternion
-      {"rot_0", std::vector<float>(numSplats, 0.0f)},
-      {"rot_1", std::vector<float>(numSplats, 0.0f)},
-      {"rot_2", std::vector<float>(numSplats, 0.0f)},
-      {"rot_3", std::vector<float>(numSplats, 0.0f)},
+      {"rot_0", ColumnVector<float>(numSplats, 0.0f)},
+      {"rot_1", ColumnVector<float>(numSplats, 0.0f)},
+      {"rot_2", ColumnVector<float>(numSplats, 0.0f)},
+      {"rot_3", ColumnVector<float>(numSplats, 0.0f)},
   };
 
   // Read data in chunks
@@ -182,7 +182,7 @@ std::unique_ptr<DataTable> readSplat(const std::string& filename) {
       }
     }
   }
-  return std::make_unique<DataTable>(columns);
+  return std::make_unique<DataTable>(std::move(columns));
 }
 
 }  // namespace splat
@@ -26,10 +26,22 @@
  ***********************************************************************************/
 
 #include <splat/io/spz_reader.h>
+#include <splat/utils/mapped-file.h>
+#include <splat/utils/threadpool.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SPLAT_SPZ_X86 1
+#endif
 
 namespace splat {
 
@@ -39,193 +51,386 @@ const size_t HARMONICS_COMPONENT_COUNT[] = {0, 9, 24, 45};
 
 static float inverseConvertColorFromSPZ(float y) { return (y / 255.0f - 0.5f) / SH_C0_2; }
 
-static std::vector<uint8_t> decompressGZIP(const std::vector<uint8_t>& compressedData) {
-  if (compressedData.size() < 18) throw std::runtime_error("Buffer too small to be GZip");
+// Splats per inflated slab; a slab of the widest plane (45 SH bytes per splat) is about 3MB.
+static constexpr size_t kSlabSplats = 1 << 16;
 
-  z_stream zs;
-  std::memset(&zs, 0, sizeof(z_stream));
+// Splats per parallelFor task.
+static constexpr size_t kDecodeGrain = 8192;
 
-  if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) {
-    throw std::runtime_error("inflateInit2 failed");
+/**
+ * @brief Gzip stream inflated on demand into caller buffers, so the payload is never materialised
+ */
+class InflateReader {
+ public:
+  InflateReader(const uint8_t* data, size_t size) : next_(data), remaining_(size) {
+    if (inflateInit2(&stream_, 16 + MAX_WBITS) != Z_OK) {
+      throw std::runtime_error("inflateInit2 failed");
+    }
   }
 
-  zs.next_in = const_cast<Bytef*>(compressedData.data());
-  zs.avail_in = static_cast<uInt>(compressedData.size());
-
-  int ret;
-  std::vector<uint8_t> outBuffer;
-  uint8_t temp_buf[10240] = {0};
-  do {
-    zs.next_out = temp_buf;
-    zs.avail_out = sizeof(temp_buf);
-
-    ret = inflate(&zs, Z_NO_FLUSH);
+  ~InflateReader() { inflateEnd(&stream_); }
+
+  InflateReader(const InflateReader&) = delete;
+  InflateReader& operator=(const InflateReader&) = delete;
+
+  /**
+   * @brief Inflate exactly size bytes into dst
+   * @throws std::runtime_error if the stream is corrupt or ends early
+   */
+  void read(uint8_t* dst, size_t size) {
+    while (size > 0) {
+      if (stream_.avail_in == 0 && remaining_ > 0) {
+        const uInt piece = static_cast<uInt>(std::min<size_t>(remaining_, 1u << 30));
+        stream_.next_in = const_cast<Bytef*>(next_);
+        stream_.avail_in = piece;
+        next_ += piece;
+        remaining_ -= piece;
+      }
 
-    if (outBuffer.size() < zs.total_out) {
-      size_t decompressedChunkSize = sizeof(temp_buf) - zs.avail_out;
-      outBuffer.insert(outBuffer.end(), temp_buf, temp_buf + decompressedChunkSize);
+      const uInt want = static_cast<uInt>(std::min<size_t>(size, 1u << 30));
+      stream_.next_out = dst;
+      stream_.avail_out = want;
+      const int ret = inflate(&stream_, Z_NO_FLUSH);
+      const size_t produced = want - stream_.avail_out;
+      dst += produced;
+      size -= produced;
+
+      if (ret == Z_STREAM_END || (ret == Z_BUF_ERROR && stream_.avail_in == 0 && remaining_ == 0)) {
+        if (size > 0) throw std::runtime_error("SPZ data truncated");
+      } else if (ret != Z_OK) {
+        throw std::runtime_error("GZip decompression failed: " + std::to_string(ret));
+      }
     }
+  }
+
+ private:
+  z_stream stream_{};
+  const uint8_t* next_;
+  size_t remaining_;
+};
 
-  } while (ret == Z_OK);
+/// out[i] = in[i * stride] * scale + bias
+using DecodeBytesFn = void (*)(const uint8_t* in, size_t stride, size_t count, float scale, float bias, float* out);
 
-  inflateEnd(&zs);
+/// out[i] = (24-bit two's complement at in + i * 9) * scale
+using DecodeFixed24Fn = void (*)(const uint8_t* in, size_t count, float scale, float* out);
 
-  if (ret != Z_STREAM_END) {
-    throw std::runtime_error("GZip decompression failed: " + std::to_string(ret));
+static void decodeBytesScalar(const uint8_t* in, size_t stride, size_t count, float scale, float bias, float* out) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = static_cast<float>(in[i * stride]) * scale + bias;
   }
+}
 
-  return outBuffer;
+static void decodeFixed24Scalar(const uint8_t* in, size_t count, float scale, float* out) {
+  for (size_t i = 0; i < count; ++i, in += 9) {
+    const uint32_t value = static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+                           (static_cast<uint32_t>(in[2]) << 16);
+    // move bit 23 into the sign bit and shift back arithmetically
+    out[i] = static_cast<float>(static_cast<int32_t>(value << 8) >> 8) * scale;
+  }
 }
 
-static int32_t getFixed24(const std::vector<uint8_t>& buffer, size_t elementIndex, size_t memberIndex) {
-  const size_t stride = 9;
-  const size_t offset = elementIndex * stride + memberIndex * 3;
+#ifdef SPLAT_SPZ_X86
+
+// Both kernels gather 4 bytes per lane and mask or shift the extra ones away. The vector loop stops
+// while the last lane's load still ends inside the plane; the scalar kernel finishes the tail.
+
+__attribute__((target("avx2"))) static void decodeBytesAvx2(const uint8_t* in, size_t stride, size_t count,
+                                                            float scale, float bias, float* out) {
+  const __m256i offsets =
+      _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+  const __m256i mask = _mm256_set1_epi32(0xff);
+  const __m256 vscale = _mm256_set1_ps(scale);
+  const __m256 vbias = _mm256_set1_ps(bias);
+
+  size_t i = 0;
+  if (count > 0) {
+    const size_t lastByte = (count - 1) * stride;
+    for (; i + 8 <= count && (i + 7) * stride + 3 <= lastByte; i += 8) {
+      __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(in + i * stride), offsets, 1);
+      v = _mm256_and_si256(v, mask);
+      _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), vscale), vbias));
+    }
+  }
+  decodeBytesScalar(in + i * stride, stride, count - i, scale, bias, out + i);
+}
 
-  if (offset + 3 > buffer.size()) {
-    throw std::out_of_range("SPZ buffer access out of range");
+__attribute__((target("avx2"))) static void decodeFixed24Avx2(const uint8_t* in, size_t count, float scale,
+                                                              float* out) {
+  const __m256i offsets = _mm256_setr_epi32(0, 9, 18, 27, 36, 45, 54, 63);
+  const __m256 vscale = _mm256_set1_ps(scale);
+
+  size_t i = 0;
+  if (count > 0) {
+    const size_t lastByte = (count - 1) * 9 + 2;
+    for (; i + 8 <= count && (i + 7) * 9 + 3 <= lastByte; i += 8) {
+      __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(in + i * 9), offsets, 1);
+      v = _mm256_srai_epi32(_mm256_slli_epi32(v, 8), 8);
+      _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), vscale));
+    }
   }
+  decodeFixed24Scalar(in + i * 9, count - i, scale, out + i);
+}
 
-  uint32_t val = static_cast<uint32_t>(buffer[offset]) | (static_cast<uint32_t>(buffer[offset + 1]) << 8) |
-                 (static_cast<uint32_t>(buffer[offset + 2]) << 16);
+#endif  // SPLAT_SPZ_X86
 
-  if (val & 0x800000) {
-    val |= 0xFF000000;
-  }
+struct SpzKernels {
+  DecodeBytesFn bytes;
+  DecodeFixed24Fn fixed24;
+};
 
-  return static_cast<int32_t>(val);
+static SpzKernels selectKernels() {
+#ifdef SPLAT_SPZ_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {decodeBytesAvx2, decodeFixed24Avx2};
+  }
+#endif
+  return {decodeBytesScalar, decodeFixed24Scalar};
 }
 
-std::unique_ptr<DataTable> readSpz(const std::string& filename) {
-  std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
-  if (!ifs.is_open()) {
-    throw std::runtime_error("cannot open file");
-  }
+namespace {
 
-  std::streamsize filesize = ifs.tellg();
-  ifs.seekg(0, std::ios::beg);
-  std::vector<uint8_t> buffer(filesize);
-  ifs.read(reinterpret_cast<char*>(buffer.data()), filesize);
+/// One field plane of the SPZ payload: bytesPerSplat bytes for every splat, in splat order
+struct SpzPlane {
+  size_t bytesPerSplat;
+  std::function<void(const uint8_t* in, size_t first, size_t count)> decode;
+};
 
-  if (buffer.size() > 2 && buffer[0] == 0x1F && buffer[1] == 0x8B) {
-    buffer = decompressGZIP(buffer);
-  }
+}  // namespace
 
-  const uint8_t* data = buffer.data();
-  if (buffer.size() < SPZ_HEADER_SIZE) throw std::runtime_error("File too small");
+std::unique_ptr<DataTable> readSpz(const std::string& filename) {
+  // map the file when possible, fall back to reading it otherwise (pipes, special files)
+  std::unique_ptr<MappedFile> mapped;
+  std::vector<uint8_t> contents;
+  try {
+    mapped = std::make_unique<MappedFile>(filename);
+  } catch (const std::runtime_error&) {
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs.is_open()) {
+      throw std::runtime_error("cannot open file");
+    }
+    contents.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  }
+  const uint8_t* fileData = mapped ? mapped->data() : contents.data();
+  const size_t fileSize = mapped ? mapped->size() : contents.size();
+
+  std::unique_ptr<InflateReader> inflater;
+  uint8_t header[SPZ_HEADER_SIZE];
+  if (fileSize > 2 && fileData[0] == 0x1F && fileData[1] == 0x8B) {
+    if (fileSize < 18) throw std::runtime_error("Buffer too small to be GZip");
+    if (mapped) mapped->adviseSequential(0, fileSize);
+    inflater = std::make_unique<InflateReader>(fileData, fileSize);
+    inflater->read(header, SPZ_HEADER_SIZE);
+  } else {
+    if (fileSize < SPZ_HEADER_SIZE) throw std::runtime_error("File too small");
+    std::memcpy(header, fileData, SPZ_HEADER_SIZE);
+  }
 
   uint32_t magic;
-  std::memcpy(&magic, data, 4);
+  std::memcpy(&magic, header, 4);
   if (magic != 0x5053474E) throw std::runtime_error("Invalid SPZ magic (NGSP)");
 
   uint32_t version;
-  std::memcpy(&version, data + 4, 4);
+  std::memcpy(&version, header + 4, 4);
+  if (version != 2 && version != 3) {
+    throw std::runtime_error("Unsupported SPZ version: " + std::to_string(version));
+  }
   uint32_t numSplats;
-  std::memcpy(&numSplats, data + 8, 4);
+  std::memcpy(&numSplats, header + 8, 4);
 
-  uint8_t shDegree = data[12];
-  uint8_t fractionalBits = data[13];
+  uint8_t shDegree = header[12];
+  uint8_t fractionalBits = header[13];
   size_t harmonicsCount = HARMONICS_COMPONENT_COUNT[shDegree > 3 ? 0 : shDegree];
 
-  size_t offset = SPZ_HEADER_SIZE;
-  const uint8_t* posBase = data + offset;
-  offset += numSplats * 3 * 3;
-  const uint8_t* alphaBase = data + offset;
-  offset += numSplats;
-  const uint8_t* colorBase = data + offset;
-  offset += numSplats * 3;
-  const uint8_t* scaleBase = data + offset;
-  offset += numSplats * 3;
-  const uint8_t* rotBase = data + offset;
-  offset += numSplats * (version == 3 ? 4 : 3);
-  const uint8_t* shBase = data + offset;
-
-  std::vector<Column> columns = {// Position
-                                 {"x", std::vector<float>(numSplats, 0.0f)},
-                                 {"y", std::vector<float>(numSplats, 0.0f)},
-                                 {"z", std::vector<float>(numSplats, 0.0f)},
-
-                                 // Scale (stored as linear in .splat, convert to log for internal use)
-                                 {"scale_0", std::vector<float>(numSplats, 0.0f)},
-                                 {"scale_1", std::vector<float>(numSplats, 0.0f)},
-                                 {"scale_2", std::vector<float>(numSplats, 0.0f)},
-
-                                 // Color/opacity
-                                 {"f_dc_0", std::vector<float>(numSplats, 0.0f)},  // Red
-                                 {"f_dc_1", std::vector<float>(numSplats, 0.0f)},  // Green
-                                 {"f_dc_2", std::vector<float>(numSplats, 0.0f)},  // Blue
-                                 {"opacity", std::vector<float>(numSplats, 0.0f)},
-
-                                 // Rotation quaternion
-                                 {"rot_0", std::vector<float>(numSplats, 0.0f)},
-                                 {"rot_1", std::vector<float>(numSplats, 0.0f)},
-                                 {"rot_2", std::vector<float>(numSplats, 0.0f)},
-                                 {"rot_3", std::vector<float>(numSplats, 0.0f)}};
-
-  for (size_t i = 0; i < harmonicsCount; ++i)
-    columns.push_back({"f_rest_" + std::to_string(i), std::vector<float>(numSplats, 0.0f)});
+  std::vector<ColumnSpec> specs = {// Position
+                                   {"x", ColumnType::FLOAT32},
+                                   {"y", ColumnType::FLOAT32},
+                                   {"z", ColumnType::FLOAT32},
+
+                                   // Scale (stored as linear in .splat, convert to log for internal use)
+                                   {"scale_0", ColumnType::FLOAT32},
+                                   {"scale_1", ColumnType::FLOAT32},
+                                   {"scale_2", ColumnType::FLOAT32},
+
+                                   // Color/opacity
+                                   {"f_dc_0", ColumnType::FLOAT32},  // Red
+                                   {"f_dc_1", ColumnType::FLOAT32},  // Green
+                                   {"f_dc_2", ColumnType::FLOAT32},  // Blue
+                                   {"opacity", ColumnType::FLOAT32},
+
+                                   // Rotation quaternion
+                                   {"rot_0", ColumnType::FLOAT32},
+                                   {"rot_1", ColumnType::FLOAT32},
+                                   {"rot_2", ColumnType::FLOAT32},
+                                   {"rot_3", ColumnType::FLOAT32}};
+
+  for (size_t i = 0; i < harmonicsCount; ++i) specs.push_back({"f_rest_" + std::to_string(i), ColumnType::FLOAT32});
+
+  // every element of every column is written below
+  std::vector<Column> columns = allocateColumns(specs, numSplats);
 
   std::vector<float*> colPtrs;
   for (auto& col : columns) colPtrs.push_back(col.asVector<float>().data());
 
+  const SpzKernels kernels = selectKernels();
+
+  // colour and opacity bytes decode through tables; opacity would otherwise cost a log per splat
+  float colorLut[256];
+  float opacityLut[256];
+  for (int b = 0; b < 256; ++b) {
+    colorLut[b] = inverseConvertColorFromSPZ(static_cast<float>(b));
+    float normAlpha = std::clamp(b / 255.0f, 1e-6f, 1.0f - 1e-6f);
+    opacityLut[b] = std::log(normAlpha / (1.0f - normAlpha));
+  }
+
   const float posScale = 1.0f / (1 << fractionalBits);
-  for (uint32_t i = 0; i < numSplats; ++i) {
-    // Position (24-bit fixed point)
-    colPtrs[0][i] = getFixed24(buffer, i, 0) * posScale;
-    colPtrs[1][i] = getFixed24(buffer, i, 1) * posScale;
-    colPtrs[2][i] = getFixed24(buffer, i, 2) * posScale;
-
-    // Scale
-    colPtrs[3][i] = scaleBase[i * 3 + 0] / 16.0f - 10.0f;
-    colPtrs[4][i] = scaleBase[i * 3 + 1] / 16.0f - 10.0f;
-    colPtrs[5][i] = scaleBase[i * 3 + 2] / 16.0f - 10.0f;
-
-    // Color & Opacity (Inverse Sigmoid)
-    colPtrs[6][i] = inverseConvertColorFromSPZ(colorBase[i * 3 + 0]);
-    colPtrs[7][i] = inverseConvertColorFromSPZ(colorBase[i * 3 + 1]);
-    colPtrs[8][i] = inverseConvertColorFromSPZ(colorBase[i * 3 + 2]);
-
-    float normAlpha = std::clamp(alphaBase[i] / 255.0f, 1e-6f, 1.0f - 1e-6f);
-    colPtrs[9][i] = std::log(normAlpha / (1.0f - normAlpha));
-
-    // Rotation (Quaternions)
-    float q[4] = {1, 0, 0, 0};
-    if (version == 2) {
-      q[1] = (rotBase[i * 3 + 0] / 127.5f) - 1.0f;
-      q[2] = (rotBase[i * 3 + 1] / 127.5f) - 1.0f;
-      q[3] = (rotBase[i * 3 + 2] / 127.5f) - 1.0f;
-      float dot = q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
-      q[0] = std::sqrt(std::max(0.0f, 1.0f - dot));
-    } else if (version == 3) {
-      uint32_t packed;
-      std::memcpy(&packed, rotBase + i * 4, 4);
-      uint32_t largestIndex = packed >> 30;
-      float sum_sq = 0;
-      uint32_t temp = packed;
-      for (int j = 3; j >= 0; --j) {
-        if (static_cast<uint32_t>(j) != largestIndex) {
-          uint32_t mag = temp & 511;
-          float val = 0.70710678f * mag / 511.0f;
-          if ((temp >> 9) & 1) val = -val;
-          q[j] = val;
-          sum_sq += val * val;
-          temp >>= 10;
-        }
-      }
-      q[largestIndex] = std::sqrt(std::max(0.0f, 1.0f - sum_sq));
+
+  // planes in file order; each decodes splats [first, first + count) from its bytes at in
+  std::vector<SpzPlane> planes;
+  planes.push_back({9, [&](const uint8_t* in, size_t first, size_t count) {
+                      // Position (24-bit fixed point)
+                      for (size_t m = 0; m < 3; ++m) {
+                        kernels.fixed24(in + m * 3, count, posScale, colPtrs[m] + first);
+                      }
+                    }});
+  planes.push_back({1, [&](const uint8_t* in, size_t first, size_t count) {
+                      // Opacity (Inverse Sigmoid)
+                      for (size_t i = 0; i < count; ++i) {
+                        colPtrs[9][first + i] = opacityLut[in[i]];
+                      }
+                    }});
+  planes.push_back({3, [&](const uint8_t* in, size_t first, size_t count) {
+                      // Color
+                      for (size_t i = 0; i < count; ++i) {
+                        for (size_t c = 0; c < 3; ++c) {
+                          colPtrs[6 + c][first + i] = colorLut[in[i * 3 + c]];
+                        }
+                      }
+                    }});
+  planes.push_back({3, [&](const uint8_t* in, size_t first, size_t count) {
+                      // Scale
+                      for (size_t c = 0; c < 3; ++c) {
+                        kernels.bytes(in + c, 3, count, 1.0f / 16.0f, -10.0f, colPtrs[3 + c] + first);
+                      }
+                    }});
+  planes.push_back({version == 3 ? 4u : 3u, [&](const uint8_t* in, size_t first, size_t count) {
+                      // Rotation (Quaternions)
+                      for (size_t i = 0; i < count; ++i) {
+                        float q[4] = {1, 0, 0, 0};
+                        if (version == 2) {
+                          const uint8_t* r = in + i * 3;
+                          q[1] = (r[0] / 127.5f) - 1.0f;
+                          q[2] = (r[1] / 127.5f) - 1.0f;
+                          q[3] = (r[2] / 127.5f) - 1.0f;
+                          float dot = q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+                          q[0] = std::sqrt(std::max(0.0f, 1.0f - dot));
+                        } else {
+                          uint32_t packed;
+                          std::memcpy(&packed, in + i * 4, 4);
+                          uint32_t largestIndex = packed >> 30;
+                          float sum_sq = 0;
+                          uint32_t temp = packed;
+                          // the packed components are ordered x, y, z, w
+                          float r[4];
+                          for (int j = 3; j >= 0; --j) {
+                            if (static_cast<uint32_t>(j) != largestIndex) {
+                              uint32_t mag = temp & 511;
+                              float val = 0.70710678f * mag / 511.0f;
+                              if ((temp >> 9) & 1) val = -val;
+                              r[j] = val;
+                              sum_sq += val * val;
+                              temp >>= 10;
+                            }
+                          }
+                          r[largestIndex] = std::sqrt(std::max(0.0f, 1.0f - sum_sq));
+                          q[0] = r[3];
+                          q[1] = r[0];
+                          q[2] = r[1];
+                          q[3] = r[2];
+                        }
+                        colPtrs[10][first + i] = q[0];
+                        colPtrs[11][first + i] = q[1];
+                        colPtrs[12][first + i] = q[2];
+                        colPtrs[13][first + i] = q[3];
+                      }
+                    }});
+  if (harmonicsCount > 0) {
+    planes.push_back({harmonicsCount, [&](const uint8_t* in, size_t first, size_t count) {
+                        // Spherical Harmonics, interleaved by channel per coefficient
+                        for (size_t sh = 0; sh < harmonicsCount; ++sh) {
+                          size_t channel = sh % 3;
+                          size_t coeff = sh / 3;
+                          size_t colIdx = 14 + (channel * (harmonicsCount / 3) + coeff);
+                          kernels.bytes(in + sh, harmonicsCount, count, 1.0f / 128.0f, -1.0f, colPtrs[colIdx] + first);
+                        }
+                      }});
+  }
+
+  const size_t hardwareThreads = std::thread::hardware_concurrency();
+  std::unique_ptr<ThreadPool> pool;
+  if (hardwareThreads > 1 && numSplats > kDecodeGrain) {
+    pool = std::make_unique<ThreadPool>(hardwareThreads);
+  }
+
+  auto decodeSpan = [&](const SpzPlane& plane, const uint8_t* in, size_t first, size_t count) {
+    auto decodeRange = [&](size_t lo, size_t hi) {
+      plane.decode(in + lo * plane.bytesPerSplat, first + lo, hi - lo);
+    };
+    if (pool) {
+      pool->parallelFor(0, count, kDecodeGrain, decodeRange);
+    } else {
+      decodeRange(0, count);
     }
-    colPtrs[10][i] = q[0];
-    colPtrs[11][i] = q[1];
-    colPtrs[12][i] = q[2];
-    colPtrs[13][i] = q[3];
-
-    // Spherical Harmonics
-    for (size_t sh = 0; sh < harmonicsCount; ++sh) {
-      size_t channel = sh % 3;
-      size_t coeff = sh / 3;
-      size_t colIdx = 14 + (channel * (harmonicsCount / 3) + coeff);
-      uint8_t shVal = shBase[i * harmonicsCount + sh];
-      colPtrs[colIdx][i] = (static_cast<float>(shVal) - 128.0f) / 128.0f;
+  };
+
+  if (!inflater) {
+    // uncompressed payload: decode straight from the file
+    size_t payloadSize = 0;
+    for (const auto& plane : planes) payloadSize += plane.bytesPerSplat * numSplats;
+    if (fileSize - SPZ_HEADER_SIZE < payloadSize) throw std::runtime_error("SPZ data truncated");
+
+    const uint8_t* in = fileData + SPZ_HEADER_SIZE;
+    for (const auto& plane : planes) {
+      decodeSpan(plane, in, 0, numSplats);
+      in += plane.bytesPerSplat * numSplats;
     }
+    return std::make_unique<DataTable>(std::move(columns));
+  }
+
+  // inflate slab by slab: the I/O thread inflates the next slab while the current one is decoded
+  struct Slab {
+    const SpzPlane* plane;
+    size_t first;
+    size_t count;
+  };
+  std::vector<Slab> slabs;
+  size_t maxBytesPerSplat = 0;
+  for (const auto& plane : planes) {
+    maxBytesPerSplat = std::max(maxBytesPerSplat, plane.bytesPerSplat);
+    for (size_t first = 0; first < numSplats; first += kSlabSplats) {
+      slabs.push_back({&plane, first, std::min(kSlabSplats, numSplats - first)});
+    }
+  }
+
+  std::vector<uint8_t> staging[2];
+  for (auto& buffer : staging) {
+    buffer.resize(std::min<size_t>(kSlabSplats, numSplats) * maxBytesPerSplat);
+  }
+
+  ThreadPool io(1);
+  auto inflateSlab = [&](size_t s) {
+    return io.enqueue([&inflater, &slabs, out = staging[s & 1].data(), s] {
+      inflater->read(out, slabs[s].count * slabs[s].plane->bytesPerSplat);
+    });
+  };
+
+  std::future<void> pending;
+  if (!slabs.empty()) pending = inflateSlab(0);
+  for (size_t s = 0; s < slabs.size(); ++s) {
+    pending.get();
+    if (s + 1 < slabs.size()) pending = inflateSlab(s + 1);
+    decodeSpan(*slabs[s].plane, staging[s & 1].data(), slabs[s].first, slabs[s].count);
   }
 
   return std::make_unique<DataTable>(std::move(columns));
@@ -0,0 +1,347 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <splat/io/spz_writer.h>
+#include <splat/maths/maths.h>
+#include <splat/models/gaussian.h>
+#include <splat/utils/threadpool.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <thread>
+
+namespace splat {
+
+static constexpr uint32_t kSpzMagic = 0x5053474E;
+static constexpr size_t kSpzHeaderSize = 16;
+static constexpr float kSpzColorScale = 0.15f;
+
+// Splats per staging buffer; a slab of the widest plane (45 SH bytes per splat) is about 3MB.
+static constexpr size_t kSlabSplats = 1 << 16;
+
+// Splats per parallelFor task within a slab.
+static constexpr size_t kEncodeGrain = 8192;
+
+static constexpr size_t kDeflateBufferSize = 1 << 18;
+
+/**
+ * @brief Gzip stream written to a file as input arrives, so only the deflate window is buffered
+ */
+class GzipFileWriter {
+ public:
+  GzipFileWriter(const std::string& filename, int level)
+      : out_(filename, std::ios::binary | std::ios::trunc), buffer_(kDeflateBufferSize) {
+    if (!out_.is_open()) {
+      throw std::runtime_error("Cannot open file for writing: " + filename);
+    }
+    // 16 + MAX_WBITS selects the gzip wrapper
+    if (deflateInit2(&stream_, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      throw std::runtime_error("deflateInit2 failed");
+    }
+  }
+
+  ~GzipFileWriter() { deflateEnd(&stream_); }
+
+  GzipFileWriter(const GzipFileWriter&) = delete;
+  GzipFileWriter& operator=(const GzipFileWriter&) = delete;
+
+  void write(const uint8_t* data, size_t size) {
+    while (size > 0) {
+      const uInt piece = static_cast<uInt>(std::min<size_t>(size, 1u << 30));
+      stream_.next_in = const_cast<Bytef*>(data);
+      stream_.avail_in = piece;
+      pump(Z_NO_FLUSH);
+      data += piece;
+      size -= piece;
+    }
+  }
+
+  void finish() {
+    stream_.next_in = nullptr;
+    stream_.avail_in = 0;
+    pump(Z_FINISH);
+    out_.flush();
+    if (!out_) {
+      throw std::runtime_error("Failed to write SPZ data");
+    }
+  }
+
+ private:
+  void pump(int flush) {
+    int ret;
+    do {
+      stream_.next_out = buffer_.data();
+      stream_.avail_out = static_cast<uInt>(buffer_.size());
+      ret = deflate(&stream_, flush);
+      if (ret == Z_STREAM_ERROR) {
+        throw std::runtime_error("GZip compression failed");
+      }
+      out_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size() - stream_.avail_out);
+      if (!out_) {
+        throw std::runtime_error("Failed to write SPZ data");
+      }
+    } while (stream_.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+  }
+
+  std::ofstream out_;
+  z_stream stream_{};
+  std::vector<uint8_t> buffer_;
+};
+
+// rounds and saturates; NaN maps to 0
+static uint8_t toUint8(float v) {
+  if (!(v > 0.0f)) return 0;
+  return static_cast<uint8_t>(std::min(std::round(v), 255.0f));
+}
+
+static void putFixed24(float v, float scale, uint8_t* out) {
+  const float f = std::round(v * scale);
+  const int32_t fixed = (f == f) ? static_cast<int32_t>(std::clamp(f, -8388608.0f, 8388607.0f)) : 0;
+  out[0] = static_cast<uint8_t>(fixed & 0xff);
+  out[1] = static_cast<uint8_t>((fixed >> 8) & 0xff);
+  out[2] = static_cast<uint8_t>((fixed >> 16) & 0xff);
+}
+
+// Coarser buckets for the higher bands compress better at negligible visual cost
+static uint8_t quantizeSH(float v, int bucketSize) {
+  int q = toUint8(v * 128.0f + 128.0f);
+  q = (q + bucketSize / 2) / bucketSize * bucketSize;
+  return static_cast<uint8_t>(std::min(q, 255));
+}
+
+// SPZ orders quaternion components x, y, z, w; the table stores w in rot_0
+static void normalizeQuaternion(float w, float x, float y, float z, float q[4]) {
+  const float len = std::sqrt(x * x + y * y + z * z + w * w);
+  if (!(len > 0.0f) || !std::isfinite(len)) {
+    q[0] = q[1] = q[2] = 0.0f;
+    q[3] = 1.0f;
+    return;
+  }
+  q[0] = x / len;
+  q[1] = y / len;
+  q[2] = z / len;
+  q[3] = w / len;
+}
+
+/**
+ * @brief Packs a unit quaternion as its largest component's index (top 2 bits) and the other three
+ * as 9-bit magnitudes with a sign bit, scaled by 1/sqrt(2); the largest is rebuilt from unit length.
+ */
+static uint32_t packSmallestThree(const float q[4]) {
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (std::abs(q[i]) > std::abs(q[largest])) largest = i;
+  }
+
+  // q and -q are the same rotation; flip so the dropped component is positive
+  const bool negate = q[largest] < 0.0f;
+  const float magScale = 511.0f / 0.70710678f;
+
+  uint32_t packed = static_cast<uint32_t>(largest);
+  for (int i = 0; i < 4; ++i) {
+    if (i == largest) continue;
+    const uint32_t negbit = (q[i] < 0.0f) ^ negate;
+    const uint32_t mag = std::min(511u, static_cast<uint32_t>(std::abs(q[i]) * magScale + 0.5f));
+    packed = (packed << 10) | (negbit << 9) | mag;
+  }
+  return packed;
+}
+
+namespace {
+
+/// One field plane of the SPZ payload: bytesPerSplat bytes for every splat, in splat order
+struct SpzPlane {
+  size_t bytesPerSplat;
+  std::function<void(size_t first, size_t count, uint8_t* out)> encode;
+};
+
+}  // namespace
+
+void writeSpz(const std::string& filename, const DataTable* dataTable, const SpzWriteOptions& options) {
+  if (options.version != 2 && options.version != 3) {
+    throw std::invalid_argument("writeSpz: unsupported version " + std::to_string(options.version));
+  }
+  if (options.fractionalBits > 23) {
+    throw std::invalid_argument("writeSpz: fractionalBits must be at most 23");
+  }
+
+  ConstGaussianView view(*dataTable);
+  if (!view.hasPosition() || !view.hasRotation() || !view.hasScale() || !view.hasColor() || !view.hasOpacity()) {
+    throw std::runtime_error("writeSpz: table lacks position, rotation, scale, colour or opacity columns");
+  }
+
+  const size_t numSplats = dataTable->getNumRows();
+  if (numSplats > UINT32_MAX) {
+    throw std::runtime_error("writeSpz: too many splats");
+  }
+
+  // only complete bands are written
+  const int shBands = view.shBands();
+  const size_t coeffsPerChannel = static_cast<size_t>(view.shCoeffsPerChannel());
+
+  const float* x = view.column(GaussianAttr::X);
+  const float* y = view.column(GaussianAttr::Y);
+  const float* z = view.column(GaussianAttr::Z);
+  const float* rot[4] = {view.column(GaussianAttr::ROT_0), view.column(GaussianAttr::ROT_1),
+                         view.column(GaussianAttr::ROT_2), view.column(GaussianAttr::ROT_3)};
+  const float* scale[3] = {view.column(GaussianAttr::SCALE_0), view.column(GaussianAttr::SCALE_1),
+                           view.column(GaussianAttr::SCALE_2)};
+  const float* dc[3] = {view.column(GaussianAttr::F_DC_0), view.column(GaussianAttr::F_DC_1),
+                        view.column(GaussianAttr::F_DC_2)};
+  const float* opacity = view.column(GaussianAttr::OPACITY);
+
+  // f_rest_* is channel-major: coefficient k of channel c is f_rest_(c * coeffsPerChannel + k)
+  std::vector<const float*> restColumns(coeffsPerChannel * 3);
+  for (size_t k = 0; k < restColumns.size(); ++k) {
+    restColumns[k] = view.column(static_cast<GaussianAttr>(gaussianSlot(GaussianAttr::REST_0) + k));
+  }
+
+  const float positionScale = static_cast<float>(1u << options.fractionalBits);
+
+  std::vector<SpzPlane> planes;
+  planes.push_back({9, [&](size_t first, size_t count, uint8_t* out) {
+                      for (size_t i = first; i < first + count; ++i, out += 9) {
+                        putFixed24(x[i], positionScale, out);
+                        putFixed24(y[i], positionScale, out + 3);
+                        putFixed24(z[i], positionScale, out + 6);
+                      }
+                    }});
+  planes.push_back({1, [&](size_t first, size_t count, uint8_t* out) {
+                      for (size_t i = first; i < first + count; ++i) {
+                        *out++ = toUint8(sigmoid(opacity[i]) * 255.0f);
+                      }
+                    }});
+  planes.push_back({3, [&](size_t first, size_t count, uint8_t* out) {
+                      for (size_t i = first; i < first + count; ++i) {
+                        for (int c = 0; c < 3; ++c) {
+                          *out++ = toUint8((dc[c][i] * kSpzColorScale + 0.5f) * 255.0f);
+                        }
+                      }
+                    }});
+  planes.push_back({3, [&](size_t first, size_t count, uint8_t* out) {
+                      for (size_t i = first; i < first + count; ++i) {
+                        for (int c = 0; c < 3; ++c) {
+                          *out++ = toUint8((scale[c][i] + 10.0f) * 16.0f);
+                        }
+                      }
+                    }});
+  if (options.version == 2) {
+    planes.push_back({3, [&](size_t first, size_t count, uint8_t* out) {
+                        float q[4];
+                        for (size_t i = first; i < first + count; ++i) {
+                          normalizeQuaternion(rot[0][i], rot[1][i], rot[2][i], rot[3][i], q);
+                          // w is rebuilt as the positive root, so store the hemisphere with w >= 0
+                          const float s = q[3] < 0.0f ? -127.5f : 127.5f;
+                          for (int c = 0; c < 3; ++c) {
+                            *out++ = toUint8(q[c] * s + 127.5f);
+                          }
+                        }
+                      }});
+  } else {
+    planes.push_back({4, [&](size_t first, size_t count, uint8_t* out) {
+                        float q[4];
+                        for (size_t i = first; i < first + count; ++i, out += 4) {
+                          normalizeQuaternion(rot[0][i], rot[1][i], rot[2][i], rot[3][i], q);
+                          const uint32_t packed = packSmallestThree(q);
+                          std::memcpy(out, &packed, 4);
+                        }
+                      }});
+  }
+  if (coeffsPerChannel > 0) {
+    // SPZ interleaves channels per coefficient, the table stores each channel's coefficients together
+    planes.push_back({coeffsPerChannel * 3, [&](size_t first, size_t count, uint8_t* out) {
+                        for (size_t i = first; i < first + count; ++i) {
+                          for (size_t k = 0; k < coeffsPerChannel; ++k) {
+                            const int bucketSize = k < 3 ? 8 : 16;
+                            for (size_t c = 0; c < 3; ++c) {
+                              *out++ = quantizeSH(restColumns[c * coeffsPerChannel + k][i], bucketSize);
+                            }
+                          }
+                        }
+                      }});
+  }
+
+  GzipFileWriter gzip(filename, options.compressionLevel);
+
+  uint8_t header[kSpzHeaderSize] = {};
+  const uint32_t numPoints = static_cast<uint32_t>(numSplats);
+  std::memcpy(header, &kSpzMagic, 4);
+  std::memcpy(header + 4, &options.version, 4);
+  std::memcpy(header + 8, &numPoints, 4);
+  header[12] = static_cast<uint8_t>(shBands);
+  header[13] = options.fractionalBits;
+  gzip.write(header, kSpzHeaderSize);
+
+  size_t maxBytesPerSplat = 0;
+  for (const auto& plane : planes) {
+    maxBytesPerSplat = std::max(maxBytesPerSplat, plane.bytesPerSplat);
+  }
+  std::vector<uint8_t> staging[2];
+  for (auto& buffer : staging) {
+    buffer.resize(std::min(kSlabSplats, numSplats) * maxBytesPerSplat);
+  }
+
+  const size_t hardwareThreads = std::thread::hardware_concurrency();
+  std::unique_ptr<ThreadPool> pool;
+  if (hardwareThreads > 1 && numSplats > kEncodeGrain) {
+    pool = std::make_unique<ThreadPool>(hardwareThreads);
+  }
+
+  // the I/O thread compresses one slab while the next is encoded into the other staging buffer
+  ThreadPool io(1);
+  std::future<void> pending;
+  size_t current = 0;
+  for (const auto& plane : planes) {
+    for (size_t first = 0; first < numSplats; first += kSlabSplats) {
+      const size_t count = std::min(kSlabSplats, numSplats - first);
+      uint8_t* out = staging[current].data();
+
+      auto encodeRange = [&](size_t lo, size_t hi) {
+        plane.encode(first + lo, hi - lo, out + lo * plane.bytesPerSplat);
+      };
+      if (pool) {
+        pool->parallelFor(0, count, kEncodeGrain, encodeRange);
+      } else {
+        encodeRange(0, count);
+      }
+
+      if (pending.valid()) pending.get();
+      pending = io.enqueue([&gzip, out, size = count * plane.bytesPerSplat] { gzip.write(out, size); });
+      current ^= 1;
+    }
+  }
+  if (pending.valid()) pending.get();
+
+  gzip.finish();
+}
+
+}  // namespace splat
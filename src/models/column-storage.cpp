@@ -0,0 +1,56 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <splat/models/column-storage.h>
+
+namespace splat {
+
+ColumnArena::ColumnArena(size_t capacity) : capacity_(footprint(capacity)) {
+  if (capacity_ > 0) {
+    base_ = static_cast<std::byte*>(::operator new(capacity_, std::align_val_t(kColumnAlignment)));
+  }
+}
+
+ColumnArena::~ColumnArena() {
+  if (base_) {
+    ::operator delete(base_, std::align_val_t(kColumnAlignment));
+  }
+}
+
+void* ColumnArena::allocate(size_t bytes) noexcept {
+  // empty blocks still take one slot so every returned pointer lies inside the slab
+  const size_t size = footprint(bytes == 0 ? 1 : bytes);
+  size_t offset = used_.load(std::memory_order_relaxed);
+  do {
+    if (size > capacity_ - offset) {
+      return nullptr;
+    }
+  } while (!used_.compare_exchange_weak(offset, offset + size, std::memory_order_relaxed));
+  return base_ + offset;
+}
+
+}  // namespace splat
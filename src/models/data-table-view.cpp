@@ -0,0 +1,128 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <splat/models/data-table-view.h>
+
+#include <numeric>
+#include <variant>
+
+namespace splat {
+
+// aliasing constructor with an empty owner: shares the pointer without owning or counting anything
+static std::shared_ptr<const DataTable> borrow(const DataTable& table) {
+  return std::shared_ptr<const DataTable>(std::shared_ptr<const DataTable>(), &table);
+}
+
+DataTableView::DataTableView(std::shared_ptr<const DataTable> base) : base_(std::move(base)) {
+  numRows_ = base_->getNumRows();
+}
+
+DataTableView::DataTableView(std::shared_ptr<const DataTable> base, std::vector<uint32_t> indices)
+    : base_(std::move(base)) {
+  bind(std::move(indices));
+}
+
+DataTableView::DataTableView(const DataTable& base) : DataTableView(borrow(base)) {}
+
+DataTableView::DataTableView(const DataTable& base, std::vector<uint32_t> indices)
+    : DataTableView(borrow(base), std::move(indices)) {}
+
+void DataTableView::bind(std::vector<uint32_t> indices) {
+  const size_t baseRows = base_->getNumRows();
+  numRows_ = indices.size();
+
+  bool contiguous = true;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    if (indices[i] >= baseRows) {
+      throw std::out_of_range("Permutation index out of bounds.");
+    }
+    contiguous = contiguous && indices[i] == indices[0] + i;
+  }
+
+  if (contiguous) {
+    offset_ = indices.empty() ? 0 : indices[0];
+    indices_.reset();
+  } else {
+    offset_ = 0;
+    indices_ = std::make_shared<const std::vector<uint32_t>>(std::move(indices));
+  }
+}
+
+Column DataTableView::gatherColumn(const std::string& name) const {
+  return gatherColumn(base_->getColumnByName(name));
+}
+
+Column DataTableView::gatherColumn(const Column& column) const {
+  TypedArray data = std::visit(
+      [this](const auto& vec) -> TypedArray {
+        using T = typename std::decay_t<decltype(vec)>::value_type;
+        ColumnVector<T> result(numRows_);
+        if (indices_) {
+          const uint32_t* rows = indices_->data();
+          for (size_t i = 0; i < numRows_; ++i) {
+            result[i] = vec[rows[i]];
+          }
+        } else {
+          std::copy_n(vec.begin() + offset_, numRows_, result.begin());
+        }
+        return result;
+      },
+      column.data);
+  return {column.name, std::move(data)};
+}
+
+std::unique_ptr<DataTable> DataTableView::materialize(const std::vector<std::string>& columnNames) const {
+  std::vector<Column> columns;
+  if (columnNames.empty()) {
+    columns.reserve(base_->getNumColumns());
+    for (const auto& column : base_->columns) {
+      columns.emplace_back(gatherColumn(column));
+    }
+  } else {
+    columns.reserve(columnNames.size());
+    for (const auto& name : columnNames) {
+      if (!base_->hasColumn(name)) {
+        throw std::runtime_error("Column not found: " + name);
+      }
+      columns.emplace_back(gatherColumn(name));
+    }
+  }
+  return std::make_unique<DataTable>(std::move(columns));
+}
+
+DataTableView DataTableView::select(const std::vector<uint32_t>& rows) const {
+  std::vector<uint32_t> indices(rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    if (rows[i] >= numRows_) {
+      throw std::out_of_range("Permutation index out of bounds.");
+    }
+    indices[i] = baseRow(rows[i]);
+  }
+  return DataTableView(base_, std::move(indices));
+}
+
+}  // namespace splat
@@ -25,17 +25,107 @@
  *
  ***********************************************************************************/
 
+#include <splat/models/data-table-view.h>
 #include <splat/models/data-table.h>
 
 #include <algorithm>
 #include <cmath>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <variant>
 #include <vector>
 
 namespace splat {
 
-DataTable::DataTable(const std::vector<Column>& columns) {
+namespace {
+
+/**
+ * @brief Process-wide name <-> id registry behind ColumnId
+ *
+ * Names live in a deque so references handed out by ColumnId::name() stay valid as it grows.
+ */
+struct ColumnNameRegistry {
+  std::mutex mutex;
+  absl::flat_hash_map<std::string, uint32_t> ids;
+  std::deque<std::string> names;
+
+  static ColumnNameRegistry& instance() {
+    static ColumnNameRegistry registry;
+    return registry;
+  }
+};
+
+}  // namespace
+
+template <size_t I = 0>
+static TypedArray makeTypedArray(ColumnType type, size_t numRows, const std::shared_ptr<ColumnArena>& arena) {
+  if constexpr (I < std::variant_size_v<TypedArray>) {
+    if (static_cast<size_t>(type) == I) {
+      using Vector = std::variant_alternative_t<I, TypedArray>;
+      using T = typename Vector::value_type;
+      return Vector(numRows, ColumnAllocator<T>(arena));
+    }
+    return makeTypedArray<I + 1>(type, numRows, arena);
+  } else {
+    throw std::invalid_argument("Unsupported column type");
+  }
+}
+
+size_t columnTypeSize(ColumnType type) {
+  switch (type) {
+    case ColumnType::INT8:
+    case ColumnType::UINT8:
+      return 1;
+    case ColumnType::INT16:
+    case ColumnType::UINT16:
+      return 2;
+    case ColumnType::INT32:
+    case ColumnType::UINT32:
+    case ColumnType::FLOAT32:
+      return 4;
+    case ColumnType::FLOAT64:
+      return 8;
+  }
+  throw std::invalid_argument("Unsupported column type");
+}
+
+std::vector<Column> allocateColumns(const std::vector<ColumnSpec>& specs, size_t numRows) {
+  size_t capacity = 0;
+  for (const auto& spec : specs) {
+    capacity += ColumnArena::footprint(numRows * columnTypeSize(spec.type));
+  }
+
+  auto arena = std::make_shared<ColumnArena>(capacity);
+  std::vector<Column> columns;
+  columns.reserve(specs.size());
+  for (const auto& spec : specs) {
+    columns.push_back({spec.name, makeTypedArray(spec.type, numRows, arena)});
+  }
+  return columns;
+}
+
+ColumnId ColumnId::intern(std::string_view name) {
+  auto& registry = ColumnNameRegistry::instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  auto [it, inserted] = registry.ids.try_emplace(std::string(name), static_cast<uint32_t>(registry.names.size()));
+  if (inserted) {
+    registry.names.emplace_back(name);
+  }
+  return ColumnId(it->second);
+}
+
+const std::string& ColumnId::name() const {
+  auto& registry = ColumnNameRegistry::instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  if (value_ >= registry.names.size()) {
+    throw std::out_of_range("invalid column id");
+  }
+  return registry.names[value_];
+}
+
+DataTable::DataTable(std::vector<Column> columns) {
   if (columns.empty()) {
     throw std::runtime_error("DataTable must have at least one column");
   }
@@ -48,6 +138,28 @@ DataTable::DataTable(const std::vector<Column>& columns) {
     }
   }
   this->columns = std::move(columns);
+  reindex();
+}
+
+void DataTable::reindex() {
+  nameIndex_.clear();
+  idIndex_.clear();
+  for (size_t i = 0; i < columns.size(); ++i) {
+    indexColumn(i);
+  }
+}
+
+void DataTable::indexColumn(size_t position) {
+  const std::string& name = columns[position].name;
+  if (!nameIndex_.try_emplace(name, position).second) {
+    return;
+  }
+
+  const uint32_t id = ColumnId::intern(name).value();
+  if (id >= idIndex_.size()) {
+    idIndex_.resize(id + 1, -1);
+  }
+  idIndex_[id] = static_cast<int32_t>(position);
 }
 
 size_t DataTable::getNumRows() const {
@@ -143,14 +255,32 @@ Column& DataTable::getColumn(size_t index) {
 }
 
 int DataTable::getColumnIndex(const std::string& name) const {
-  for (size_t i = 0; i < columns.size(); ++i) {
-    if (columns[i].name == name) {
-      return (int)i;
-    }
+  auto it = nameIndex_.find(name);
+  return it == nameIndex_.end() ? -1 : static_cast<int>(it->second);
+}
+
+int DataTable::getColumnIndex(ColumnId id) const {
+  return id.value() < idIndex_.size() ? idIndex_[id.value()] : -1;
+}
+
+const Column& DataTable::getColumn(ColumnId id) const {
+  int index = getColumnIndex(id);
+  if (index == -1) {
+    throw std::out_of_range("Column not found: " + id.name());
   }
-  return -1;
+  return columns[index];
 }
 
+Column& DataTable::getColumn(ColumnId id) {
+  int index = getColumnIndex(id);
+  if (index == -1) {
+    throw std::out_of_range("Column not found: " + id.name());
+  }
+  return columns[index];
+}
+
+bool DataTable::hasColumn(ColumnId id) const { return getColumnIndex(id) != -1; }
+
 const Column& DataTable::getColumnByName(const std::string& name) const {
   int index = getColumnIndex(name);
   if (index == -1) {
@@ -169,12 +299,13 @@ Column& DataTable::getColumnByName(const std::string& name) {
 
 bool DataTable::hasColumn(const std::string& name) const { return getColumnIndex(name) != -1; }
 
-void DataTable::addColumn(const Column& column) {
+void DataTable::addColumn(Column column) {
   if (columns.size() > 0 && column.length() != getNumRows()) {
     throw std::runtime_error("Column '" + column.name + "' has inconsistent number of rows: expected " +
                              std::to_string(getNumRows()) + ", got " + std::to_string(column.length()));
   }
   columns.push_back(std::move(column));
+  indexColumn(columns.size() - 1);
 }
 
 bool DataTable::removeColumn(const std::string& name) {
@@ -183,6 +314,17 @@ bool DataTable::removeColumn(const std::string& name) {
     return false;
   }
   columns.erase(it, columns.end());
+  reindex();
+  return true;
+}
+
+bool DataTable::renameColumn(const std::string& from, const std::string& to) {
+  int index = getColumnIndex(from);
+  if (index == -1) {
+    return false;
+  }
+  columns[index].name = to;
+  reindex();
   return true;
 }
 
@@ -206,36 +348,11 @@ std::unique_ptr<DataTable> DataTable::clone(const std::vector<std::string>& colu
       }
     }
   }
-  return std::make_unique<DataTable>(cloned_cols);
+  return std::make_unique<DataTable>(std::move(cloned_cols));
 }
 
 std::unique_ptr<DataTable> DataTable::permuteRows(const std::vector<uint32_t>& indices) const {
-  std::vector<Column> new_columns;
-  new_columns.reserve(columns.size());
-  size_t new_length = indices.size();
-  size_t old_len = getNumRows();
-
-  for (const auto& old_col : columns) {
-    TypedArray new_data = std::visit(
-        [&indices, new_length, old_len](const auto& old_vec) -> TypedArray {
-          using T = typename std::decay_t<decltype(old_vec)>::value_type;
-          std::vector<T> new_vec(new_length);
-
-          for (size_t j = 0; j < new_length; j++) {
-            size_t src_index = indices[j];
-            if (src_index >= old_len) {
-              throw std::out_of_range("Permutation index out of bounds.");
-            }
-            new_vec[j] = old_vec[src_index];
-          }
-          return new_vec;
-        },
-        old_col.data);
-
-    new_columns.emplace_back(Column{old_col.name, std::move(new_data)});
-  }
-
-  return std::make_unique<DataTable>(new_columns);
+  return DataTableView(*this, indices).materialize();
 }
 
 }  // namespace splat
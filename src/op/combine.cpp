@@ -49,34 +49,29 @@ std::unique_ptr<DataTable> combine(std::vector<std::unique_ptr<DataTable>>& data
     return -1;
   };
 
-  // make unique list of columns where name and type much match
-  auto&& columns = dataTables[0]->columns;
-  for (int i = 1; i < dataTables.size(); ++i) {
-    const auto& dataTable = dataTables[i];
-    for (int j = 0; j < dataTable->getNumColumns(); ++j) {
-      if (-1 == findMatchingColumn(columns, dataTable->columns[j])) {
-        columns.push_back(dataTable->columns[j]);
-      }
-    }
-  }
-
   // count total number of rows
   size_t totalRows = 0;
   for (auto&& dt : dataTables) {
     totalRows += dt->getNumRows();
   }
 
-  // construct output dataTable
+  // construct output columns from the unique list of input columns, where name and type must match
   std::vector<Column> resultColumns;
-  for (auto&& col : columns) {
-    auto data = std::visit(
-        [totalRows](const auto& vec) -> TypedArray {
-          using T = typename std::decay_t<decltype(vec)>::value_type;
-          return std::vector<T>(totalRows);
-        },
-        col.data);
+  for (auto&& dataTable : dataTables) {
+    for (const auto& col : dataTable->columns) {
+      if (-1 != findMatchingColumn(resultColumns, col)) {
+        continue;
+      }
+      auto data = std::visit(
+          [totalRows](const auto& vec) -> TypedArray {
+            using T = typename std::decay_t<decltype(vec)>::value_type;
+            // rows of tables that lack the column stay zero
+            return ColumnVector<T>(totalRows, T(0));
+          },
+          col.data);
 
-    resultColumns.push_back({col.name, data});
+      resultColumns.push_back({col.name, data});
+    }
   }
 
   // copy data
@@ -85,7 +80,7 @@ std::unique_ptr<DataTable> combine(std::vector<std::unique_ptr<DataTable>>& data
     const auto& dataTable = dataTables[i];
 
     for (int j = 0; j < dataTable->columns.size(); ++j) {
-      const auto column = dataTable->columns[j];
+      const auto& column = dataTable->columns[j];
       int idx = findMatchingColumn(resultColumns, column);
       auto& targetColumn = resultColumns[idx];
       std::memcpy(targetColumn.rawPointer() + rowOffset * targetColumn.bytePreElement(), column.rawPointer(),
@@ -94,7 +89,7 @@ std::unique_ptr<DataTable> combine(std::vector<std::unique_ptr<DataTable>>& data
     rowOffset += dataTable->getNumRows();
   }
 
-  return std::make_unique<DataTable>(resultColumns);
+  return std::make_unique<DataTable>(std::move(resultColumns));
 }
 
 }  // namespace splat
@@ -27,21 +27,15 @@
 
 #include <splat/maths/rotate-sh.h>
 #include <splat/models/data-table.h>
+#include <splat/models/gaussian.h>
 #include <splat/op/transform.h>
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 namespace splat {
 
-// Pre-define SH coefficient column names (f_rest_0 to f_rest_44)
-const std::vector<std::string> shNames = []() {
-  std::vector<std::string> names(45);
-  for (int i = 0; i < 45; ++i) {
-    names[i] = "f_rest_" + std::to_string(i);
-  }
-  return names;
-}();
-
 /**
  * @brief Applies translation, rotation, and scale to all Gaussian points in a DataTable.
  * * @param dataTable The DataTable containing the Gaussian data (positions, rotations, scales, SH).
@@ -67,37 +61,32 @@ void transform(DataTable* dataTable, const Eigen::Vector3f& t, const Eigen::Quat
   RotateSH rotateSH(mat3.cast<float>());  // Use float for Eigen's RotateSH as per assumed definition
 
   // 2. Determine which components exist in the DataTable (Optimization)
-
-  const bool hasTranslation = dataTable->hasColumn("x") && dataTable->hasColumn("y") && dataTable->hasColumn("z");
-  const bool hasRotation = dataTable->hasColumn("rot_0") && dataTable->hasColumn("rot_1") &&
-                           dataTable->hasColumn("rot_2") && dataTable->hasColumn("rot_3");
-  const bool hasScale =
-      dataTable->hasColumn("scale_0") && dataTable->hasColumn("scale_1") && dataTable->hasColumn("scale_2");
-
-  // Determine SH bands and coefficient count
-  // The original logic finds the first missing f_rest_i column to infer the band count.
-  // Index: 0-8 (9 coeffs, L0+L1), 0-23 (24 coeffs, L0-L2), 0-44 (45 coeffs, L0-L3)
-  int missingIndex = -1;
-  for (int i = 0; i < 45; ++i) {
-    if (!dataTable->hasColumn(shNames[i])) {
-      missingIndex = i;
-      break;
+  // GaussianView binds FLOAT32 columns only. Schema columns of another type (e.g. double x/y/z written by
+  // some PLY exporters) are swapped for float copies here and converted back once every row is done.
+  std::vector<std::pair<size_t, TypedArray>> originals;
+  for (const auto& name : kGaussianAttrNames) {
+    const int index = dataTable->getColumnIndex(std::string(name));
+    if (index < 0) continue;
+
+    Column& column = dataTable->getColumn(index);
+    if (column.getType() == ColumnType::FLOAT32) continue;
+
+    ColumnVector<float> values(column.length());
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = column.getValue<float>(i);
     }
+    originals.emplace_back(index, std::exchange(column.data, TypedArray(std::move(values))));
   }
 
-  // Mapping from (first missing index) to (SH Band Index: 0=None, 1=L1, 2=L2, 3=L3)
-  // 45 is total max, 9 is L0+L1, 24 is L0-L2.
-  int shBands = 0;           // 0=None, 1=L1 (9 coeffs), 2=L2 (24 coeffs), 3=L3 (45 coeffs)
-  if (missingIndex == -1) {  // All 45 present (L0-L3)
-    shBands = 3;
-  } else if (missingIndex <= 9) {  // Only L0 (9/3=3 coeffs) or L1 (9 coeffs)
-    // NOTE: The original logic is ambiguous for L0 (1 coeff). Assuming if f_rest_0 to f_rest_8 are present, it is L1.
-    if (missingIndex > 8) {  // f_rest_0 to f_rest_8 are present
-      shBands = 1;
-    } else if (missingIndex > 23) {  // f_rest_0 to f_rest_23 are present
-      shBands = 2;
-    }
-  }
+  // Column offsets are resolved once here; the loop below only indexes the bound columns.
+  GaussianView view(*dataTable);
+
+  const bool hasTranslation = view.hasPosition();
+  const bool hasRotation = view.hasRotation();
+  const bool hasScale = view.hasScale();
+
+  // SH bands: 0=None, 1=L1 (9 coeffs), 2=L2 (24 coeffs), 3=L3 (45 coeffs)
+  const int shBands = view.shBands();
 
   // Number of coefficients per color channel (R, G, B) for the SH bands being rotated (excluding L0)
   // Total L0-L3 coeffs: 1, 3, 8, 15 (per channel)
@@ -111,35 +100,35 @@ void transform(DataTable* dataTable, const Eigen::Vector3f& t, const Eigen::Quat
   // The `f_rest_i` columns hold the L1+ coefficients (total: 3* (n^2 - 1) coeffs)
   // The original JS uses 3, 8, 15 which corresponds to L1, L2, L3 bands *excluding L0*.
   // The array `shCoeffs` holds the coefficients *per color channel* (L1, L2, L3).
-  const int shCoeffsPerChannel = (shBands == 1) ? 3 : (shBands == 2) ? 8 : (shBands == 3) ? 15 : 0;
+  const int shCoeffsPerChannel = view.shCoeffsPerChannel();
 
   if (shBands > 0) {
     std::cout << "Applying SH rotation with " << shBands << " band(s) (" << shCoeffsPerChannel
               << " coeffs per channel)." << "\n";
   }
 
+  // Scale is stored as log(scale). Scale transformation: exp(log(s_old)) * s_global = s_new.
+  // log(s_new) = log(exp(log(s_old)) * s_global) = log(s_old) + log(s_global)
+  const float log_s = std::log(s);
+
   // Temporary buffer for SH coefficients of one color channel
   std::vector<float> shCoeffs(shCoeffsPerChannel);
 
   // 3. Iterate and Transform Rows
-  Row row;
-  for (size_t i = 0; i < dataTable->getNumRows(); ++i) {
-    // Use a temporary map to hold row data for read/write
-    dataTable->getRow(i, row);
+  for (size_t i = 0; i < view.size(); ++i) {
+    GaussianRef g = view[i];
 
     // --- A. Translation (Position) ---
     if (hasTranslation) {
-      Eigen::Vector3f pos(row["x"], row["y"], row["z"]);
-
       // Transform point: v' = M * v
       // Since Eigen's Mat4 * Vec3 (implicitly converting Vec3 to Vec4(v, 1))
       // already performs the correct projective transform (v' = T*R*S*v), we use that.
-      Eigen::Vector4f pos4(pos.x(), pos.y(), pos.z(), 1.0f);
+      Eigen::Vector4f pos4(g.x(), g.y(), g.z(), 1.0f);
       pos4 = mat * pos4;
 
-      row["x"] = pos4.x() / pos4.w();
-      row["y"] = pos4.y() / pos4.w();
-      row["z"] = pos4.z() / pos4.w();
+      g.x() = pos4.x() / pos4.w();
+      g.y() = pos4.y() / pos4.w();
+      g.z() = pos4.z() / pos4.w();
     }
 
     // --- B. Rotation ---
@@ -148,10 +137,10 @@ void transform(DataTable* dataTable, const Eigen::Vector3f& t, const Eigen::Quat
       // then multiplies by the global rotation 'r' (Quat).
       // Original: q.set(row.rot_1, row.rot_2, row.rot_3, row.rot_0).mul2(r, q);
       // Eigen stores Quat as (x, y, z, w) in memory/coefficients.
-      Eigen::Quaternionf q_local(row["rot_0"],  // w
-                                 row["rot_1"],  // x
-                                 row["rot_2"],  // y
-                                 row["rot_3"]   // z
+      Eigen::Quaternionf q_local(g.rot(0),  // w
+                                 g.rot(1),  // x
+                                 g.rot(2),  // y
+                                 g.rot(3)   // z
       );
 
       // The combined rotation: q_global * q_local
@@ -161,21 +150,17 @@ void transform(DataTable* dataTable, const Eigen::Vector3f& t, const Eigen::Quat
       q_combined.normalize();
 
       // Store back using the original (w, x, y, z) column convention
-      row["rot_0"] = q_combined.w();
-      row["rot_1"] = q_combined.x();
-      row["rot_2"] = q_combined.y();
-      row["rot_3"] = q_combined.z();
+      g.rot(0) = q_combined.w();
+      g.rot(1) = q_combined.x();
+      g.rot(2) = q_combined.y();
+      g.rot(3) = q_combined.z();
     }
 
     // --- C. Scale ---
     if (hasScale) {
-      // Scale is stored as log(scale). Scale transformation: exp(log(s_old)) * s_global = s_new.
-      // log(s_new) = log(exp(log(s_old)) * s_global) = log(s_old) + log(s_global)
-      float log_s = std::log(s);
-
-      row["scale_0"] = row["scale_0"] + log_s;
-      row["scale_1"] = row["scale_1"] + log_s;
-      row["scale_2"] = row["scale_2"] + log_s;
+      g.scale(0) += log_s;
+      g.scale(1) += log_s;
+      g.scale(2) += log_s;
     }
 
     // --- D. Spherical Harmonics (SH) Rotation ---
@@ -184,23 +169,28 @@ void transform(DataTable* dataTable, const Eigen::Vector3f& t, const Eigen::Quat
       for (int j = 0; j < 3; ++j) {
         // 1. Load SH coefficients for one channel (R, G, or B)
         for (int k = 0; k < shCoeffsPerChannel; ++k) {
-          const std::string& colName = shNames[k + j * shCoeffsPerChannel];
-          shCoeffs[k] = row[colName];
+          shCoeffs[k] = g.rest(k + j * shCoeffsPerChannel);
         }
 
         // 2. Apply rotation (RotateSH is assumed to operate on the float vector)
         rotateSH.apply(shCoeffs);
 
-        // 3. Store rotated SH coefficients back to the row
+        // 3. Store rotated SH coefficients back in place
         for (int k = 0; k < shCoeffsPerChannel; ++k) {
-          const std::string& colName = shNames[k + j * shCoeffsPerChannel];
-          row[colName] = shCoeffs[k];
+          g.rest(k + j * shCoeffsPerChannel) = shCoeffs[k];
         }
       }
     }
+  }
 
-    // --- E. Final Update ---
-    dataTable->setRow(i, row);
+  // 4. Restore the original storage type of converted columns
+  for (auto& [index, data] : originals) {
+    Column& column = dataTable->getColumn(index);
+    const ColumnVector<float> values = std::move(column.asVector<float>());
+    column.data = std::move(data);
+    for (size_t i = 0; i < values.size(); ++i) {
+      column.setValue<float>(i, values[i]);
+    }
   }
 }
 
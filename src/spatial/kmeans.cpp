@@ -0,0 +1,1135 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <splat/spatial/kmeans.h>
+#include <splat/utils/logger.h>
+#include <splat/utils/threadpool.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <set>
+
+#include "kmeans_backend.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SPLAT_KMEANS_X86 1
+#endif
+
+namespace splat {
+
+// ---------------------------------------------------------------------------------------------
+// CPU assignment backend
+//
+// Points are processed in blocks of kBlock rows. A block is staged as D x kBlock floats so every
+// dimension is one contiguous run of lanes; each centroid coordinate is then broadcast against the
+// whole block. Distances are ranked with |c|^2 - 2 p.c, which orders centroids the same way as the
+// full squared distance because |p|^2 is constant per point.
+//
+// Every kernel accumulates norm + p0*w0 + p1*w1 + ... lane by lane in the same order, with separate
+// multiplies and adds (no FMA contraction), and keeps the first of tied centroids. The AVX-512, AVX2
+// and scalar kernels therefore produce identical labels, so a seeded run gives the same result on any
+// host CPU.
+// ---------------------------------------------------------------------------------------------
+
+static constexpr uint32_t kBlock = 16;
+
+/**
+ * @param pts D * kBlock staged point coordinates
+ * @param weights K * D row-major centroid coordinates pre-multiplied by -2
+ * @param norms K squared centroid norms
+ * @param out kBlock output labels
+ */
+using AssignBlockFn = void (*)(const float* pts, const float* weights, const float* norms, uint32_t K, uint32_t D,
+                               uint32_t* out);
+
+/**
+ * @brief Same inputs as AssignBlockFn, additionally reporting the second nearest centroid
+ * @param runnerUp kBlock output labels of the second nearest centroid (0 when K == 1)
+ */
+using NearestTwoBlockFn = void (*)(const float* pts, const float* weights, const float* norms, uint32_t K,
+                                   uint32_t D, uint32_t* out, uint32_t* runnerUp);
+
+static void assignBlockScalar(const float* pts, const float* weights, const float* norms, uint32_t K, uint32_t D,
+                              uint32_t* out) {
+  float best[kBlock];
+  std::fill(best, best + kBlock, std::numeric_limits<float>::max());
+  std::fill(out, out + kBlock, 0u);
+
+  float acc[kBlock];
+  for (uint32_t c = 0; c < K; ++c) {
+    const float* w = weights + size_t(c) * D;
+    std::fill(acc, acc + kBlock, norms[c]);
+    for (uint32_t d = 0; d < D; ++d) {
+      const float* p = pts + size_t(d) * kBlock;
+      const float wd = w[d];
+      for (uint32_t j = 0; j < kBlock; ++j) {
+        acc[j] += p[j] * wd;
+      }
+    }
+    for (uint32_t j = 0; j < kBlock; ++j) {
+      if (acc[j] < best[j]) {
+        best[j] = acc[j];
+        out[j] = c;
+      }
+    }
+  }
+}
+
+static void nearestTwoBlockScalar(const float* pts, const float* weights, const float* norms, uint32_t K, uint32_t D,
+                                  uint32_t* out, uint32_t* runnerUp) {
+  float best[kBlock];
+  float second[kBlock];
+  std::fill(best, best + kBlock, std::numeric_limits<float>::max());
+  std::fill(second, second + kBlock, std::numeric_limits<float>::max());
+  std::fill(out, out + kBlock, 0u);
+  std::fill(runnerUp, runnerUp + kBlock, 0u);
+
+  float acc[kBlock];
+  for (uint32_t c = 0; c < K; ++c) {
+    const float* w = weights + size_t(c) * D;
+    std::fill(acc, acc + kBlock, norms[c]);
+    for (uint32_t d = 0; d < D; ++d) {
+      const float* p = pts + size_t(d) * kBlock;
+      const float wd = w[d];
+      for (uint32_t j = 0; j < kBlock; ++j) {
+        acc[j] += p[j] * wd;
+      }
+    }
+    for (uint32_t j = 0; j < kBlock; ++j) {
+      if (acc[j] < best[j]) {
+        second[j] = best[j];
+        runnerUp[j] = out[j];
+        best[j] = acc[j];
+        out[j] = c;
+      } else if (acc[j] < second[j]) {
+        second[j] = acc[j];
+        runnerUp[j] = c;
+      }
+    }
+  }
+}
+
+#ifdef SPLAT_KMEANS_X86
+
+// The SIMD kernels are templated on whether they track the runner-up, so the plain assignment and the
+// two-nearest scan used by Hamerly's bounds share one accumulation loop.
+
+struct NearestAvx2 {
+  __m256 best;
+  __m256 second;
+  __m256i idx;
+  __m256i runnerUp;
+};
+
+template <bool kRunnerUp>
+__attribute__((target("avx2"))) static inline void keepNearestAvx2(__m256 dist, uint32_t c, NearestAvx2& n) {
+  const __m256i label = _mm256_set1_epi32(static_cast<int>(c));
+  const __m256 m = _mm256_cmp_ps(dist, n.best, _CMP_LT_OQ);
+  if constexpr (kRunnerUp) {
+    // a new nearest demotes the old one; otherwise dist may still beat the runner-up
+    const __m256 m2 = _mm256_cmp_ps(dist, n.second, _CMP_LT_OQ);
+    n.second = _mm256_blendv_ps(n.second, _mm256_blendv_ps(dist, n.best, m), m2);
+    n.runnerUp = _mm256_blendv_epi8(n.runnerUp, _mm256_blendv_epi8(label, n.idx, _mm256_castps_si256(m)),
+                                    _mm256_castps_si256(m2));
+  }
+  n.best = _mm256_blendv_ps(n.best, dist, m);
+  n.idx = _mm256_blendv_epi8(n.idx, label, _mm256_castps_si256(m));
+}
+
+template <bool kRunnerUp>
+__attribute__((target("avx2"))) static void nearestBlockAvx2(const float* pts, const float* weights,
+                                                                 const float* norms, uint32_t K, uint32_t D,
+                                                                 uint32_t* out, uint32_t* runnerUp) {
+  const __m256 far = _mm256_set1_ps(std::numeric_limits<float>::max());
+  NearestAvx2 n0 = {far, far, _mm256_setzero_si256(), _mm256_setzero_si256()};
+  NearestAvx2 n1 = n0;
+
+  uint32_t c = 0;
+  // two centroids per pass so each staged point vector is loaded once for both
+  for (; c + 1 < K; c += 2) {
+    const float* w0 = weights + size_t(c) * D;
+    const float* w1 = w0 + D;
+    __m256 a00 = _mm256_set1_ps(norms[c]);
+    __m256 a01 = a00;
+    __m256 a10 = _mm256_set1_ps(norms[c + 1]);
+    __m256 a11 = a10;
+    for (uint32_t d = 0; d < D; ++d) {
+      const __m256 p0 = _mm256_loadu_ps(pts + size_t(d) * kBlock);
+      const __m256 p1 = _mm256_loadu_ps(pts + size_t(d) * kBlock + 8);
+      const __m256 b0 = _mm256_set1_ps(w0[d]);
+      const __m256 b1 = _mm256_set1_ps(w1[d]);
+      a00 = _mm256_add_ps(a00, _mm256_mul_ps(p0, b0));
+      a01 = _mm256_add_ps(a01, _mm256_mul_ps(p1, b0));
+      a10 = _mm256_add_ps(a10, _mm256_mul_ps(p0, b1));
+      a11 = _mm256_add_ps(a11, _mm256_mul_ps(p1, b1));
+    }
+    keepNearestAvx2<kRunnerUp>(a00, c, n0);
+    keepNearestAvx2<kRunnerUp>(a01, c, n1);
+    keepNearestAvx2<kRunnerUp>(a10, c + 1, n0);
+    keepNearestAvx2<kRunnerUp>(a11, c + 1, n1);
+  }
+
+  for (; c < K; ++c) {
+    const float* w = weights + size_t(c) * D;
+    __m256 a0 = _mm256_set1_ps(norms[c]);
+    __m256 a1 = a0;
+    for (uint32_t d = 0; d < D; ++d) {
+      const __m256 b = _mm256_set1_ps(w[d]);
+      a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(pts + size_t(d) * kBlock), b));
+      a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(pts + size_t(d) * kBlock + 8), b));
+    }
+    keepNearestAvx2<kRunnerUp>(a0, c, n0);
+    keepNearestAvx2<kRunnerUp>(a1, c, n1);
+  }
+
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), n0.idx);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8), n1.idx);
+  if constexpr (kRunnerUp) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(runnerUp), n0.runnerUp);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(runnerUp + 8), n1.runnerUp);
+  }
+}
+
+static void assignBlockAvx2(const float* pts, const float* weights, const float* norms, uint32_t K, uint32_t D,
+                            uint32_t* out) {
+  nearestBlockAvx2<false>(pts, weights, norms, K, D, out, nullptr);
+}
+
+static void nearestTwoBlockAvx2(const float* pts, const float* weights, const float* norms, uint32_t K, uint32_t D,
+                                uint32_t* out, uint32_t* runnerUp) {
+  nearestBlockAvx2<true>(pts, weights, norms, K, D, out, runnerUp);
+}
+
+struct NearestAvx512 {
+  __m512 best;
+  __m512 second;
+  __m512i idx;
+  __m512i runnerUp;
+};
+
+template <bool kRunnerUp>
+__attribute__((target("avx512f"))) static inline void keepNearestAvx512(__m512 dist, uint32_t c, NearestAvx512& n) {
+  const __m512i label = _mm512_set1_epi32(static_cast<int>(c));
+  const __mmask16 m = _mm512_cmp_ps_mask(dist, n.best, _CMP_LT_OQ);
+  if constexpr (kRunnerUp) {
+    // a new nearest demotes the old one; otherwise dist may still beat the runner-up
+    const __mmask16 m2 = _mm512_cmp_ps_mask(dist, n.second, _CMP_LT_OQ);
+    n.second = _mm512_mask_blend_ps(m2, n.second, _mm512_mask_blend_ps(m, dist, n.best));
+    n.runnerUp = _mm512_mask_blend_epi32(m2, n.runnerUp, _mm512_mask_blend_epi32(m, label, n.idx));
+  }
+  n.best = _mm512_mask_blend_ps(m, n.best, dist);
+  n.idx = _mm512_mask_blend_epi32(m, n.idx, label);
+}
+
+template <bool kRunnerUp>
+__attribute__((target("avx512f"))) static void nearestBlockAvx512(const float* pts, const float* weights,
+                                                                  const float* norms, uint32_t K, uint32_t D,
+                                                                  uint32_t* out, uint32_t* runnerUp) {
+  const __m512 far = _mm512_set1_ps(std::numeric_limits<float>::max());
+  NearestAvx512 n = {far, far, _mm512_setzero_si512(), _mm512_setzero_si512()};
+
+  uint32_t c = 0;
+  // four centroids per pass so each staged point vector is loaded once for all of them
+  for (; c + 3 < K; c += 4) {
+    const float* w0 = weights + size_t(c) * D;
+    const float* w1 = w0 + D;
+    const float* w2 = w1 + D;
+    const float* w3 = w2 + D;
+    __m512 a0 = _mm512_set1_ps(norms[c]);
+    __m512 a1 = _mm512_set1_ps(norms[c + 1]);
+    __m512 a2 = _mm512_set1_ps(norms[c + 2]);
+    __m512 a3 = _mm512_set1_ps(norms[c + 3]);
+    for (uint32_t d = 0; d < D; ++d) {
+      const __m512 p = _mm512_loadu_ps(pts + size_t(d) * kBlock);
+      a0 = _mm512_add_ps(a0, _mm512_mul_ps(p, _mm512_set1_ps(w0[d])));
+      a1 = _mm512_add_ps(a1, _mm512_mul_ps(p, _mm512_set1_ps(w1[d])));
+      a2 = _mm512_add_ps(a2, _mm512_mul_ps(p, _mm512_set1_ps(w2[d])));
+      a3 = _mm512_add_ps(a3, _mm512_mul_ps(p, _mm512_set1_ps(w3[d])));
+    }
+    keepNearestAvx512<kRunnerUp>(a0, c, n);
+    keepNearestAvx512<kRunnerUp>(a1, c + 1, n);
+    keepNearestAvx512<kRunnerUp>(a2, c + 2, n);
+    keepNearestAvx512<kRunnerUp>(a3, c + 3, n);
+  }
+
+  for (; c < K; ++c) {
+    const float* w = weights + size_t(c) * D;
+    __m512 a = _mm512_set1_ps(norms[c]);
+    for (uint32_t d = 0; d < D; ++d) {
+      a = _mm512_add_ps(a, _mm512_mul_ps(_mm512_loadu_ps(pts + size_t(d) * kBlock), _mm512_set1_ps(w[d])));
+    }
+    keepNearestAvx512<kRunnerUp>(a, c, n);
+  }
+
+  _mm512_storeu_si512(out, n.idx);
+  if constexpr (kRunnerUp) {
+    _mm512_storeu_si512(runnerUp, n.runnerUp);
+  }
+}
+
+static void assignBlockAvx512(const float* pts, const float* weights, const float* norms, uint32_t K, uint32_t D,
+                              uint32_t* out) {
+  nearestBlockAvx512<false>(pts, weights, norms, K, D, out, nullptr);
+}
+
+static void nearestTwoBlockAvx512(const float* pts, const float* weights, const float* norms, uint32_t K, uint32_t D,
+                                  uint32_t* out, uint32_t* runnerUp) {
+  nearestBlockAvx512<true>(pts, weights, norms, K, D, out, runnerUp);
+}
+
+#endif  // SPLAT_KMEANS_X86
+
+static AssignBlockFn selectAssignBlock() {
+#ifdef SPLAT_KMEANS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return assignBlockAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return assignBlockAvx2;
+  }
+#endif
+  return assignBlockScalar;
+}
+
+static NearestTwoBlockFn selectNearestTwoBlock() {
+#ifdef SPLAT_KMEANS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return nearestTwoBlockAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return nearestTwoBlockAvx2;
+  }
+#endif
+  return nearestTwoBlockScalar;
+}
+
+/**
+ * @brief Build the row-major -2c weights and squared norms consumed by the block kernels
+ */
+static void prepareCentroids(const float* centroids, uint32_t K, uint32_t D, std::vector<float>& weights,
+                             std::vector<float>& norms) {
+  for (uint32_t c = 0; c < K; ++c) {
+    float norm = 0.f;
+    for (uint32_t d = 0; d < D; ++d) {
+      const float v = centroids[size_t(d) * K + c];
+      weights[size_t(c) * D + d] = -2.f * v;
+      norm += v * v;
+    }
+    norms[c] = norm;
+  }
+}
+
+/**
+ * @brief Copy up to kBlock points into the D x kBlock staging layout, zero-padding unused lanes
+ * @param rows Row indices to gather, or nullptr to take the contiguous rows [base, base + count)
+ */
+static void stageBlock(const std::vector<const float*>& columns, const uint32_t* rows, size_t base, size_t count,
+                       float* pts) {
+  for (size_t d = 0; d < columns.size(); ++d) {
+    float* dst = pts + d * kBlock;
+    if (rows) {
+      for (size_t j = 0; j < count; ++j) {
+        dst[j] = columns[d][rows[j]];
+      }
+    } else {
+      std::memcpy(dst, columns[d] + base, count * sizeof(float));
+    }
+    std::fill(dst + count, dst + kBlock, 0.f);
+  }
+}
+
+static void initializeCentroids1D(const DataTable* dataTable, DataTable* centroids) {
+  float m = std::numeric_limits<float>::infinity();
+  float M = -std::numeric_limits<float>::infinity();
+
+  const auto& data = dataTable->getColumn(0);
+  for (size_t i = 0; i < dataTable->getNumRows(); ++i) {
+    float value = data.getValue<float>(i);
+    if (value < m) m = value;
+    if (value > M) M = value;
+  }
+
+  auto& centroidsData = centroids->getColumn(0);
+  for (size_t i = 0; i < centroids->getNumRows(); ++i) {
+    float value = m + (M - m) * i / (centroids->getNumRows() - 1);
+    centroidsData.setValue<float>(i, value);
+  }
+}
+
+// k-means++ seeding is capped at this many point-dimension-centroid products; larger problems seed on a
+// sample of the rows, or uniformly when the sample would not hold a few rows per cluster
+static constexpr uint64_t kSeedingBudget = uint64_t(1) << 32;
+static constexpr uint64_t kMinSeedRowsPerCluster = 2;
+
+// fixed slice size so the D^2 sums do not depend on the worker count
+static constexpr size_t kSeedSliceRows = 4096;
+
+/**
+ * @brief Seed centroids with k distinct rows drawn uniformly
+ */
+static void initializeCentroidsUniform(const std::vector<const float*>& columns, uint32_t N, DataTable* centroids,
+                                       std::mt19937& gen) {
+  std::uniform_int_distribution<uint32_t> dis(0, N - 1);
+
+  std::set<uint32_t> chosenRows;
+  for (size_t i = 0; i < centroids->getNumRows(); ++i) {
+    uint32_t candidateRow;
+    do {
+      candidateRow = dis(gen);
+    } while (chosenRows.count(candidateRow));
+
+    chosenRows.insert(candidateRow);
+
+    for (size_t d = 0; d < columns.size(); ++d) {
+      centroids->getColumn(d).asSpan<float>()[i] = columns[d][candidateRow];
+    }
+  }
+}
+
+/**
+ * @brief k-means++ seeding: each centroid is drawn with probability proportional to the squared
+ * distance to the nearest centroid chosen so far
+ *
+ * Runs on a stratified sample of the rows when the full table exceeds kSeedingBudget.
+ *
+ * @return false if the budget does not allow a meaningful sample; centroids are left untouched
+ */
+static bool initializeCentroidsPlusPlus(const std::vector<const float*>& columns, uint32_t N, DataTable* centroids,
+                                        std::mt19937& gen, ThreadPool& pool) {
+  const uint32_t K = static_cast<uint32_t>(centroids->getNumRows());
+  const uint32_t D = static_cast<uint32_t>(columns.size());
+  if (K == 0 || D == 0) {
+    return true;
+  }
+
+  const uint64_t affordable = kSeedingBudget / (uint64_t(K) * D);
+  if (affordable < kMinSeedRowsPerCluster * K) {
+    return false;
+  }
+  const uint32_t S = static_cast<uint32_t>(std::min<uint64_t>(N, affordable));
+
+  // stage the sampled rows column-major
+  std::vector<float> sample(size_t(S) * D);
+  {
+    std::vector<uint32_t> rows(S);
+    std::uniform_real_distribution<double> offset(0.0, 1.0);
+    for (uint32_t i = 0; i < S; ++i) {
+      rows[i] = S == N ? i : std::min(N - 1, static_cast<uint32_t>((i + offset(gen)) * static_cast<double>(N) / S));
+    }
+    for (uint32_t d = 0; d < D; ++d) {
+      float* dst = sample.data() + size_t(d) * S;
+      for (uint32_t i = 0; i < S; ++i) {
+        dst[i] = columns[d][rows[i]];
+      }
+    }
+  }
+
+  const size_t numSlices = (S + kSeedSliceRows - 1) / kSeedSliceRows;
+  std::vector<float> minDist(S, std::numeric_limits<float>::max());
+  std::vector<double> sliceSums(numSlices);
+  std::vector<float> centroid(D);
+
+  auto setCentroid = [&](uint32_t c, uint32_t i) {
+    for (uint32_t d = 0; d < D; ++d) {
+      centroid[d] = sample[size_t(d) * S + i];
+      centroids->getColumn(d).asSpan<float>()[c] = centroid[d];
+    }
+  };
+
+  setCentroid(0, std::uniform_int_distribution<uint32_t>(0, S - 1)(gen));
+
+  for (uint32_t c = 1; c < K; ++c) {
+    // fold the previous centroid into the nearest distances and total them per slice
+    pool.parallelFor(0, numSlices, 1, [&](size_t sliceBegin, size_t sliceEnd) {
+      float acc[kBlock];
+      for (size_t slice = sliceBegin; slice < sliceEnd; ++slice) {
+        const size_t end = std::min<size_t>(S, (slice + 1) * kSeedSliceRows);
+        double sum = 0.0;
+        for (size_t base = slice * kSeedSliceRows; base < end; base += kBlock) {
+          const size_t count = std::min<size_t>(kBlock, end - base);
+          std::fill(acc, acc + kBlock, 0.f);
+          for (uint32_t d = 0; d < D; ++d) {
+            const float* p = sample.data() + size_t(d) * S + base;
+            const float cd = centroid[d];
+            for (size_t j = 0; j < count; ++j) {
+              const float v = p[j] - cd;
+              acc[j] += v * v;
+            }
+          }
+          for (size_t j = 0; j < count; ++j) {
+            minDist[base + j] = std::min(minDist[base + j], acc[j]);
+            sum += minDist[base + j];
+          }
+        }
+        sliceSums[slice] = sum;
+      }
+    });
+
+    const double total = std::accumulate(sliceSums.begin(), sliceSums.end(), 0.0);
+    if (!(total > 0.0)) {
+      // every sampled row already coincides with a centroid
+      setCentroid(c, std::uniform_int_distribution<uint32_t>(0, S - 1)(gen));
+      continue;
+    }
+
+    // locate the drawn mass slice first, then row by row inside the slice
+    double target = std::uniform_real_distribution<double>(0.0, total)(gen);
+    size_t slice = 0;
+    while (slice + 1 < numSlices && target >= sliceSums[slice]) {
+      target -= sliceSums[slice++];
+    }
+    const size_t end = std::min<size_t>(S, (slice + 1) * kSeedSliceRows);
+    size_t chosen = end - 1;
+    for (size_t i = slice * kSeedSliceRows; i < end; ++i) {
+      if (minDist[i] > 0.f && target < minDist[i]) {
+        chosen = i;
+        break;
+      }
+      target -= minDist[i];
+    }
+    setCentroid(c, static_cast<uint32_t>(chosen));
+  }
+
+  return true;
+}
+
+namespace {
+
+class CpuAssigner : public KMeansAssigner {
+ public:
+  CpuAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K, ThreadPool& pool)
+      : columns_(columns),
+        N_(N),
+        K_(K),
+        D_(static_cast<uint32_t>(columns.size())),
+        weights_(size_t(K) * columns.size()),
+        norms_(K),
+        assignBlock_(selectAssignBlock()),
+        pool_(pool) {}
+
+  const char* name() const override { return "CPU"; }
+
+  uint64_t assign(const float* centroids, uint32_t* labels) override {
+    prepareCentroids(centroids, K_, D_, weights_, norms_);
+
+    // a few chunks per worker keeps the pool balanced without shrinking chunks below a useful size
+    const size_t numBlocks = (N_ + kBlock - 1) / kBlock;
+    const size_t grainBlocks = std::max<size_t>(16, numBlocks / (pool_.getWorkerCount() * 4 + 1));
+
+    pool_.parallelFor(0, numBlocks, grainBlocks, [&](size_t blockBegin, size_t blockEnd) {
+      std::vector<float> pts(size_t(D_) * kBlock, 0.f);
+      uint32_t out[kBlock];
+
+      for (size_t b = blockBegin; b < blockEnd; ++b) {
+        const size_t base = b * kBlock;
+        const size_t count = std::min<size_t>(kBlock, N_ - base);
+        stageBlock(columns_, nullptr, base, count, pts.data());
+        assignBlock_(pts.data(), weights_.data(), norms_.data(), K_, D_, out);
+        std::memcpy(labels + base, out, count * sizeof(uint32_t));
+      }
+    });
+
+    return uint64_t(N_) * K_;
+  }
+
+ private:
+  std::vector<const float*> columns_;
+  uint32_t N_;
+  uint32_t K_;
+  uint32_t D_;
+  std::vector<float> weights_;
+  std::vector<float> norms_;
+  AssignBlockFn assignBlock_;
+  ThreadPool& pool_;
+};
+
+/**
+ * @brief Hamerly's bounded assignment
+ *
+ * Each point keeps an upper bound on the distance to its assigned centroid and a lower bound on the
+ * distance to every other centroid. After the centroids move, the bounds are loosened by the centroid
+ * shifts; a point whose upper bound stays below max(lower bound, half the distance from its centroid to
+ * the nearest other centroid) cannot change cluster and is skipped. Points that fail the test are
+ * rescanned in staged blocks, so the output matches brute-force assignment.
+ */
+class HamerlyAssigner : public KMeansAssigner {
+ public:
+  HamerlyAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K, ThreadPool& pool)
+      : columns_(columns),
+        N_(N),
+        K_(K),
+        D_(static_cast<uint32_t>(columns.size())),
+        weights_(size_t(K) * columns.size()),
+        norms_(K),
+        previous_(size_t(K) * columns.size()),
+        shift_(K),
+        halfSeparation_(K),
+        assignment_(N),
+        upper_(N),
+        lower_(N),
+        nearestTwoBlock_(selectNearestTwoBlock()),
+        pool_(pool) {}
+
+  const char* name() const override { return "CPU/hamerly"; }
+
+  uint64_t assign(const float* centroids, uint32_t* labels) override {
+    prepareCentroids(centroids, K_, D_, weights_, norms_);
+
+    const size_t grain = std::max<size_t>(4096, N_ / (pool_.getWorkerCount() * 4 + 1));
+    std::atomic<uint64_t> computed{0};
+
+    if (first_) {
+      pool_.parallelFor(0, N_, grain, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> rows(end - begin);
+        std::iota(rows.begin(), rows.end(), static_cast<uint32_t>(begin));
+        rescan(rows, centroids);
+      });
+      computed = uint64_t(N_) * K_;
+      first_ = false;
+    } else {
+      updateMotion(centroids);
+
+      // the largest shift loosens every lower bound, except for points owned by that centroid
+      const auto maxIt = std::max_element(shift_.begin(), shift_.end());
+      const uint32_t maxShiftIdx = static_cast<uint32_t>(std::distance(shift_.begin(), maxIt));
+      float secondShift = 0.f;
+      for (uint32_t c = 0; c < K_; ++c) {
+        if (c != maxShiftIdx) secondShift = std::max(secondShift, shift_[c]);
+      }
+      const float maxShift = *maxIt;
+
+      pool_.parallelFor(0, N_, grain, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> pending;
+        uint64_t local = 0;
+
+        for (size_t i = begin; i < end; ++i) {
+          const uint32_t a = assignment_[i];
+          upper_[i] += shift_[a];
+          lower_[i] -= (a == maxShiftIdx) ? secondShift : maxShift;
+
+          const float bound = std::max(halfSeparation_[a], lower_[i]);
+          if (upper_[i] <= bound) continue;
+
+          // tighten the upper bound before paying for a full scan
+          upper_[i] = distance(static_cast<uint32_t>(i), centroids, a);
+          local++;
+          if (upper_[i] <= bound) continue;
+
+          pending.push_back(static_cast<uint32_t>(i));
+        }
+
+        local += uint64_t(pending.size()) * K_;
+        rescan(pending, centroids);
+        computed += local;
+      });
+    }
+
+    std::copy(centroids, centroids + previous_.size(), previous_.begin());
+    std::copy(assignment_.begin(), assignment_.end(), labels);
+    return computed;
+  }
+
+ private:
+  float distance(uint32_t row, const float* centroids, uint32_t c) const {
+    float sum = 0.f;
+    for (uint32_t d = 0; d < D_; ++d) {
+      const float v = columns_[d][row] - centroids[size_t(d) * K_ + c];
+      sum += v * v;
+    }
+    return std::sqrt(sum);
+  }
+
+  // full scan of the given rows, resetting their assignment and both bounds
+  void rescan(const std::vector<uint32_t>& rows, const float* centroids) {
+    std::vector<float> pts(size_t(D_) * kBlock, 0.f);
+    uint32_t out[kBlock];
+    uint32_t runnerUp[kBlock];
+
+    for (size_t base = 0; base < rows.size(); base += kBlock) {
+      const size_t count = std::min<size_t>(kBlock, rows.size() - base);
+      stageBlock(columns_, rows.data() + base, 0, count, pts.data());
+      nearestTwoBlock_(pts.data(), weights_.data(), norms_.data(), K_, D_, out, runnerUp);
+
+      // the expanded form used for ranking loses precision close to a centroid, so the bounds
+      // themselves are recomputed directly
+      for (size_t j = 0; j < count; ++j) {
+        const uint32_t row = rows[base + j];
+        assignment_[row] = out[j];
+        upper_[row] = distance(row, centroids, out[j]);
+        lower_[row] = K_ > 1 ? distance(row, centroids, runnerUp[j]) : std::numeric_limits<float>::max();
+      }
+    }
+  }
+
+  // per-centroid movement since the last call and half the distance to each centroid's nearest neighbour
+  void updateMotion(const float* centroids) {
+    pool_.parallelFor(0, K_, 64, [&](size_t begin, size_t end) {
+      for (size_t c = begin; c < end; ++c) {
+        float sum = 0.f;
+        for (uint32_t d = 0; d < D_; ++d) {
+          const float v = centroids[size_t(d) * K_ + c] - previous_[size_t(d) * K_ + c];
+          sum += v * v;
+        }
+        shift_[c] = std::sqrt(sum);
+
+        // weights_ holds -2c, so the pairwise distance is scaled by 2 and |w0 - w1| / 4 is half of it
+        const float* w0 = weights_.data() + c * D_;
+        float nearest = std::numeric_limits<float>::max();
+        for (uint32_t o = 0; o < K_; ++o) {
+          if (o == c) continue;
+          const float* w1 = weights_.data() + size_t(o) * D_;
+          float dist = 0.f;
+          for (uint32_t d = 0; d < D_; ++d) {
+            const float v = w0[d] - w1[d];
+            dist += v * v;
+          }
+          nearest = std::min(nearest, dist);
+        }
+        halfSeparation_[c] = K_ > 1 ? std::sqrt(nearest) * 0.25f : std::numeric_limits<float>::max();
+      }
+    });
+  }
+
+  std::vector<const float*> columns_;
+  uint32_t N_;
+  uint32_t K_;
+  uint32_t D_;
+  std::vector<float> weights_;
+  std::vector<float> norms_;
+  std::vector<float> previous_;
+  std::vector<float> shift_;
+  std::vector<float> halfSeparation_;
+  std::vector<uint32_t> assignment_;
+  std::vector<float> upper_;
+  std::vector<float> lower_;
+  NearestTwoBlockFn nearestTwoBlock_;
+  bool first_ = true;
+  ThreadPool& pool_;
+};
+
+}  // namespace
+
+std::unique_ptr<KMeansAssigner> createCpuAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K,
+                                                  ThreadPool& pool) {
+  return std::make_unique<CpuAssigner>(columns, N, K, pool);
+}
+
+std::unique_ptr<KMeansAssigner> createHamerlyAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K,
+                                                      ThreadPool& pool) {
+  return std::make_unique<HamerlyAssigner>(columns, N, K, pool);
+}
+
+// Auto picks Hamerly only up to this many dimensions. Beyond it the bounds skip too few distances (about a
+// third at 3D, a few percent on 45D SH palettes) to pay for their upkeep, and brute force is faster.
+static constexpr size_t kHamerlyMaxDims = 2;
+
+static std::unique_ptr<KMeansAssigner> createAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K,
+                                                      KMeansDevice device, KMeansAlgorithm algorithm,
+                                                      ThreadPool& pool) {
+  static std::once_flag fallbackWarning;
+
+  // the bounds are host-side state, so the bounded variant always runs on the CPU
+  if (algorithm == KMeansAlgorithm::Hamerly) {
+    return createHamerlyAssigner(columns, N, K, pool);
+  }
+
+#ifdef SPLAT_ENABLE_CUDA
+  if (device != KMeansDevice::CPU && cudaAssignerAvailable()) {
+    return createCudaAssigner(columns, N, K);
+  }
+  if (device == KMeansDevice::GPU) {
+    std::call_once(fallbackWarning, [] { LOG_WARN("no CUDA device available, running k-means on the CPU"); });
+  }
+#else
+  if (device == KMeansDevice::GPU) {
+    std::call_once(fallbackWarning, [] { LOG_WARN("built without CUDA, running k-means on the CPU"); });
+  }
+#endif
+
+  if (algorithm == KMeansAlgorithm::Auto && columns.size() <= kHamerlyMaxDims) {
+    return createHamerlyAssigner(columns, N, K, pool);
+  }
+  return createCpuAssigner(columns, N, K, pool);
+}
+
+/**
+ * @brief Parallel centroid update over the float columns
+ *
+ * The sums are split into (row chunk, dimension) tiles. Tile boundaries depend only on N and D, never on
+ * the worker count, and the chunk partials are merged in chunk order, so the result is bit-identical
+ * however many threads run it. All scratch space is allocated once per k-means run.
+ */
+class CentroidUpdater {
+ public:
+  CentroidUpdater(const std::vector<const float*>& columns, uint32_t N, uint32_t K, ThreadPool& pool)
+      : columns_(columns), N_(N), K_(K), D_(static_cast<uint32_t>(columns.size())), pool_(pool) {
+    // split rows only when there are too few dimensions to keep the workers busy
+    const size_t maxChunks = std::max<size_t>(1, (N_ + kMinChunkRows - 1) / kMinChunkRows);
+    numChunks_ = std::min<size_t>(maxChunks, (kTargetTiles + D_ - 1) / D_);
+    chunkRows_ = (N_ + numChunks_ - 1) / numChunks_;
+
+    sums_.resize(numChunks_ * D_ * K_);
+    counts_.resize(numChunks_ * K_);
+    totalCounts_.resize(K_);
+  }
+
+  /**
+   * @brief Replace every centroid by the mean of its points, reseeding empty clusters to random points
+   * @return true if any centroid coordinate changed
+   */
+  bool update(const uint32_t* labels, DataTable* centroids, std::mt19937& gen) {
+    pool_.parallelFor(0, numChunks_ * D_, 1, [&](size_t tileBegin, size_t tileEnd) {
+      for (size_t tile = tileBegin; tile < tileEnd; ++tile) {
+        const size_t chunk = tile / D_;
+        const uint32_t d = static_cast<uint32_t>(tile % D_);
+        const size_t rowBegin = chunk * chunkRows_;
+        const size_t rowEnd = std::min<size_t>(N_, rowBegin + chunkRows_);
+
+        double* sums = sums_.data() + (chunk * D_ + d) * K_;
+        std::fill(sums, sums + K_, 0.0);
+        const float* column = columns_[d];
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+          sums[labels[i]] += column[i];
+        }
+
+        if (d == 0) {
+          uint32_t* counts = counts_.data() + chunk * K_;
+          std::fill(counts, counts + K_, 0u);
+          for (size_t i = rowBegin; i < rowEnd; ++i) {
+            counts[labels[i]]++;
+          }
+        }
+      }
+    });
+
+    for (uint32_t c = 0; c < K_; ++c) {
+      uint64_t total = 0;
+      for (size_t chunk = 0; chunk < numChunks_; ++chunk) {
+        total += counts_[chunk * K_ + c];
+      }
+      totalCounts_[c] = total;
+    }
+
+    std::atomic<bool> changed{false};
+    pool_.parallelFor(0, D_, 1, [&](size_t dBegin, size_t dEnd) {
+      for (size_t d = dBegin; d < dEnd; ++d) {
+        auto centroid = centroids->getColumn(d).asSpan<float>();
+        bool columnChanged = false;
+        for (uint32_t c = 0; c < K_; ++c) {
+          if (totalCounts_[c] == 0) continue;
+          double sum = 0.0;
+          for (size_t chunk = 0; chunk < numChunks_; ++chunk) {
+            sum += sums_[(chunk * D_ + d) * K_ + c];
+          }
+          const float mean = static_cast<float>(sum / totalCounts_[c]);
+          columnChanged |= mean != centroid[c];
+          centroid[c] = mean;
+        }
+        if (columnChanged) changed = true;
+      }
+    });
+
+    // re-seed empty clusters to a random point to avoid zero vectors; serial so the draws stay ordered
+    std::uniform_int_distribution<uint32_t> dis(0, N_ - 1);
+    for (uint32_t c = 0; c < K_; ++c) {
+      if (totalCounts_[c] != 0) continue;
+      const uint32_t idx = dis(gen);
+      for (uint32_t d = 0; d < D_; ++d) {
+        centroids->getColumn(d).asSpan<float>()[c] = columns_[d][idx];
+      }
+      changed = true;
+    }
+
+    return changed;
+  }
+
+ private:
+  static constexpr size_t kMinChunkRows = 1 << 16;
+  static constexpr size_t kTargetTiles = 64;
+
+  std::vector<const float*> columns_;
+  uint32_t N_;
+  uint32_t K_;
+  uint32_t D_;
+  size_t numChunks_;
+  size_t chunkRows_;
+  std::vector<double> sums_;      ///< [chunk][dimension][centroid]
+  std::vector<uint32_t> counts_;  ///< [chunk][centroid]
+  std::vector<uint64_t> totalCounts_;
+  ThreadPool& pool_;
+};
+
+/**
+ * @brief Fit centroids on mini-batches of sampled rows (Sculley's web-scale k-means)
+ *
+ * Each step assigns one batch against the current centroids and moves every touched centroid towards
+ * the batch mean with a per-centroid learning rate of batchCount / totalCount, so centroids settle as
+ * they accumulate samples.
+ *
+ * @return Number of distances evaluated
+ */
+static uint64_t runMiniBatch(const std::vector<const float*>& columns, uint32_t N, DataTable* centroids,
+                             size_t iterations, const KMeansOptions& options, std::mt19937& gen, ThreadPool& pool) {
+  const uint32_t K = static_cast<uint32_t>(centroids->getNumRows());
+  const uint32_t D = static_cast<uint32_t>(columns.size());
+  const uint32_t B = static_cast<uint32_t>(options.batchSize);
+
+  std::vector<std::vector<float>> sample(D, std::vector<float>(B));
+  std::vector<const float*> sampleColumns(D);
+  for (uint32_t d = 0; d < D; ++d) {
+    sampleColumns[d] = sample[d].data();
+  }
+
+  // batches are small, so they are always assigned on the host; the sample buffers are refilled in place
+  std::unique_ptr<KMeansAssigner> assigner = createCpuAssigner(sampleColumns, B, K, pool);
+
+  std::vector<uint32_t> rows(B);
+  std::vector<uint32_t> labels(B);
+  std::vector<float> centroidsColMajor(size_t(K) * D);
+  std::vector<uint64_t> totalCounts(K, 0);
+  std::vector<uint32_t> batchCounts(K);
+  std::vector<double> batchSums(size_t(K) * D);
+  uint64_t computed = 0;
+
+  std::uniform_int_distribution<uint32_t> anyRow(0, N - 1);
+  std::uniform_real_distribution<double> offset(0.0, 1.0);
+
+  for (size_t step = 0; step < iterations; ++step) {
+    if (options.sampling == KMeansSampling::Stratified) {
+      // one row from each of B equal slices of the table
+      for (uint32_t i = 0; i < B; ++i) {
+        const double pos = (i + offset(gen)) * static_cast<double>(N) / B;
+        rows[i] = std::min(N - 1, static_cast<uint32_t>(pos));
+      }
+    } else {
+      for (uint32_t i = 0; i < B; ++i) {
+        rows[i] = anyRow(gen);
+      }
+    }
+
+    for (uint32_t d = 0; d < D; ++d) {
+      for (uint32_t i = 0; i < B; ++i) {
+        sample[d][i] = columns[d][rows[i]];
+      }
+      const auto& colData = centroids->getColumn(d).asVector<float>();
+      std::copy(colData.begin(), colData.end(), centroidsColMajor.begin() + size_t(d) * K);
+    }
+
+    computed += assigner->assign(centroidsColMajor.data(), labels.data());
+
+    std::fill(batchCounts.begin(), batchCounts.end(), 0u);
+    std::fill(batchSums.begin(), batchSums.end(), 0.0);
+    for (uint32_t i = 0; i < B; ++i) {
+      const uint32_t c = labels[i];
+      batchCounts[c]++;
+      for (uint32_t d = 0; d < D; ++d) {
+        batchSums[size_t(d) * K + c] += sample[d][i];
+      }
+    }
+
+    for (uint32_t d = 0; d < D; ++d) {
+      auto centroid = centroids->getColumn(d).asSpan<float>();
+      for (uint32_t c = 0; c < K; ++c) {
+        if (batchCounts[c] == 0) continue;
+        const double mean = batchSums[size_t(d) * K + c] / batchCounts[c];
+        const double eta = static_cast<double>(batchCounts[c]) / (totalCounts[c] + batchCounts[c]);
+        centroid[c] = static_cast<float>(centroid[c] + eta * (mean - centroid[c]));
+      }
+    }
+    for (uint32_t c = 0; c < K; ++c) {
+      totalCounts[c] += batchCounts[c];
+    }
+
+    std::cout << "#";
+  }
+
+  return computed;
+}
+
+std::pair<std::unique_ptr<DataTable>, std::vector<uint32_t>> kmeans(DataTable* points, size_t k, size_t iterations,
+                                                                    const KMeansOptions& options) {
+  // too few data points
+  if (points->getNumRows() < k) {
+    std::vector<uint32_t> labels(points->getNumRows(), 0);
+    std::iota(labels.begin(), labels.end(), 0);
+    return {points->clone(), labels};
+  }
+
+  std::unique_ptr<DataTable> centroids = std::make_unique<DataTable>();
+  for (auto& c : points->columns) {
+    centroids->addColumn({c.name, ColumnVector<float>(k, 0.0f)});
+  }
+
+  std::vector<uint32_t> labels(points->getNumRows(), 0);
+
+  bool converged = false;
+  size_t steps = 0;
+
+  std::cout << "Running k-means clustering: dims=" << points->getNumColumns() << " points=" << points->getNumRows()
+            << " clusters=" << k << " iterations=" << iterations << "..." << "\n";
+
+  const uint32_t N = points->getNumRows();
+  const uint32_t K = k;
+  const uint32_t D = points->getNumColumns();
+
+  std::vector<const float*> columns(D);
+  for (uint32_t d = 0; d < D; ++d) {
+    columns[d] = points->getColumn(d).asVector<float>().data();
+  }
+
+  // mini-batch fitting is only worthwhile when a batch is a strict subset of the table
+  const bool miniBatch = options.batchSize > 0 && options.batchSize < N;
+
+  // share the caller's workers when given, so nested callers do not oversubscribe the host
+  std::unique_ptr<ThreadPool> ownedPool;
+  if (!options.pool) {
+    ownedPool = std::make_unique<ThreadPool>();
+  }
+  ThreadPool& pool = options.pool ? *options.pool : *ownedPool;
+
+  // a single final pass gains nothing from bounds, so mini-batch runs finish with brute force
+  std::unique_ptr<KMeansAssigner> assigner =
+      createAssigner(columns, N, K, options.device, miniBatch ? KMeansAlgorithm::Lloyd : options.algorithm, pool);
+  std::vector<float> centroidsColMajor(size_t(K) * D);
+
+  // one generator drives seeding, sampling and empty-cluster reseeding, so the seed fixes the result
+  std::seed_seq seq{static_cast<uint32_t>(options.seed), static_cast<uint32_t>(options.seed >> 32)};
+  std::mt19937 gen(seq);
+
+  auto start_init = std::chrono::high_resolution_clock::now();
+  const char* init = "linear";
+  if (D == 1) {
+    initializeCentroids1D(points, centroids.get());
+  } else if (initializeCentroidsPlusPlus(columns, N, centroids.get(), gen, pool)) {
+    init = "k-means++";
+  } else {
+    initializeCentroidsUniform(columns, N, centroids.get(), gen);
+    init = "uniform";
+  }
+  auto end_init = std::chrono::high_resolution_clock::now();
+  std::cout << "init: " << init << " seed=" << options.seed << " in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end_init - start_init).count() << "ms\n";
+
+  uint64_t distanceComputations = 0;
+  std::chrono::milliseconds assignTotal{0};
+  std::chrono::milliseconds updateTotal{0};
+
+  auto start_total = std::chrono::high_resolution_clock::now();
+
+  if (miniBatch) {
+    std::cout << "mini-batch: batch=" << options.batchSize
+              << (options.sampling == KMeansSampling::Stratified ? " stratified " : " random ");
+    distanceComputations += runMiniBatch(columns, N, centroids.get(), iterations, options, gen, pool);
+    std::cout << "\n";
+
+    // one full assignment against the fitted centroids
+    for (uint32_t d = 0; d < D; ++d) {
+      const auto& colData = centroids->getColumn(d).asVector<float>();
+      std::copy(colData.begin(), colData.end(), centroidsColMajor.begin() + size_t(d) * K);
+    }
+    distanceComputations += assigner->assign(centroidsColMajor.data(), labels.data());
+
+    steps = iterations;
+    converged = true;
+  }
+
+  std::unique_ptr<CentroidUpdater> updater =
+      miniBatch ? nullptr : std::make_unique<CentroidUpdater>(columns, N, K, pool);
+
+  while (!converged) {
+    auto start_iter = std::chrono::high_resolution_clock::now();
+
+    for (uint32_t d = 0; d < D; ++d) {
+      const auto& colData = centroids->getColumn(d).asVector<float>();
+      std::copy(colData.begin(), colData.end(), centroidsColMajor.begin() + size_t(d) * K);
+    }
+
+    distanceComputations += assigner->assign(centroidsColMajor.data(), labels.data());
+
+    auto mid_iter = std::chrono::high_resolution_clock::now();
+
+    // calculate the new centroid positions
+    const bool centroidChanged = updater->update(labels.data(), centroids.get(), gen);
+
+    steps++;
+
+    auto end_iter = std::chrono::high_resolution_clock::now();
+    auto iter_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_iter - start_iter);
+    auto assign_duration = std::chrono::duration_cast<std::chrono::milliseconds>(mid_iter - start_iter);
+    auto update_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_iter - mid_iter);
+
+    assignTotal += assign_duration;
+    updateTotal += update_duration;
+
+    if (!centroidChanged || steps >= iterations) {
+      converged = true;
+      std::cout << "# (converged)";
+    } else {
+      std::cout << "#";
+    }
+
+    std::cout << " [iter " << steps << ": assign(" << assigner->name() << ")=" << assign_duration.count()
+              << "ms, update=" << update_duration.count() << "ms, total=" << iter_duration.count() << "ms]\n";
+  }
+
+  if (steps > 0 && !miniBatch) {
+    std::cout << "average per iteration: assign=" << assignTotal.count() / steps
+              << "ms, update=" << updateTotal.count() / steps << "ms\n";
+  }
+
+  auto end_total = std::chrono::high_resolution_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_total - start_total);
+
+  const uint64_t bruteForce = uint64_t(N) * K * steps;
+  const uint64_t skipped = bruteForce - std::min(bruteForce, distanceComputations);
+
+  std::cout << "k-means completed in " << duration.count() << "ms total";
+  if (skipped > 0) {
+    std::cout << " (skipped " << skipped << " of " << bruteForce << " distance computations)";
+  }
+  std::cout << "\n";
+
+  if (options.stats) {
+    options.stats->iterations = steps;
+    options.stats->distanceComputations = distanceComputations;
+    options.stats->skippedDistanceComputations = skipped;
+  }
+
+  return {std::move(centroids), labels};
+}
+
+}  // namespace splat
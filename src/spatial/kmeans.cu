@@ -26,87 +26,13 @@
 #include <cuda_runtime.h>
 #include <device_functions.h>
 #include <device_launch_parameters.h>
-#include <splat/maths/maths.h>
-#include <splat/spatial/kdtree.h>
-#include <splat/spatial/kmeans.h>
 
-#include <chrono>
-#include <iostream>
-#include <numeric>
-#include <random>
-#include <set>
+#include <cstring>
+#include <vector>
 
-namespace splat {
-
-static std::vector<std::vector<int>> groupLabels(const std::vector<uint32_t>& labels, int k) {
-  std::vector<std::vector<int>> groups(k);
-  for (uint32_t i = 0; i < labels.size(); ++i) {
-    groups[labels[i]].push_back(i);
-  }
-  return groups;
-}
-
-static void initializeCentroids(const DataTable* dataTable, DataTable* centroids, Row& row) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_int_distribution<size_t> dis(0, dataTable->getNumRows() - 1);
-
-  std::set<size_t> chosenRows;
-  for (size_t i = 0; i < centroids->getNumRows(); ++i) {
-    size_t candidateRow;
-    do {
-      candidateRow = dis(gen);
-    } while (chosenRows.count(candidateRow));
-
-    chosenRows.insert(candidateRow);
-
-    dataTable->getRow(candidateRow, row);
-    centroids->setRow(i, row);
-  }
-}
-
-static void initializeCentroids1D(const DataTable* dataTable, DataTable* centroids) {
-  float m = std::numeric_limits<float>::infinity();
-  float M = -std::numeric_limits<float>::infinity();
-
-  const auto& data = dataTable->getColumn(0);
-  for (size_t i = 0; i < dataTable->getNumRows(); ++i) {
-    float value = data.getValue<float>(i);
-    if (value < m) m = value;
-    if (value > M) M = value;
-  }
+#include "kmeans_backend.h"
 
-  auto& centroidsData = centroids->getColumn(0);
-  for (size_t i = 0; i < centroids->getNumRows(); ++i) {
-    float value = m + (M - m) * i / (centroids->getNumRows() - 1);
-    centroidsData.setValue<float>(i, value);
-  }
-}
-
-static void calcAverage(const DataTable* dataTable, const std::vector<int>& cluster,
-                        std::map<std::string, float>& row) {
-  const auto keys = dataTable->getColumnNames();
-
-  for (size_t i = 0; i < keys.size(); ++i) {
-    row[keys[i]] = 0.f;
-  }
-
-  Row dataRow;
-  for (size_t i = 0; i < cluster.size(); ++i) {
-    dataTable->getRow(cluster[i], dataRow);
-
-    for (size_t j = 0; j < keys.size(); ++j) {
-      const auto& key = keys[j];
-      row[key] += dataRow[key];
-    }
-  }
-
-  if (cluster.size() > 0) {
-    for (size_t i = 0; i < keys.size(); ++i) {
-      row[keys[i]] /= cluster.size();
-    }
-  }
-}
+namespace splat {
 
 __global__ void computeCentroidNormsColMajor(const float* __restrict__ centroids, float* __restrict__ norms, uint32_t K,
                                              uint32_t D) {
@@ -262,152 +188,76 @@ __global__ void clusterKernelColMajor(const float* __restrict__ points, const fl
   results[ptIdx] = bestIdx;
 }
 
-std::pair<std::unique_ptr<DataTable>, std::vector<uint32_t>> kmeans(DataTable* points, size_t k, size_t iterations) {
-  // too few data points
-  if (points->getNumRows() < k) {
-    std::vector<uint32_t> labels(points->getNumRows(), 0);
-    std::iota(labels.begin(), labels.end(), 0);
-    return {points->clone(), labels};
-  }
-
-  Row row;
-  std::unique_ptr<DataTable> centroids = std::make_unique<DataTable>();
-  for (auto& c : points->columns) {
-    centroids->addColumn({c.name, std::vector<float>(k, 0)});
+namespace {
+
+class CudaAssigner : public KMeansAssigner {
+ public:
+  CudaAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K)
+      : N_(N), K_(K), D_(static_cast<uint32_t>(columns.size())) {
+    cudaMalloc(&d_points_, size_t(N_) * D_ * sizeof(float));
+    cudaMalloc(&d_centroids_, size_t(K_) * D_ * sizeof(float));
+    cudaMalloc(&d_centroid_norms_, K_ * sizeof(float));
+    cudaMalloc(&d_results_, N_ * sizeof(uint32_t));
+
+    // points never change between iterations, so upload them once through a pinned staging buffer
+    float* h_points_pinned = nullptr;
+    cudaHostAlloc(&h_points_pinned, size_t(N_) * D_ * sizeof(float), cudaHostAllocDefault);
+    for (uint32_t d = 0; d < D_; ++d) {
+      memcpy(&h_points_pinned[size_t(d) * N_], columns[d], N_ * sizeof(float));
+    }
+    cudaMemcpy(d_points_, h_points_pinned, size_t(N_) * D_ * sizeof(float), cudaMemcpyHostToDevice);
+    cudaFreeHost(h_points_pinned);
   }
 
-  if (points->getNumColumns() == 1) {
-    initializeCentroids1D(points, centroids.get());
-  } else {
-    initializeCentroids(points, centroids.get(), row);
+  ~CudaAssigner() override {
+    cudaFree(d_points_);
+    cudaFree(d_centroids_);
+    cudaFree(d_centroid_norms_);
+    cudaFree(d_results_);
   }
 
-  std::vector<uint32_t> labels(points->getNumRows(), 0);
-
-  bool converged = false;
-  size_t steps = 0;
-
-  std::cout << "Running k-means clustering: dims=" << points->getNumColumns() << " points=" << points->getNumRows()
-            << " clusters=" << k << " iterations=" << iterations << "..." << "\n";
-
-  const uint32_t N = points->getNumRows();
-  const uint32_t K = k;
-  const uint32_t D = points->getNumColumns();
-
-  float *d_points = nullptr, *d_centroids = nullptr, *d_centroid_norms = nullptr;
-  uint32_t* d_results = nullptr;
-
-  cudaMalloc(&d_points, N * D * sizeof(float));
-  cudaMalloc(&d_centroids, K * D * sizeof(float));
-  cudaMalloc(&d_centroid_norms, K * sizeof(float));
-  cudaMalloc(&d_results, N * sizeof(uint32_t));
-
-  float *h_points_pinned = nullptr, *h_centroids_pinned = nullptr;
-  cudaHostAlloc(&h_points_pinned, N * D * sizeof(float), cudaHostAllocDefault);
-  cudaHostAlloc(&h_centroids_pinned, K * D * sizeof(float), cudaHostAllocDefault);
-
-  // Create random number generator for reseeding empty clusters
-  std::random_device rd;
-  std::mt19937 gen(rd());
-
-  auto start_total = std::chrono::high_resolution_clock::now();
-
-  while (!converged) {
-    auto start_iter = std::chrono::high_resolution_clock::now();
+  const char* name() const override { return "GPU"; }
 
-    for (uint32_t d = 0; d < D; ++d) {
-      const auto& colData = points->getColumn(d).asVector<float>();
-      memcpy(&h_points_pinned[d * N], colData.data(), N * sizeof(float));
-    }
-
-    for (uint32_t d = 0; d < D; ++d) {
-      const auto& colData = centroids->getColumn(d).asVector<float>();
-      for (uint32_t c = 0; c < K; ++c) {
-        h_centroids_pinned[c + d * K] = colData[c];
-      }
-    }
-
-    cudaMemcpy(d_points, h_points_pinned, N * D * sizeof(float), cudaMemcpyHostToDevice);
-    cudaMemcpy(d_centroids, h_centroids_pinned, K * D * sizeof(float), cudaMemcpyHostToDevice);
+  uint64_t assign(const float* centroids, uint32_t* labels) override {
+    cudaMemcpy(d_centroids_, centroids, size_t(K_) * D_ * sizeof(float), cudaMemcpyHostToDevice);
 
     {
       dim3 blockDim(256);
-      dim3 gridDim((K + blockDim.x - 1) / blockDim.x);
-      computeCentroidNormsColMajor<<<gridDim, blockDim>>>(d_centroids, d_centroid_norms, K, D);
+      dim3 gridDim((K_ + blockDim.x - 1) / blockDim.x);
+      computeCentroidNormsColMajor<<<gridDim, blockDim>>>(d_centroids_, d_centroid_norms_, K_, D_);
     }
 
     {
       int threadsPerBlock = 256;
-      int blocksPerGrid = (N + threadsPerBlock - 1) / threadsPerBlock;
-      clusterKernelColMajor<<<blocksPerGrid, threadsPerBlock>>>(d_points, d_centroids, d_centroid_norms, d_results, N,
-                                                                K, D);
+      int blocksPerGrid = (N_ + threadsPerBlock - 1) / threadsPerBlock;
+      clusterKernelColMajor<<<blocksPerGrid, threadsPerBlock>>>(d_points_, d_centroids_, d_centroid_norms_,
+                                                                d_results_, N_, K_, D_);
       cudaDeviceSynchronize();
     }
 
-    labels.resize(N);
-    cudaMemcpy(labels.data(), d_results, N * sizeof(uint32_t), cudaMemcpyDeviceToHost);
-    // ======================================================
-
-    auto mid_iter = std::chrono::high_resolution_clock::now();
-
-    // calculate the new centroid positions
-    auto groups = groupLabels(labels, k);
-    bool centroidChanged = false;
-
-    for (size_t i = 0; i < centroids->getNumRows(); ++i) {
-      if (groups[i].size() == 0) {
-        // re-seed this centroid to a random point to avoid zero vector
-        std::uniform_int_distribution<size_t> dis(0, points->getNumRows() - 1);
-        const auto idx = dis(gen);
-        points->getRow(idx, row);
-        centroids->setRow(i, row);
-        centroidChanged = true;
-      } else {
-        std::map<std::string, float> new_row;
-        calcAverage(points, groups[i], new_row);
-
-        // Update centroid with new average values
-        for (uint32_t d = 0; d < D; d++) {
-          row[centroids->columns[d].name] = new_row[centroids->columns[d].name];
-        }
-        centroids->setRow(i, row);
-        // Note: centroidChanged is always true in CUDA version for simplicity
-        // This differs from TypeScript version which checks for actual changes
-      }
-    }
-
-    steps++;
-
-    auto end_iter = std::chrono::high_resolution_clock::now();
-    auto iter_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_iter - start_iter);
-    auto gpu_duration = std::chrono::duration_cast<std::chrono::milliseconds>(mid_iter - start_iter);
-    auto cpu_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_iter - mid_iter);
-
-    if (!centroidChanged || steps >= iterations) {
-      converged = true;
-      std::cout << "# (converged)";
-    } else {
-      std::cout << "#";
-    }
-
-    if (steps % 10 == 0 || converged) {
-      std::cout << " [iter " << steps << ": GPU=" << gpu_duration.count() << "ms, CPU=" << cpu_duration.count()
-                << "ms, total=" << iter_duration.count() << "ms]";
-    }
+    cudaMemcpy(labels, d_results_, N_ * sizeof(uint32_t), cudaMemcpyDeviceToHost);
+    return uint64_t(N_) * K_;
   }
 
-  auto end_total = std::chrono::high_resolution_clock::now();
-  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_total - start_total);
-
-  std::cout << "\nk-means completed in " << duration.count() << "ms total" << "\n";
+ private:
+  uint32_t N_;
+  uint32_t K_;
+  uint32_t D_;
+  float* d_points_ = nullptr;
+  float* d_centroids_ = nullptr;
+  float* d_centroid_norms_ = nullptr;
+  uint32_t* d_results_ = nullptr;
+};
+
+}  // namespace
+
+bool cudaAssignerAvailable() {
+  int count = 0;
+  return cudaGetDeviceCount(&count) == cudaSuccess && count > 0;
+}
 
-  cudaFree(d_points);
-  cudaFree(d_centroids);
-  cudaFree(d_centroid_norms);
-  cudaFree(d_results);
-  cudaFreeHost(h_points_pinned);
-  cudaFreeHost(h_centroids_pinned);
-  return {std::move(centroids), labels};
+std::unique_ptr<KMeansAssigner> createCudaAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K) {
+  return std::make_unique<CudaAssigner>(columns, N, K);
 }
 
 }  // namespace splat
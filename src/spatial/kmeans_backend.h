@@ -0,0 +1,98 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @file kmeans_backend.h
+ * @brief Private interface between the k-means driver and its label assignment backends
+ */
+
+namespace splat {
+
+/**
+ * @brief Assigns every point to its nearest centroid
+ *
+ * Points are bound once at construction in column-major layout (one contiguous span of N floats per
+ * dimension); centroids are passed per call in column-major layout as well (centroid c, dimension d at
+ * centroids[d * K + c]). Ties resolve to the lowest centroid index.
+ */
+class KMeansAssigner {
+ public:
+  virtual ~KMeansAssigner() = default;
+
+  /**
+   * @brief Short backend name used in progress output
+   */
+  virtual const char* name() const = 0;
+
+  /**
+   * @brief Write the index of the nearest centroid of every point into labels
+   * @param centroids K * D centroid coordinates, column-major
+   * @param labels Output array of N labels
+   * @return Number of point-to-centroid distances evaluated (N * K for brute force)
+   */
+  virtual uint64_t assign(const float* centroids, uint32_t* labels) = 0;
+};
+
+/**
+ * @brief Create the multithreaded SIMD host backend
+ * @param columns D pointers to N contiguous floats each
+ * @param pool Workers shared with the rest of the k-means run; must outlive the assigner
+ */
+std::unique_ptr<KMeansAssigner> createCpuAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K,
+                                                  ThreadPool& pool);
+
+/**
+ * @brief Create the bounded (Hamerly) host backend
+ *
+ * Keeps per-point distance bounds between calls, so one instance must be fed the successive centroid
+ * sets of a single k-means run.
+ */
+std::unique_ptr<KMeansAssigner> createHamerlyAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K,
+                                                      ThreadPool& pool);
+
+#ifdef SPLAT_ENABLE_CUDA
+/**
+ * @brief Check whether at least one CUDA device is usable
+ */
+bool cudaAssignerAvailable();
+
+/**
+ * @brief Create the CUDA backend; points are uploaded to the device once
+ * @param columns D pointers to N contiguous floats each
+ */
+std::unique_ptr<KMeansAssigner> createCudaAssigner(const std::vector<const float*>& columns, uint32_t N, uint32_t K);
+#endif
+
+}  // namespace splat
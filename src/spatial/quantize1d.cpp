@@ -0,0 +1,389 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+
+#include <splat/spatial/quantize1d.h>
+#include <splat/utils/threadpool.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace splat {
+
+namespace {
+
+// fine histogram resolution over [min, max] of the finite values
+constexpr uint32_t kBins = 1u << 16;
+
+// the optimal partition runs on at most this many (coarsened) histogram atoms
+constexpr uint32_t kMaxPartitionAtoms = 2048;
+
+// fixed slice counts keep every floating point reduction independent of the worker count
+constexpr size_t kHistogramSlices = 16;
+constexpr size_t kAssignSlices = 256;
+
+// assignment searches a 256-entry threshold table, which also caps k
+constexpr size_t kMaxLevels = 256;
+
+static_assert(kMaxPartitionAtoms / 2 >= kMaxLevels, "coarsening must leave more atoms than levels");
+
+/**
+ * @brief The columns of a table addressed as one concatenated range of values
+ */
+struct Values {
+  std::vector<const float*> columns;
+  size_t rows = 0;
+
+  size_t size() const { return columns.size() * rows; }
+
+  // calls fn(column, rowBegin, rowEnd) for every column piece of [begin, end)
+  template <typename F>
+  void forEach(size_t begin, size_t end, F&& fn) const {
+    while (begin < end) {
+      const size_t column = begin / rows;
+      const size_t row = begin % rows;
+      const size_t count = std::min(end - begin, rows - row);
+      fn(column, row, row + count);
+      begin += count;
+    }
+  }
+};
+
+/**
+ * @brief Non-empty histogram bins with prefix sums for constant-time interval costs
+ *
+ * Each bin is treated as a point mass at the mean of the values it received.
+ */
+struct Atoms {
+  std::vector<double> means;
+  std::vector<double> weight;  // prefix sums, size + 1 entries
+  std::vector<double> sum;
+  std::vector<double> sumSq;
+
+  size_t size() const { return means.size(); }
+
+  void push(double count, double total) {
+    if (weight.empty()) {
+      weight.push_back(0.0);
+      sum.push_back(0.0);
+      sumSq.push_back(0.0);
+    }
+    means.push_back(total / count);
+    weight.push_back(weight.back() + count);
+    sum.push_back(sum.back() + total);
+    sumSq.push_back(sumSq.back() + total * total / count);
+  }
+
+  double mean(size_t begin, size_t end) const { return (sum[end] - sum[begin]) / (weight[end] - weight[begin]); }
+
+  // squared error of representing atoms [begin, end) by their common mean
+  double cost(size_t begin, size_t end) const {
+    const double w = weight[end] - weight[begin];
+    if (w <= 0.0) return 0.0;
+    const double s = sum[end] - sum[begin];
+    return std::max(0.0, sumSq[end] - sumSq[begin] - s * s / w);
+  }
+};
+
+/**
+ * @brief Optimal partition of atoms into k contiguous groups (1D k-means is exact on sorted data)
+ *
+ * Dynamic programming over the number of groups, with the divide-and-conquer speedup that relies on
+ * the optimal split point being monotone in the prefix length.
+ *
+ * @return k + 1 group boundaries into atoms, starting at 0 and ending at atoms.size()
+ */
+std::vector<size_t> optimalPartition(const Atoms& atoms, size_t k) {
+  const size_t M = atoms.size();
+
+  std::vector<double> prev(M + 1);
+  std::vector<double> cur(M + 1);
+  std::vector<uint32_t> split(k * (M + 1), 0);
+
+  for (size_t i = 0; i <= M; ++i) {
+    prev[i] = atoms.cost(0, i);
+  }
+
+  for (size_t j = 1; j < k; ++j) {
+    uint32_t* layer = split.data() + j * (M + 1);
+
+    // fills cur[lo..hi] knowing their best split lies in [optLo, optHi]
+    auto solve = [&](auto&& self, size_t lo, size_t hi, size_t optLo, size_t optHi) -> void {
+      if (lo > hi) return;
+      const size_t mid = lo + (hi - lo) / 2;
+
+      double best = std::numeric_limits<double>::max();
+      size_t bestSplit = optLo;
+      for (size_t t = optLo; t <= std::min(optHi, mid - 1); ++t) {
+        const double value = prev[t] + atoms.cost(t, mid);
+        if (value < best) {
+          best = value;
+          bestSplit = t;
+        }
+      }
+      cur[mid] = best;
+      layer[mid] = static_cast<uint32_t>(bestSplit);
+
+      if (mid > lo) self(self, lo, mid - 1, optLo, bestSplit);
+      self(self, mid + 1, hi, bestSplit, optHi);
+    };
+    solve(solve, j + 1, M, j, M - 1);
+
+    std::swap(prev, cur);
+  }
+
+  std::vector<size_t> bounds(k + 1);
+  bounds[k] = M;
+  for (size_t j = k - 1; j > 0; --j) {
+    bounds[j] = split[j * (M + 1) + bounds[j + 1]];
+  }
+  bounds[0] = 0;
+  return bounds;
+}
+
+}  // namespace
+
+std::pair<std::vector<float>, std::unique_ptr<DataTable>> quantize1d(const DataTable* dataTable, size_t k,
+                                                                     size_t iterations, ThreadPool* sharedPool) {
+  if (k == 0 || k > kMaxLevels) {
+    throw std::invalid_argument("quantize1d: k must be between 1 and " + std::to_string(kMaxLevels));
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  Values values;
+  values.rows = dataTable->getNumRows();
+  for (const auto& column : dataTable->columns) {
+    values.columns.push_back(column.asVector<float>().data());
+  }
+  const size_t total = values.size();
+
+  std::unique_ptr<ThreadPool> ownedPool;
+  if (!sharedPool) {
+    ownedPool = std::make_unique<ThreadPool>();
+  }
+  ThreadPool& pool = sharedPool ? *sharedPool : *ownedPool;
+
+  // value range of the finite values
+  std::vector<std::array<float, 2>> sliceRange(kHistogramSlices,
+                                               {std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()});
+  pool.parallelFor(0, kHistogramSlices, 1, [&](size_t begin, size_t end) {
+    for (size_t s = begin; s < end; ++s) {
+      auto& [lo, hi] = sliceRange[s];
+      values.forEach(total * s / kHistogramSlices, total * (s + 1) / kHistogramSlices,
+                     [&](size_t column, size_t rowBegin, size_t rowEnd) {
+                       const float* data = values.columns[column];
+                       for (size_t r = rowBegin; r < rowEnd; ++r) {
+                         const float v = data[r];
+                         if (!std::isfinite(v)) continue;
+                         lo = std::min(lo, v);
+                         hi = std::max(hi, v);
+                       }
+                     });
+    }
+  });
+
+  float minValue = std::numeric_limits<float>::max();
+  float maxValue = -std::numeric_limits<float>::max();
+  for (const auto& [lo, hi] : sliceRange) {
+    minValue = std::min(minValue, lo);
+    maxValue = std::max(maxValue, hi);
+  }
+
+  // per-slice histograms, merged in slice order
+  Atoms atoms;
+  std::vector<uint32_t> binAtom(kBins + 1, 0);  // first atom at or after each bin
+  const double scale = maxValue > minValue ? kBins / (double(maxValue) - double(minValue)) : 0.0;
+
+  if (minValue <= maxValue) {
+    std::vector<uint32_t> counts(kHistogramSlices * kBins, 0);
+    std::vector<double> sums(kHistogramSlices * kBins, 0.0);
+
+    pool.parallelFor(0, kHistogramSlices, 1, [&](size_t begin, size_t end) {
+      for (size_t s = begin; s < end; ++s) {
+        uint32_t* count = counts.data() + s * kBins;
+        double* sum = sums.data() + s * kBins;
+        values.forEach(total * s / kHistogramSlices, total * (s + 1) / kHistogramSlices,
+                       [&](size_t column, size_t rowBegin, size_t rowEnd) {
+                         const float* data = values.columns[column];
+                         for (size_t r = rowBegin; r < rowEnd; ++r) {
+                           const float v = data[r];
+                           if (!std::isfinite(v)) continue;
+                           const uint32_t bin =
+                               std::min(kBins - 1, static_cast<uint32_t>((double(v) - minValue) * scale));
+                           count[bin]++;
+                           sum[bin] += v;
+                         }
+                       });
+      }
+    });
+
+    for (uint32_t b = 0; b < kBins; ++b) {
+      binAtom[b] = static_cast<uint32_t>(atoms.size());
+      double count = 0.0;
+      double sum = 0.0;
+      for (size_t s = 0; s < kHistogramSlices; ++s) {
+        count += counts[s * kBins + b];
+        sum += sums[s * kBins + b];
+      }
+      if (count > 0.0) atoms.push(count, sum);
+    }
+    binAtom[kBins] = static_cast<uint32_t>(atoms.size());
+  }
+
+  const size_t M = atoms.size();
+  std::vector<double> levels(k, 0.0);
+  size_t passes = 0;
+
+  if (M <= k) {
+    // no more distinct bins than levels: every bin is its own level
+    for (size_t c = 0; c < k; ++c) {
+      levels[c] = M > 0 ? atoms.means[std::min(c, M - 1)] : 0.0;
+    }
+  } else {
+    // coarsen the histogram by merging runs of bins until the partition problem is small enough
+    uint32_t group = 1;
+    auto groupAtoms = [&](uint32_t g) {
+      std::vector<uint32_t> starts;
+      for (uint32_t b = 0; b < kBins; b += g) {
+        if (binAtom[b + g] > binAtom[b]) starts.push_back(binAtom[b]);
+      }
+      return starts;
+    };
+    std::vector<uint32_t> starts = groupAtoms(group);
+    while (starts.size() > kMaxPartitionAtoms) {
+      group *= 2;
+      starts = groupAtoms(group);
+    }
+
+    Atoms coarse;
+    starts.push_back(static_cast<uint32_t>(M));
+    for (size_t i = 0; i + 1 < starts.size(); ++i) {
+      coarse.push(atoms.weight[starts[i + 1]] - atoms.weight[starts[i]],
+                  atoms.sum[starts[i + 1]] - atoms.sum[starts[i]]);
+    }
+
+    // coarsening stops above kMaxPartitionAtoms / 2 atoms, so there are always more atoms than levels
+    std::vector<size_t> bounds = optimalPartition(coarse, k);
+    for (auto& b : bounds) b = starts[b];
+
+    for (size_t c = 0; c < k; ++c) {
+      levels[c] = atoms.mean(bounds[c], bounds[c + 1]);
+    }
+
+    // Lloyd-Max refinement at full histogram resolution: decision thresholds sit halfway between
+    // levels and each level moves to the mean of the atoms between its thresholds
+    std::vector<size_t> next(k + 1);
+    next[0] = 0;
+    next[k] = M;
+    for (; passes < iterations; ++passes) {
+      for (size_t c = 0; c + 1 < k; ++c) {
+        const double threshold = 0.5 * (levels[c] + levels[c + 1]);
+        next[c + 1] = std::upper_bound(atoms.means.begin(), atoms.means.end(), threshold) - atoms.means.begin();
+      }
+      if (next == bounds) break;
+      bounds.swap(next);
+
+      for (size_t c = 0; c < k; ++c) {
+        if (bounds[c + 1] > bounds[c]) levels[c] = atoms.mean(bounds[c], bounds[c + 1]);
+      }
+    }
+  }
+
+  // exact assignment of the raw values; a value on a threshold goes to the lower level
+  std::array<float, kMaxLevels> thresholds;
+  thresholds.fill(std::numeric_limits<float>::infinity());
+  for (size_t c = 0; c + 1 < k; ++c) {
+    thresholds[c] = static_cast<float>(0.5 * (levels[c] + levels[c + 1]));
+  }
+
+  std::vector<Column> resultColumns;
+  for (const auto& column : dataTable->columns) {
+    resultColumns.push_back({column.name, ColumnVector<uint8_t>(values.rows)});
+  }
+  std::vector<uint8_t*> labels;
+  for (auto& column : resultColumns) {
+    labels.push_back(column.asVector<uint8_t>().data());
+  }
+
+  std::vector<double> levelSums(kAssignSlices * k, 0.0);
+  std::vector<uint64_t> levelCounts(kAssignSlices * k, 0);
+
+  pool.parallelFor(0, kAssignSlices, 1, [&](size_t begin, size_t end) {
+    for (size_t s = begin; s < end; ++s) {
+      double* sum = levelSums.data() + s * k;
+      uint64_t* count = levelCounts.data() + s * k;
+      values.forEach(total * s / kAssignSlices, total * (s + 1) / kAssignSlices,
+                     [&](size_t column, size_t rowBegin, size_t rowEnd) {
+                       const float* data = values.columns[column];
+                       uint8_t* out = labels[column];
+                       for (size_t r = rowBegin; r < rowEnd; ++r) {
+                         const float v = data[r];
+
+                         // branchless count of thresholds below v
+                         uint32_t label = 0;
+                         for (uint32_t step = kMaxLevels / 2; step > 0; step >>= 1) {
+                           label += thresholds[label + step - 1] < v ? step : 0;
+                         }
+                         out[r] = static_cast<uint8_t>(label);
+
+                         if (std::isfinite(v)) {
+                           sum[label] += v;
+                           count[label]++;
+                         }
+                       }
+                     });
+    }
+  });
+
+  // finish with the exact mean of every level's values
+  std::vector<float> codebook(k);
+  for (size_t c = 0; c < k; ++c) {
+    double sum = 0.0;
+    uint64_t count = 0;
+    for (size_t s = 0; s < kAssignSlices; ++s) {
+      sum += levelSums[s * k + c];
+      count += levelCounts[s * k + c];
+    }
+    codebook[c] = static_cast<float>(count > 0 ? sum / count : levels[c]);
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+  std::cout << "1D quantization: values=" << total << " bins=" << M << " levels=" << k
+            << " refinement passes=" << passes << " in " << duration.count() << "ms\n";
+
+  return {std::move(codebook), std::make_unique<DataTable>(std::move(resultColumns))};
+}
+
+}  // namespace splat
@@ -0,0 +1,149 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <splat/utils/output-file.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace splat {
+
+#ifdef _WIN32
+
+OutputFile::OutputFile(const std::string& filename, bool directIO) : filename_(filename) {
+  HANDLE file = INVALID_HANDLE_VALUE;
+  if (directIO) {
+    file = CreateFileA(filename.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH, nullptr);
+    direct_ = file != INVALID_HANDLE_VALUE;
+  }
+  if (file == INVALID_HANDLE_VALUE) {
+    file = CreateFileA(filename.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  }
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("Could not open file for writing: " + filename);
+  }
+  file_ = file;
+}
+
+OutputFile::~OutputFile() {
+  if (file_) CloseHandle(file_);
+}
+
+void OutputFile::write(const uint8_t* data, size_t size, uint64_t offset) {
+  while (size > 0) {
+    // WriteFile takes 32-bit sizes
+    const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD written = 0;
+    if (!WriteFile(file_, data, chunk, &written, &overlapped) || written == 0) {
+      throw std::runtime_error("Failed to write file: " + filename_);
+    }
+    data += written;
+    size -= written;
+    offset += written;
+  }
+}
+
+void OutputFile::truncate(uint64_t size) {
+  // a handle opened without buffering cannot set an unaligned end of file; reopen it buffered
+  if (direct_) {
+    CloseHandle(file_);
+    file_ = CreateFileA(filename_.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+      file_ = nullptr;
+      throw std::runtime_error("Could not open file for writing: " + filename_);
+    }
+    direct_ = false;
+  }
+
+  LARGE_INTEGER end;
+  end.QuadPart = static_cast<LONGLONG>(size);
+  if (!SetFilePointerEx(file_, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file_)) {
+    throw std::runtime_error("Failed to write file: " + filename_);
+  }
+}
+
+#else
+
+OutputFile::OutputFile(const std::string& filename, bool directIO) : filename_(filename) {
+#ifdef O_DIRECT
+  if (directIO) {
+    // file systems without direct I/O (tmpfs, some network mounts) reject the flag at open
+    fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    direct_ = fd_ >= 0;
+  }
+#else
+  (void)directIO;
+#endif
+  if (fd_ < 0) {
+    fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  }
+  if (fd_ < 0) {
+    throw std::runtime_error("Could not open file for writing: " + filename);
+  }
+}
+
+OutputFile::~OutputFile() {
+  if (fd_ >= 0) ::close(fd_);
+}
+
+void OutputFile::write(const uint8_t* data, size_t size, uint64_t offset) {
+  while (size > 0) {
+    const ssize_t written = ::pwrite(fd_, data, size, static_cast<off_t>(offset));
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      throw std::runtime_error("Failed to write file: " + filename_);
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+    offset += static_cast<uint64_t>(written);
+  }
+}
+
+void OutputFile::truncate(uint64_t size) {
+  if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+    throw std::runtime_error("Failed to write file: " + filename_);
+  }
+}
+
+#endif
+
+}  // namespace splat
@@ -30,57 +30,109 @@
 #include <webp/encode.h>
 
 #include <cstdint>
-#include <memory>
 #include <stdexcept>
 #include <vector>
 
 namespace splat::webpcodec {
 
-struct WebPFreeDeleter {
-  void operator()(void* ptr) const {
-    if (ptr != nullptr) {
-      WebPFree(ptr);
-    }
-  }
-};
+std::tuple<std::vector<uint8_t>, int, int> decodeRGBA(const std::vector<uint8_t>& webp) {
+  const auto [width, height] = getDimensions(webp.data(), webp.size());
 
-using WebPDataPtr = std::unique_ptr<uint8_t, WebPFreeDeleter>;
+  std::vector<uint8_t> result_data(static_cast<size_t>(width) * height * 4);
+  decodeRGBAInto(webp.data(), webp.size(), result_data.data(), result_data.size(), width * 4);
 
-std::tuple<std::vector<uint8_t>, int, int> decodeRGBA(const std::vector<uint8_t>& webp) {
+  return {std::move(result_data), width, height};
+}
+
+std::pair<int, int> getDimensions(const uint8_t* webp, size_t size) {
   int width = 0;
   int height = 0;
-  uint8_t* rgba_buffer = WebPDecodeRGBA(webp.data(), webp.size(), &width, &height);
+  if (!WebPGetInfo(webp, size, &width, &height)) {
+    throw std::runtime_error("WebP decode failed. Could not read image header.");
+  }
+  return {width, height};
+}
 
-  if (rgba_buffer == nullptr) {
+void decodeRGBAInto(const uint8_t* webp, size_t size, uint8_t* rgba, size_t rgbaSize, int stride) {
+  if (WebPDecodeRGBAInto(webp, size, rgba, rgbaSize, stride) == nullptr) {
     throw std::runtime_error("WebP decode failed. Could not decode data.");
   }
+}
 
-  WebPDataPtr decoded_data(rgba_buffer);
-
-  const size_t size = static_cast<size_t>(width) * height * 4;
-
-  std::vector<uint8_t> result_data(decoded_data.get(), decoded_data.get() + size);
+const char* presetName(Preset preset) {
+  switch (preset) {
+    case Preset::Fast:
+      return "fast";
+    case Preset::Max:
+      return "max";
+    case Preset::Balanced:
+    default:
+      return "balanced";
+  }
+}
 
-  return {result_data, width, height};
+// Fast and Max match WebPConfigLosslessPreset levels 1 and 9, Balanced is what WebPEncodeLosslessRGBA uses.
+// Level 0 skips most of the transform search and roughly doubles the size of SOG textures
+static void configurePreset(WebPConfig& config, Preset preset) {
+  switch (preset) {
+    case Preset::Fast:
+      config.method = 1;
+      config.quality = 20.0f;
+      break;
+    case Preset::Max:
+      config.method = 6;
+      config.quality = 100.0f;
+      break;
+    case Preset::Balanced:
+    default:
+      config.method = 4;
+      config.quality = 70.0f;
+      break;
+  }
 }
 
-std::vector<uint8_t> encodeLosslessRGBA(const std::vector<uint8_t>& rgba, int width, int height, int stride) {
+std::vector<uint8_t> encodeLosslessRGBA(const std::vector<uint8_t>& rgba, int width, int height, int stride,
+                                        Preset preset) {
   if (stride == 0) {
     stride = width * 4;
   }
 
-  uint8_t* output_buffer = nullptr;
-  size_t output_size = 0;
+  WebPConfig config;
+  if (!WebPConfigInit(&config)) {
+    throw std::runtime_error("WebP lossless encode failed. Library version mismatch.");
+  }
+  config.lossless = 1;
+  // keep RGB under zero alpha, which WebPEncodeLosslessRGBA() does not: SOG alpha channels hold data
+  config.exact = 1;
+  config.thread_level = 1;
+  configurePreset(config, preset);
+  if (!WebPValidateConfig(&config)) {
+    throw std::runtime_error("WebP lossless encode failed. Invalid encoder configuration.");
+  }
 
-  output_size = WebPEncodeLosslessRGBA(rgba.data(), width, height, stride, &output_buffer);
+  WebPPicture picture;
+  if (!WebPPictureInit(&picture)) {
+    throw std::runtime_error("WebP lossless encode failed. Library version mismatch.");
+  }
+  picture.use_argb = 1;
+  picture.width = width;
+  picture.height = height;
+
+  WebPMemoryWriter writer;
+  WebPMemoryWriterInit(&writer);
+  picture.writer = WebPMemoryWrite;
+  picture.custom_ptr = &writer;
 
-  if (output_size == 0) {
+  const bool ok = WebPPictureImportRGBA(&picture, rgba.data(), stride) && WebPEncode(&config, &picture);
+  WebPPictureFree(&picture);
+
+  if (!ok || writer.size == 0) {
+    WebPMemoryWriterClear(&writer);
     throw std::runtime_error("WebP lossless encode failed. Output size is zero.");
   }
 
-  WebPDataPtr encoded_data(output_buffer);
-
-  std::vector<uint8_t> result_data(encoded_data.get(), encoded_data.get() + output_size);
+  std::vector<uint8_t> result_data(writer.mem, writer.mem + writer.size);
+  WebPMemoryWriterClear(&writer);
 
   return result_data;
 }
@@ -38,6 +38,9 @@ constexpr uint16_t GP_FLAG_DATA_DESCRIPTOR = 0x8;  // Bit 3: Size/CRC are zeroed
 constexpr uint16_t GP_FLAG_UTF8 = 0x800;           // Bit 11: Filename is UTF-8 encoded
 constexpr uint16_t METHOD_STORED = 0;              // Only STORED method (no compression) is supported
 constexpr std::streamoff LFH_FIXED_SIZE = 30;      // Fixed size of Local File Header
+constexpr std::streamoff CDH_FIXED_SIZE = 46;      // Fixed size of Central Directory File Header
+constexpr std::streamoff EOCD_FIXED_SIZE = 22;     // Fixed size of End Of Central Directory record
+constexpr std::streamoff EOCD_MAX_COMMENT = 0xffff;
 
 }  // namespace zip_constants
 
@@ -155,12 +158,99 @@ ZipReader::~ZipReader() {
 }
 
 /**
- * @brief Synchronously lists all entries in the ZIP file by sequentially
- * parsing Local File Headers.
+ * @brief Lists the entries recorded in the Central Directory.
+ * Only the directory and one local header per entry are read, so entry data is never touched; this is
+ * what makes archives written with data descriptors cheap to list.
+ * @param entries Receives the entries on success.
+ * @return false if the archive has no readable End Of Central Directory record.
+ */
+bool ZipReader::listCentralDirectory(std::vector<ZipEntry>& entries) {
+  if (file_size_ < zip_constants::EOCD_FIXED_SIZE) {
+    return false;
+  }
+
+  // the EOCD record ends the file, followed only by its comment
+  const std::streamoff tailSize =
+      std::min(file_size_, zip_constants::EOCD_FIXED_SIZE + zip_constants::EOCD_MAX_COMMENT);
+  const std::streamoff tailStart = file_size_ - tailSize;
+  const auto tail = readAt(tailStart, static_cast<size_t>(tailSize));
+
+  size_t eocd = tail.size() - zip_constants::EOCD_FIXED_SIZE + 1;
+  while (eocd-- > 0) {
+    if (readUint32LE(tail, eocd) == zip_constants::EOCD_SIG &&
+        eocd + zip_constants::EOCD_FIXED_SIZE + readUint16LE(tail, eocd + 20) == tail.size()) {
+      break;
+    }
+  }
+  if (eocd == static_cast<size_t>(-1)) {
+    return false;
+  }
+
+  const uint16_t count = readUint16LE(tail, eocd + 10);
+  const uint32_t dirSize = readUint32LE(tail, eocd + 12);
+  const uint32_t dirOffset = readUint32LE(tail, eocd + 16);
+  if (static_cast<std::streamoff>(dirOffset) + dirSize > tailStart + static_cast<std::streamoff>(eocd)) {
+    return false;
+  }
+
+  const auto dir = readAt(dirOffset, dirSize);
+  std::vector<ZipEntry> result;
+  size_t pos = 0;
+  for (uint16_t i = 0; i < count; ++i) {
+    if (pos + zip_constants::CDH_FIXED_SIZE > dir.size() || readUint32LE(dir, pos) != zip_constants::CENTRAL_DIR_SIG) {
+      return false;
+    }
+    const uint16_t gpFlags = readUint16LE(dir, pos + 8);
+    const uint16_t method = readUint16LE(dir, pos + 10);
+    const uint32_t size = readUint32LE(dir, pos + 24);
+    const uint16_t nameLen = readUint16LE(dir, pos + 28);
+    const uint16_t extraLen = readUint16LE(dir, pos + 30);
+    const uint16_t commentLen = readUint16LE(dir, pos + 32);
+    const uint32_t headerOffset = readUint32LE(dir, pos + 42);
+    if (pos + zip_constants::CDH_FIXED_SIZE + nameLen > dir.size()) {
+      return false;
+    }
+
+    const std::vector<uint8_t> name_bytes(dir.begin() + pos + zip_constants::CDH_FIXED_SIZE,
+                                          dir.begin() + pos + zip_constants::CDH_FIXED_SIZE + nameLen);
+    const std::string name = decodeName(name_bytes, (gpFlags & zip_constants::GP_FLAG_UTF8) != 0);
+    pos += zip_constants::CDH_FIXED_SIZE + nameLen + extraLen + commentLen;
+
+    if (method != zip_constants::METHOD_STORED) {
+      throw std::runtime_error("Unsupported ZIP compression method: " + std::to_string(method) +
+                               " (only STORE=0 supported)");
+    }
+
+    // the local header's name and extra field may differ in length from the directory's copy
+    const auto header = readAt(headerOffset, zip_constants::LFH_FIXED_SIZE);
+    if (readUint32LE(header, 0) != zip_constants::LOCAL_FILE_HEADER_SIG) {
+      return false;
+    }
+    const std::streamoff start =
+        headerOffset + zip_constants::LFH_FIXED_SIZE + readUint16LE(header, 26) + readUint16LE(header, 28);
+    if (start + static_cast<std::streamoff>(size) > file_size_) {
+      return false;
+    }
+
+    const size_t entry_size = size;
+    auto read_func = [this, start, entry_size]() -> std::vector<uint8_t> { return this->readAt(start, entry_size); };
+    result.emplace_back(name, size, start, read_func);
+  }
+
+  entries = std::move(result);
+  return true;
+}
+
+/**
+ * @brief Synchronously lists all entries in the ZIP file.
+ * The Central Directory is used when present; otherwise Local File Headers are parsed sequentially.
  * @return A vector of ZipEntry objects.
  */
 std::vector<ZipEntry> ZipReader::list() {
   std::vector<ZipEntry> entries;
+  if (listCentralDirectory(entries)) {
+    return entries;
+  }
   cursor_ = 0;
 
   while (cursor_ + zip_constants::LFH_FIXED_SIZE <= file_size_) {
@@ -215,7 +305,7 @@ std::vector<ZipEntry> ZipReader::list() {
       // Create entry with lazy readData function
       auto read_func = [this, start, entry_size]() -> std::vector<uint8_t> { return this->readAt(start, entry_size); };
 
-      entries.emplace_back(name, entry_size, read_func);
+      entries.emplace_back(name, entry_size, start, read_func);
     } else {
       // Case 2: Data descriptor follows the file data (scan required)
       const size_t CHUNK_SIZE = 64ULL * 1024;
@@ -251,7 +341,7 @@ std::vector<ZipEntry> ZipReader::list() {
               return this->readAt(data_offset, entry_size);
             };
 
-            entries.emplace_back(name, size, read_func);
+            entries.emplace_back(name, size, data_offset, read_func);
             found = true;
             break;
           }
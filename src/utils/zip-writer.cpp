@@ -26,6 +26,8 @@
 #include <splat/utils/zip-writer.h>
 
 #include <chrono>
+#include <cstdlib>
+#include <ctime>
 
 namespace splat {
 
@@ -40,15 +42,31 @@ static constexpr uint16_t CDR_FIXED_SIZE = 46;
 
 }  // namespace zip_constants
 
-ZipWriter::ZipWriter(const std::string& filename) {
+ZipWriter::ZipWriter(const std::string& filename, bool useCurrentTime) {
   file_.open(filename, std::ios::binary | std::ios::out);
   if (!file_) {
     throw std::runtime_error("Failed to open zip file");
   }
 
-  auto now = std::chrono::system_clock::now();
-  std::time_t t = std::chrono::system_clock::to_time_t(now);
-  std::tm* tm = std::localtime(&t);
+  // entries default to the DOS epoch so that identical content produces an identical archive;
+  // SOURCE_DATE_EPOCH overrides it, and the wall clock is only used when asked for
+  std::tm* tm = nullptr;
+  std::time_t t = 0;
+  if (const char* epoch = std::getenv("SOURCE_DATE_EPOCH")) {
+    t = static_cast<std::time_t>(std::strtoll(epoch, nullptr, 10));
+    tm = std::gmtime(&t);
+  } else if (useCurrentTime) {
+    t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    tm = std::localtime(&t);
+  }
+
+  // 1980-01-01 00:00:00, also the floor as DOS timestamps cannot represent anything earlier
+  std::tm earliest{};
+  if (!tm || tm->tm_year < 80) {
+    earliest.tm_year = 80;
+    earliest.tm_mday = 1;
+    tm = &earliest;
+  }
 
   dosTime_ = static_cast<uint16_t>((tm->tm_hour << 11) | (tm->tm_min << 5) | (tm->tm_sec / 2));
 
@@ -0,0 +1,176 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <splat/io/compressed_ply_writer.h>
+#include <splat/io/ply_reader.h>
+#include <splat/maths/maths.h>
+#include <splat/models/gaussian.h>
+#include <splat/op/morton-order.h>
+
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+
+/**
+ * @file compressed_ply_test.cpp
+ * @brief Round trip of writeCompressedPly() through readPly()/decompressPly()
+ *
+ * The writer emits splats in Morton order, so row i of the decoded table is compared against the input
+ * row at position i of the same sort. Tolerances follow the packed bit widths for the value ranges
+ * generated below.
+ */
+
+using namespace splat;
+
+namespace {
+
+// one partial chunk on top of several full 256-splat chunks
+constexpr size_t kNumSplats = 1000;
+
+constexpr float kPositionTolerance = 2.0f / 1023.0f + 1e-4f;  // 10 bit y over a [-1, 1] chunk range
+constexpr float kScaleTolerance = 4.0f / 1023.0f + 1e-4f;     // 10 bit over a [-4, 0] chunk range
+constexpr float kColorTolerance = 0.02f;                      // 8 bit colour, in f_dc units
+constexpr float kOpacityTolerance = 1.0f / 255.0f + 1e-4f;    // 8 bit, compared after the sigmoid
+constexpr float kShTolerance = 8.0f / 256.0f + 1e-4f;         // 8 bit over [-4, 4]
+constexpr float kRotationDot = 0.999f;                        // |q_in . q_out|, sign-agnostic
+
+std::unique_ptr<DataTable> makeTable() {
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> logScale(-4.0f, 0.0f);
+  std::uniform_real_distribution<float> logit(-4.0f, 4.0f);
+
+  std::vector<Column> columns;
+  for (const auto& name : kGaussianAttrNames) {
+    columns.push_back({std::string(name), ColumnVector<float>(kNumSplats)});
+  }
+  auto table = std::make_unique<DataTable>(std::move(columns));
+  GaussianView view(*table);
+
+  for (size_t i = 0; i < kNumSplats; ++i) {
+    GaussianRef g = view[i];
+    g.x() = unit(gen);
+    g.y() = unit(gen);
+    g.z() = unit(gen);
+
+    float q[4];
+    float norm = 0.0f;
+    for (float& v : q) {
+      v = unit(gen);
+      norm += v * v;
+    }
+    norm = std::sqrt(norm);
+    for (size_t k = 0; k < 4; ++k) {
+      g.rot(k) = q[k] / norm;
+    }
+
+    for (size_t k = 0; k < 3; ++k) {
+      g.scale(k) = logScale(gen);
+      g.dc(k) = unit(gen);
+    }
+    g.opacity() = logit(gen);
+    for (size_t k = 0; k < kGaussianRestCount; ++k) {
+      g.rest(k) = unit(gen);
+    }
+  }
+  return table;
+}
+
+int failures = 0;
+
+void check(bool ok, const char* what, size_t row, float expected, float actual) {
+  if (!ok && failures++ < 20) {
+    std::fprintf(stderr, "row %zu: %s expected %f, got %f\n", row, what, expected, actual);
+  }
+}
+
+void checkNear(const char* what, size_t row, float expected, float actual, float tolerance) {
+  check(std::abs(expected - actual) <= tolerance, what, row, expected, actual);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::string filename = argc > 1 ? argv[1] : "compressed_ply_test.compressed.ply";
+
+  auto input = makeTable();
+  writeCompressedPly(filename, input.get());
+  auto output = readPly(filename);
+
+  if (output->getNumRows() != kNumSplats) {
+    std::fprintf(stderr, "expected %zu rows, got %zu\n", kNumSplats, output->getNumRows());
+    return 1;
+  }
+
+  std::vector<uint32_t> order(kNumSplats);
+  std::iota(order.begin(), order.end(), 0);
+  sortMortonOrder(input.get(), absl::MakeSpan(order));
+
+  ConstGaussianView in(*input);
+  ConstGaussianView out(*output);
+  if (!out.hasPosition() || !out.hasRotation() || !out.hasScale() || !out.hasColor() || !out.hasOpacity() ||
+      out.shBands() != 3) {
+    std::fprintf(stderr, "decoded table is missing attributes (%d SH bands)\n", out.shBands());
+    return 1;
+  }
+
+  for (size_t i = 0; i < kNumSplats; ++i) {
+    const ConstGaussianRef a = in[order[i]];
+    const ConstGaussianRef b = out[i];
+
+    checkNear("x", i, a.x(), b.x(), kPositionTolerance);
+    checkNear("y", i, a.y(), b.y(), kPositionTolerance);
+    checkNear("z", i, a.z(), b.z(), kPositionTolerance);
+
+    float dot = 0.0f;
+    for (size_t k = 0; k < 4; ++k) {
+      dot += a.rot(k) * b.rot(k);
+    }
+    check(std::abs(dot) >= kRotationDot, "|rotation dot|", i, 1.0f, std::abs(dot));
+
+    for (size_t k = 0; k < 3; ++k) {
+      checkNear("scale", i, a.scale(k), b.scale(k), kScaleTolerance);
+      checkNear("f_dc", i, a.dc(k), b.dc(k), kColorTolerance);
+    }
+    checkNear("sigmoid(opacity)", i, sigmoid(a.opacity()), sigmoid(b.opacity()), kOpacityTolerance);
+
+    for (size_t k = 0; k < kGaussianRestCount; ++k) {
+      checkNear("f_rest", i, a.rest(k), b.rest(k), kShTolerance);
+    }
+  }
+
+  std::remove(filename.c_str());
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d values outside tolerance\n", failures);
+    return 1;
+  }
+  std::printf("compressed PLY round trip: %zu splats within tolerance\n", kNumSplats);
+  return 0;
+}
@@ -0,0 +1,138 @@
+/***********************************************************************************
+ *
+ * splat - A C++ library for reading and writing 3D Gaussian Splatting (splat) files.
+ *
+ * This library provides functionality to convert, manipulate, and process
+ * 3D Gaussian splatting data formats used in real-time neural rendering.
+ *
+ * This file is part of splat.
+ *
+ * splat is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * splat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * For more information, visit the project's homepage or contact the author.
+ *
+ ***********************************************************************************/
+
+#include <splat/io/ply_writer.h>
+#include <splat/utils/output-file.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/**
+ * @file ply_direct_io_test.cpp
+ * @brief Direct-I/O writePly() output must match buffered output byte for byte
+ *
+ * The file has a one-row element with 18 floats followed by a large one-float element, so the last
+ * element's rows are narrower than the widest row. Row counts are chosen so the final fill of the first
+ * staging buffer ends just past the last 4096-byte boundary of a 16 MiB + widest row + 4096 byte buffer,
+ * where the padded last block used to run off the end of the buffer.
+ */
+
+using namespace splat;
+
+namespace {
+
+constexpr size_t kStagingBytes = 16 * 1024 * 1024;  // writePly's staging buffer size
+constexpr size_t kWideColumns = 18;
+
+PlyData makePly(size_t narrowRows) {
+  std::vector<Column> wide;
+  for (size_t c = 0; c < kWideColumns; ++c) {
+    wide.push_back({"w" + std::to_string(c), ColumnVector<float>(1, static_cast<float>(c))});
+  }
+
+  ColumnVector<float> values(narrowRows);
+  for (size_t i = 0; i < narrowRows; ++i) {
+    values[i] = static_cast<float>(i);
+  }
+  std::vector<Column> narrow;
+  narrow.push_back({"v", std::move(values)});
+
+  PlyData ply;
+  ply.elements.push_back({"wide", std::make_unique<DataTable>(std::move(wide))});
+  ply.elements.push_back({"narrow", std::make_unique<DataTable>(std::move(narrow))});
+  return ply;
+}
+
+size_t headerSize(size_t narrowRows) {
+  std::string header = "ply\nformat binary_little_endian 1.0\nelement wide 1\n";
+  for (size_t c = 0; c < kWideColumns; ++c) {
+    header += "property float w" + std::to_string(c) + "\n";
+  }
+  header += "element narrow " + std::to_string(narrowRows) + "\nproperty float v\nend_header\n";
+  return header.size();
+}
+
+std::vector<char> readFile(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::string dir = argc > 1 ? std::string(argv[1]) + "/" : "";
+  const std::string buffered = dir + "ply_direct_io_test.buffered.ply";
+  const std::string direct = dir + "ply_direct_io_test.direct.ply";
+
+  bool directAvailable = false;
+  {
+    OutputFile probe(direct, true);
+    directAvailable = probe.direct();
+  }
+  if (!directAvailable) {
+    std::printf("note: direct I/O is not available in %s, only the buffered fallback is exercised\n",
+                dir.empty() ? "." : dir.c_str());
+  }
+
+  const size_t wideRow = kWideColumns * sizeof(float);
+  const size_t oldCapacity = kStagingBytes + wideRow + OutputFile::kDirectAlignment;
+  const size_t lastBoundary = oldCapacity / OutputFile::kDirectAlignment * OutputFile::kDirectAlignment;
+
+  // smallest row count whose data ends past lastBoundary, then a few more lanes of the partial block
+  size_t firstRows = (lastBoundary - wideRow - headerSize(lastBoundary / sizeof(float))) / sizeof(float);
+  while (headerSize(firstRows) + wideRow + firstRows * sizeof(float) <= lastBoundary) {
+    firstRows++;
+  }
+
+  int failures = 0;
+  for (size_t narrowRows = firstRows; narrowRows < firstRows + 8; ++narrowRows) {
+    const PlyData ply = makePly(narrowRows);
+    writePly(buffered, ply);
+    writePly(direct, ply, {true});
+
+    const auto expected = readFile(buffered);
+    const auto actual = readFile(direct);
+    const size_t expectedSize = headerSize(narrowRows) + wideRow + narrowRows * sizeof(float);
+    if (expected.size() != expectedSize || actual != expected) {
+      std::fprintf(stderr, "%zu rows: direct output (%zu bytes) differs from buffered output (%zu bytes)\n",
+                   narrowRows, actual.size(), expected.size());
+      failures++;
+    }
+  }
+
+  std::remove(buffered.c_str());
+  std::remove(direct.c_str());
+
+  if (failures > 0) {
+    return 1;
+  }
+  std::printf("direct-I/O PLY output matches buffered output\n");
+  return 0;
+}
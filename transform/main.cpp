@@ -66,6 +66,10 @@ ABSL_FLAG(bool, list_gpus, false, "List available GPU adapters and exit");
 ABSL_FLAG(bool, unbundled, false, "Generate unbundled HTML viewer with separate files");
 
 ABSL_FLAG(int32_t, iterations, 10, "Iterations for SOG SH compression (more=better)");
+ABSL_FLAG(int32_t, batch_size, 0, "Rows per k-means mini-batch for SOG compression (0 = full passes)");
+ABSL_FLAG(std::string, batch_sampling, "random", "Mini-batch row sampling: random | stratified");
+ABSL_FLAG(uint64_t, seed, 0, "Seed for k-means initialization and sampling (same seed = same output)");
+ABSL_FLAG(std::string, webp_preset, "balanced", "WebP encoder effort for SOG textures: fast | balanced | max");
 ABSL_FLAG(int32_t, lod_chunk_count, 64, "Approximate number of Gaussians per LOD chunk in K");
 ABSL_FLAG(int32_t, lod_chunk_extent, 16, "Approximate size of an LOD chunk in world units (m)");
 
@@ -96,6 +100,19 @@ static std::tuple<std::vector<File>, Options> parseArguments(int argc, char** ar
   options.unbundled = absl::GetFlag(FLAGS_unbundled);
   options.viewerSettingsPath = absl::GetFlag(FLAGS_viewer_settings);
   options.iterations = absl::GetFlag(FLAGS_iterations);
+  options.batchSize = absl::GetFlag(FLAGS_batch_size);
+  options.batchSampling = absl::GetFlag(FLAGS_batch_sampling);
+  options.seed = absl::GetFlag(FLAGS_seed);
+  if (options.batchSize < 0) {
+    throw std::runtime_error("Invalid batch size: " + std::to_string(options.batchSize));
+  }
+  if (options.batchSampling != "random" && options.batchSampling != "stratified") {
+    throw std::runtime_error("Invalid batch sampling: " + options.batchSampling);
+  }
+  options.webpPreset = absl::GetFlag(FLAGS_webp_preset);
+  if (options.webpPreset != "fast" && options.webpPreset != "balanced" && options.webpPreset != "max") {
+    throw std::runtime_error("Invalid webp preset: " + options.webpPreset);
+  }
   options.lodChunkCount = absl::GetFlag(FLAGS_lod_chunk_count);
   options.lodChunkExtent = absl::GetFlag(FLAGS_lod_chunk_extent);
 
@@ -154,6 +171,15 @@ int main(int argc, char** argv) {
     std::cout << "  --quiet                      Suppress non-error output\n";
     std::cout << "  --overwrite                  Overwrite output file if it exists\n";
     std::cout << "  --iterations <n>             Iterations for SOG SH compression (more=better). Default: 10\n";
+    std::cout << "  --batch-size <n>             Rows per k-means mini-batch; each iteration fits one batch and a\n";
+    std::cout << "                               final pass assigns every row (0 = full passes). Default: 0\n";
+    std::cout << "  --batch-sampling <mode>      Mini-batch row sampling: random | stratified. Default: random\n";
+    std::cout << "  --seed <n>                   Seed for k-means initialization and sampling; the same input and\n";
+    std::cout << "                               seed produce identical output on any CPU (--gpu runs may differ\n";
+    std::cout << "                               from CPU runs). Default: 0\n";
+    std::cout << "  --webp-preset <preset>       WebP encoder effort for SOG textures: fast | balanced | max. fast\n";
+    std::cout << "                               encodes several times faster for slightly larger files.\n";
+    std::cout << "                               Default: balanced\n";
     std::cout << "  --list-gpus                  List available GPU adapters and exit\n";
     std::cout << "  --gpu <n|cpu>                Select device for SOG compression: GPU adapter index | 'cpu'\n";
     std::cout << "  --viewer-settings <file>     HTML viewer settings JSON file\n";
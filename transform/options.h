@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -45,6 +46,16 @@ struct Options {
   int iterations;
   bool listGpus;
 
+  // k-means mini-batch options: 0 = full passes
+  int batchSize;
+  std::string batchSampling;
+
+  // k-means seed: identical input and seed give identical output
+  uint64_t seed;
+
+  // SOG texture encoder effort: fast | balanced | max
+  std::string webpPreset;
+
   // Device selection: -1 = auto, -2 = CPU, 0+ = GPU index
   int device;
 
@@ -72,6 +83,10 @@ struct Options {
     quiet = false;
     iterations = 1;
     listGpus = false;
+    batchSize = 0;
+    batchSampling = "random";
+    seed = 0;
+    webpPreset = "balanced";
     device = -1;  // -1 = auto
 
     // lcc input options defaults
@@ -27,6 +27,9 @@
 
 #include "process.h"
 
+#include <splat/models/data-table-view.h>
+#include <splat/models/gaussian.h>
+
 #include <algorithm>
 #include <cmath>
 #include <set>
@@ -34,22 +37,22 @@
 
 namespace splat {
 
-static std::unique_ptr<DataTable> filter(const DataTable* dataTable,
-                                         std::function<bool(const Row&, size_t)> predicate) {
-  std::vector<uint32_t> indices;
-  const size_t numRows = dataTable->getNumRows();
-  indices.reserve(numRows);
+static DataTableView filter(const DataTableView& dataView,
+                           std::function<bool(const ConstGaussianRef&, size_t)> predicate) {
+  std::vector<uint32_t> rows;
+  const size_t numRows = dataView.getNumRows();
+  rows.reserve(numRows);
 
-  size_t index = 0;
-  Row row;
-  for (size_t i = 0; i < dataTable->getNumRows(); i++) {
-    dataTable->getRow(i, row);
-    if (predicate && predicate(row, i)) {
-      indices.push_back(static_cast<uint32_t>(i));
+  ConstGaussianView view(dataView.base());
+  for (size_t i = 0; i < numRows; i++) {
+    if (predicate && predicate(view[dataView.baseRow(i)], i)) {
+      rows.push_back(static_cast<uint32_t>(i));
     }
   }
 
-  return dataTable->permuteRows(indices);
+  // successive filters compose row selections over the same base table; nothing is copied until the
+  // caller materializes the result
+  return dataView.select(rows);
 }
 
 std::unique_ptr<DataTable> processDataTable(DataTable* dataTable, const std::vector<ProcessAction>& processActions) {
@@ -20,6 +20,12 @@ std::string getOutputFormat(std::string filename) {
   } else if (absl::EndsWithIgnoreCase(filename, "meta.json")) {
     return "sog";
   }
+  if (absl::EndsWithIgnoreCase(filename, ".ksplat")) {
+    return "ksplat";
+  }
+  if (absl::EndsWithIgnoreCase(filename, ".spz")) {
+    return "spz";
+  }
   if (absl::EndsWithIgnoreCase(filename, ".compressed.ply")) {
     return "compressed-ply";
   }
@@ -46,21 +52,45 @@ void writeFile(const std::string& filename, DataTable* dataTable, DataTable* env
 
   std::string outputFormat = getOutputFormat(filename);
 
+  // -2 selects the CPU, -1 lets the library pick, any adapter index asks for the GPU
+  KMeansOptions kmeansOptions;
+  if (options.device == -2) {
+    kmeansOptions.device = KMeansDevice::CPU;
+  } else if (options.device >= 0) {
+    kmeansOptions.device = KMeansDevice::GPU;
+  }
+  kmeansOptions.batchSize = options.batchSize;
+  kmeansOptions.sampling =
+      options.batchSampling == "stratified" ? KMeansSampling::Stratified : KMeansSampling::Random;
+  kmeansOptions.seed = options.seed;
+
+  webpcodec::Preset webpPreset = webpcodec::Preset::Balanced;
+  if (options.webpPreset == "fast") {
+    webpPreset = webpcodec::Preset::Fast;
+  } else if (options.webpPreset == "max") {
+    webpPreset = webpcodec::Preset::Max;
+  }
+
   std::cout << "writing '" << filename << "'..." << "\n";
 
   try {
     if (outputFormat == "csv") {
       writeCSV(filename, dataTable);
     } else if (outputFormat == "sog" || outputFormat == "sog-bundle") {
-      writeSog(filename, dataTable, outputFormat == "sog-bundle", options.iterations);
+      writeSog(filename, dataTable, outputFormat == "sog-bundle", options.iterations, {}, kmeansOptions,
+               webpPreset);
     } else if (outputFormat == "lod") {
       if (!dataTable->hasColumn("lod")) {
-        dataTable->addColumn({"lod", std::vector<float>(dataTable->getNumRows())});
+        dataTable->addColumn({"lod", ColumnVector<float>(dataTable->getNumRows(), 0.0f)});
       }
       writeLod(filename, dataTable, envDataTable, options.lodBundle, options.iterations, options.lodChunkCount,
-               options.lodChunkExtent);
+               options.lodChunkExtent, kmeansOptions, webpPreset);
     } else if (outputFormat == "compressed-ply") {
       writeCompressedPly(filename, dataTable);
+    } else if (outputFormat == "ksplat") {
+      writeKsplat(filename, dataTable);
+    } else if (outputFormat == "spz") {
+      writeSpz(filename, dataTable);
     } else if (outputFormat == "ply") {
       PlyData ply;
       ply.elements.push_back({"vertex", dataTable->clone()});